@@ -50,6 +50,7 @@ namespace mu
   std::locale ParserBase::s_locale = std::locale(std::locale::classic(), new change_dec_sep<char_type>('.'));
 
   bool ParserBase::g_DbgDumpCmdCode = false;
+  bool ParserBase::g_UseTape = true;
   bool ParserBase::g_DbgDumpStack = false;
 
   //------------------------------------------------------------------------------
@@ -92,6 +93,7 @@ namespace mu
     ,m_nIfElseCounter(0)
     ,m_vStackBuffer()
     ,m_nFinalResultIdx(0)
+    ,m_nColumnwise(-1)
   {
     InitTokenReader();
   }
@@ -119,6 +121,7 @@ namespace mu
     ,m_sOprtChars()
     ,m_sInfixOprtChars()
     ,m_nIfElseCounter(0)
+    ,m_nColumnwise(-1)
   {
     m_pTokenReader.reset(new token_reader_type(this));
     Assign(a_Parser);
@@ -247,8 +250,10 @@ namespace mu
     m_pParseFormula = &ParserBase::ParseString;
     m_vStringBuf.clear();
     m_vRPN.clear();
+    m_vTape.clear();
     m_pTokenReader->ReInit();
     m_nIfElseCounter = 0;
+    m_nColumnwise = -1;
   }
 
   //---------------------------------------------------------------------------
@@ -1054,6 +1059,14 @@ namespace mu
     return ParseCmdCodeBulk(0, 0);
   }
 
+  //---------------------------------------------------------------------------
+  /** \brief Evaluate the register tape compiled from the RPN. */
+  value_type ParserBase::ParseTape() const
+  {
+    m_vTape.Eval(&m_vStackBuffer[0], p_data);
+    return m_vStackBuffer[m_nFinalResultIdx];
+  }
+
   //---------------------------------------------------------------------------
   /** \brief Evaluate the RPN. 
       \param nOffset The offset added to variable addresses (for bulk mode)
@@ -1238,6 +1251,141 @@ namespace mu
     return Stack[m_nFinalResultIdx];  
   }
 
+  //---------------------------------------------------------------------------
+  /** \brief Check whether the bytecode can be evaluated by ParseCmdCodeColumns.
+
+    Conditional branches, assignments, string and bulk functions as well as
+    functions of more than three fixed arguments require the per item evaluation.
+  */
+  bool ParserBase::IsColumnwiseCode() const
+  {
+    for (const SToken *pTok = m_vRPN.GetBase(); pTok->Cmd!=cmEND ; ++pTok)
+    {
+      switch (pTok->Cmd)
+      {
+      case cmIF: case cmELSE: case cmENDIF: case cmASSIGN:
+      case cmFUNC_STR: case cmFUNC_BULK:
+            return false;
+      case cmFUNC:
+            if (pTok->Fun.argc>3)
+              return false;
+            continue;
+      default:
+            continue;
+      }
+    }
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+  /** \brief Bulk evaluation that processes each bytecode token for all items at once.
+
+    The stack holds a column of nBulkSize values per entry, such that the token
+    dispatch is paid once per bulk and the arithmetic loops can be vectorized.
+    Yields the same results as calling ParseCmdCodeBulk for each item.
+  */
+  void ParserBase::ParseCmdCodeColumns(value_type *results, int nBulkSize) const
+  {
+    const int n = nBulkSize;
+    if (m_vColumnStack.size() < (m_vRPN.GetMaxStackSize()+2) * n)
+      m_vColumnStack.resize((m_vRPN.GetMaxStackSize()+2) * n);
+
+    value_type *Stack = &m_vColumnStack[0];
+    value_type *a, *b;
+    int sidx(0), i;
+    for (const SToken *pTok = m_vRPN.GetBase(); pTok->Cmd!=cmEND ; ++pTok)
+    {
+      a = Stack + sidx*n;
+      b = a - n;
+      switch (pTok->Cmd)
+      {
+      // built in binary operators
+      case  cmLE:   --sidx; for (i=0; i<n; ++i) b[i] = b[i] <= a[i]; continue;
+      case  cmGE:   --sidx; for (i=0; i<n; ++i) b[i] = b[i] >= a[i]; continue;
+      case  cmNEQ:  --sidx; for (i=0; i<n; ++i) b[i] = b[i] != a[i]; continue;
+      case  cmEQ:   --sidx; for (i=0; i<n; ++i) b[i] = b[i] == a[i]; continue;
+      case  cmLT:   --sidx; for (i=0; i<n; ++i) b[i] = b[i] < a[i];  continue;
+      case  cmGT:   --sidx; for (i=0; i<n; ++i) b[i] = b[i] > a[i];  continue;
+      case  cmADD:  --sidx; for (i=0; i<n; ++i) b[i] += a[i]; continue;
+      case  cmSUB:  --sidx; for (i=0; i<n; ++i) b[i] -= a[i]; continue;
+      case  cmMUL:  --sidx; for (i=0; i<n; ++i) b[i] *= a[i]; continue;
+      case  cmDIV:  --sidx;
+  #if defined(MUP_MATH_EXCEPTIONS)
+                  for (i=0; i<n; ++i)
+                    if (a[i]==0)
+                      Error(ecDIV_BY_ZERO);
+  #endif
+                  for (i=0; i<n; ++i) b[i] /= a[i];
+                  continue;
+
+      case  cmPOW:  --sidx; for (i=0; i<n; ++i) b[i] = MathImpl<value_type>::Pow(b[i], a[i]); continue;
+
+      case  cmLAND: --sidx; for (i=0; i<n; ++i) b[i] = b[i] && a[i]; continue;
+      case  cmLOR:  --sidx; for (i=0; i<n; ++i) b[i] = b[i] || a[i]; continue;
+
+      // value and variable tokens
+      case  cmVAR:    ++sidx; a += n; for (i=0; i<n; ++i) a[i] = pTok->Val.ptr[i]; continue;
+      case  cmVAL:    ++sidx; a += n; for (i=0; i<n; ++i) a[i] = pTok->Val.data2;  continue;
+      case  cmVARPOW2: ++sidx; a += n; for (i=0; i<n; ++i) a[i] = pTok->Val.ptr[i]*pTok->Val.ptr[i]; continue;
+      case  cmVARPOW3: ++sidx; a += n; for (i=0; i<n; ++i) a[i] = pTok->Val.ptr[i]*pTok->Val.ptr[i]*pTok->Val.ptr[i]; continue;
+      case  cmVARPOW4: ++sidx; a += n; for (i=0; i<n; ++i) a[i] = pTok->Val.ptr[i]*pTok->Val.ptr[i]*pTok->Val.ptr[i]*pTok->Val.ptr[i]; continue;
+      case  cmVARMUL:  ++sidx; a += n; for (i=0; i<n; ++i) a[i] = pTok->Val.ptr[i] * pTok->Val.data + pTok->Val.data2; continue;
+
+      // numeric functions are called per item on the argument columns
+      case  cmFUNC:
+            {
+              int iArgCount = pTok->Fun.argc;
+              switch(iArgCount)
+              {
+              case 0: ++sidx; a += n; for (i=0; i<n; ++i) a[i] = (*(fun_type0)pTok->Fun.ptr)(); continue;
+              case 1: for (i=0; i<n; ++i) a[i] = (*(fun_type1)pTok->Fun.ptr)(a[i]); continue;
+              case 2: --sidx; for (i=0; i<n; ++i) b[i] = (*(fun_type2)pTok->Fun.ptr)(b[i], a[i]); continue;
+              case 3: sidx -= 2; for (i=0; i<n; ++i) b[i-n] = (*(fun_type3)pTok->Fun.ptr)(b[i-n], b[i], a[i]); continue;
+              default:
+                if (iArgCount>0)
+                  Error(ecINTERNAL_ERROR, 1);
+
+                iArgCount = -iArgCount;
+                sidx -= iArgCount - 1;
+                m_vColumnArgs.resize(iArgCount);
+                a = Stack + sidx*n;
+                for (i=0; i<n; ++i)
+                {
+                  for (int j=0; j<iArgCount; ++j)
+                    m_vColumnArgs[j] = a[j*n + i];
+                  a[i] = (*(multfun_type)pTok->Fun.ptr)(&m_vColumnArgs[0], iArgCount);
+                }
+                continue;
+              }
+            }
+
+      // generic functions with private data
+      case  cmFUNC_VAR:
+            {
+              int iArgCount = pTok->Fun.argc;
+              sidx -= iArgCount - 1;
+              m_vColumnArgs.resize(std::max(iArgCount,1));
+              a = Stack + sidx*n;
+              for (i=0; i<n; ++i)
+              {
+                for (int j=0; j<iArgCount; ++j)
+                  m_vColumnArgs[j] = a[j*n + i];
+                a[i] = (*(fun_class_generic*)pTok->Fun.ptr)(&m_vColumnArgs[0], p_data);
+              }
+              continue;
+            }
+
+      default:
+            Error(ecINTERNAL_ERROR, 3);
+            return;
+      } // switch CmdCode
+    } // for all bytecode tokens
+
+    const value_type *pResult = Stack + m_nFinalResultIdx*n;
+    for (i=0; i<n; ++i)
+      results[i] = pResult[i];
+  }
+
   //---------------------------------------------------------------------------
   void ParserBase::CreateRPN() const
   {
@@ -1471,6 +1619,10 @@ namespace mu
       Error(ecSTR_RESULT);
 
     m_vStackBuffer.resize(m_vRPN.GetMaxStackSize() * s_MaxNumOpenMPThreads);
+
+    // The bytecode interpreter remains the fallback for code not supported by the tape
+    if (g_UseTape && m_vTape.Compile(m_vRPN))
+      m_vStackBuffer.resize(std::max(m_vStackBuffer.size(), (std::size_t)m_vTape.GetNumRegisters() * s_MaxNumOpenMPThreads));
   }
 
   //---------------------------------------------------------------------------
@@ -1487,7 +1639,7 @@ namespace mu
     try
     {
       CreateRPN();
-      m_pParseFormula = &ParserBase::ParseCmdCode;
+      m_pParseFormula = m_vTape.IsEmpty() ? &ParserBase::ParseCmdCode : &ParserBase::ParseTape;
       return (this->*m_pParseFormula)(); 
     }
     catch(ParserError &exc)
@@ -1623,6 +1775,17 @@ namespace mu
     ParserBase::g_DbgDumpStack   = bDumpStack;
   }
 
+  //------------------------------------------------------------------------------
+  /** \brief Enable or disable the compilation of the bytecode to a register tape.
+
+     Affects expressions parsed after the call. The tape yields the same results
+     as the bytecode interpreter, which is used if the tape is disabled.
+  */
+  void ParserBase::EnableTape(bool bIsOn)
+  {
+    ParserBase::g_UseTape = bIsOn;
+  }
+
   //------------------------------------------------------------------------------
   /** \brief Enable or disable the built in binary operators.
       \throw nothrow
@@ -1790,7 +1953,14 @@ namespace mu
   void ParserBase::Eval(value_type *results, int nBulkSize, void* p_fun_data)
   {
 	p_data = p_fun_data;
-    CreateRPN();
+    // Reuse the bytecode of earlier evaluations, it is reset by any change of the definitions
+    if (m_pParseFormula == &ParserBase::ParseString)
+    {
+      CreateRPN();
+      m_pParseFormula = m_vTape.IsEmpty() ? &ParserBase::ParseCmdCode : &ParserBase::ParseTape;
+    }
+    if (m_nColumnwise<0)
+      m_nColumnwise = IsColumnwiseCode();
 
     int i = 0;
 
@@ -1835,6 +2005,12 @@ namespace mu
 #endif
 
 #else
+    if (m_nColumnwise)
+    {
+      ParseCmdCodeColumns(results, nBulkSize);
+      return;
+    }
+
     for (i=0; i<nBulkSize; ++i)
     {
       results[i] = ParseCmdCodeBulk(i, 0);
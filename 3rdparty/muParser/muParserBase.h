@@ -38,6 +38,7 @@
 #include "muParserStack.h"
 #include "muParserTokenReader.h"
 #include "muParserBytecode.h"
+#include "muParserTape.h"
 #include "muParserError.h"
 
 
@@ -96,6 +97,7 @@ private:
     typedef ParserError exception_type;
 
     static void EnableDebugDump(bool bDumpCmd, bool bDumpStack);
+    static void EnableTape(bool bIsOn);
 
     ParserBase(); 
     ParserBase(const ParserBase &a_Parser);
@@ -199,6 +201,7 @@ private:
     static std::locale s_locale;  ///< The locale used by the parser
     static bool g_DbgDumpCmdCode;
     static bool g_DbgDumpStack;
+    static bool g_UseTape;
 
     /** \brief A facet class used to change decimal and thousands separator. */
     template<class TChar>
@@ -274,7 +277,10 @@ private:
 
     value_type ParseString() const; 
     value_type ParseCmdCode() const;
+    value_type ParseTape() const;
     value_type ParseCmdCodeBulk(int nOffset, int nThreadID) const;
+    bool IsColumnwiseCode() const;
+    void ParseCmdCodeColumns(value_type *results, int nBulkSize) const;
 
     void  CheckName(const string_type &a_strName, const string_type &a_CharSet) const;
     void  CheckOprt(const string_type &a_sName,
@@ -290,6 +296,7 @@ private:
     */
     mutable ParseFunction  m_pParseFormula;
     mutable ParserByteCode m_vRPN;        ///< The Bytecode class.
+    mutable ParserTape m_vTape;           ///< Register tape compiled from the bytecode, empty if not supported
     mutable stringbuf_type  m_vStringBuf; ///< String buffer, used for storing string function arguments
     mutable void* p_data;
     stringbuf_type  m_vStringVarBuf;
@@ -315,6 +322,9 @@ private:
     // items merely used for caching state information
     mutable valbuf_type m_vStackBuffer; ///< This is merely a buffer used for the stack in the cmd parsing routine
     mutable int m_nFinalResultIdx;
+    mutable int m_nColumnwise;          ///< Whether the bytecode can be evaluated token by token over a whole bulk, -1 if not yet checked
+    mutable valbuf_type m_vColumnStack; ///< Stack of value columns for the column-wise bulk evaluation
+    mutable valbuf_type m_vColumnArgs;  ///< Gathered arguments of a function call in column-wise bulk evaluation
 };
 
 } // namespace mu
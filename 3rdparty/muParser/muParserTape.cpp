@@ -0,0 +1,304 @@
+/*
+                 __________
+    _____   __ __\______   \_____  _______  ______  ____ _______
+   /     \ |  |  \|     ___/\__  \ \_  __ \/  ___/_/ __ \\_  __ \
+  |  Y Y  \|  |  /|    |     / __ \_|  | \/\___ \ \  ___/ |  | \/
+  |__|_|  /|____/ |____|    (____  /|__|  /____  > \___  >|__|
+        \/                       \/            \/      \/
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this
+  software and associated documentation files (the "Software"), to deal in the Software
+  without restriction, including without limitation the rights to use, copy, modify,
+  merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or
+  substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+  NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "muParserTape.h"
+
+#include <algorithm>
+
+#include "muParserError.h"
+#include "muParserTemplateMagic.h"
+
+
+namespace mu
+{
+  //---------------------------------------------------------------------------
+  ParserTape::ParserTape()
+    :m_vTape()
+    ,m_nRegisters(0)
+  {}
+
+  //---------------------------------------------------------------------------
+  void ParserTape::clear()
+  {
+    m_vTape.clear();
+    m_nRegisters = 0;
+  }
+
+  //---------------------------------------------------------------------------
+  void ParserTape::AddOp(ETapeCode a_Code, int a_iDst)
+  {
+    STapeOp op;
+    op.Code = a_Code;
+    op.Dst = a_iDst;
+    op.Arg = 0;
+    op.Ptr = 0;
+    op.Val = 0;
+    op.Val2 = 0;
+    op.Fun = 0;
+    m_vTape.push_back(op);
+    m_nRegisters = std::max(m_nRegisters, a_iDst+2);
+  }
+
+  //---------------------------------------------------------------------------
+  bool ParserTape::Compile(const ParserByteCode &a_ByteCode)
+  {
+    clear();
+
+    const SToken *pBase = a_ByteCode.GetBase();
+    int nTok = 0;
+    while (pBase[nTok].Cmd!=cmEND)
+      ++nTok;
+
+    std::vector<int> vPos(nTok+1);   // tape position of each bytecode token
+    std::vector<int> vBranch;        // stack position at the begin of an if-then-else branch
+    int sidx(0);
+
+    for (int i=0; i<nTok; ++i)
+    {
+      const SToken &tok = pBase[i];
+      vPos[i] = (int)m_vTape.size();
+
+      switch (tok.Cmd)
+      {
+      case cmVAR:
+      case cmVAL:
+            {
+              // Fuse the operand into the consuming binary operator or unary function
+              const SToken &next = pBase[i+1];
+              bool bVar = tok.Cmd==cmVAR;
+              int iFused = -1;
+              switch (next.Cmd)
+              {
+              case cmADD: iFused = bVar ? tcADD_V : tcADD_C; break;
+              case cmSUB: iFused = bVar ? tcSUB_V : tcSUB_C; break;
+              case cmMUL: iFused = bVar ? tcMUL_V : tcMUL_C; break;
+              case cmDIV: iFused = bVar ? tcDIV_V : tcDIV_C; break;
+              case cmPOW: iFused = bVar ? tcPOW_V : tcPOW_C; break;
+              case cmFUNC:
+                    if (bVar && next.Fun.argc==1)
+                      iFused = tcFUNC1_V;
+                    break;
+              default: break;
+              }
+
+              if (iFused==tcFUNC1_V)
+              {
+                AddOp(tcFUNC1_V, ++sidx);
+                m_vTape.back().Fun = next.Fun.ptr;
+              }
+              else if (iFused>=0)
+              {
+                AddOp((ETapeCode)iFused, sidx);
+              }
+              else
+              {
+                AddOp(bVar ? tcVAR : tcVAL, ++sidx);
+              }
+              m_vTape.back().Ptr = tok.Val.ptr;
+              m_vTape.back().Val = tok.Val.data2;
+
+              if (iFused>=0)
+              {
+                ++i;
+                vPos[i] = vPos[i-1];
+              }
+              continue;
+            }
+
+      case cmVARPOW2: AddOp(tcVARPOW2, ++sidx); m_vTape.back().Ptr = tok.Val.ptr; continue;
+      case cmVARPOW3: AddOp(tcVARPOW3, ++sidx); m_vTape.back().Ptr = tok.Val.ptr; continue;
+      case cmVARPOW4: AddOp(tcVARPOW4, ++sidx); m_vTape.back().Ptr = tok.Val.ptr; continue;
+      case cmVARMUL:
+            AddOp(tcVARMUL, ++sidx);
+            m_vTape.back().Ptr = tok.Val.ptr;
+            m_vTape.back().Val = tok.Val.data;
+            m_vTape.back().Val2 = tok.Val.data2;
+            continue;
+
+      case cmADD:  AddOp(tcADD,  --sidx); continue;
+      case cmSUB:  AddOp(tcSUB,  --sidx); continue;
+      case cmMUL:  AddOp(tcMUL,  --sidx); continue;
+      case cmDIV:  AddOp(tcDIV,  --sidx); continue;
+      case cmPOW:  AddOp(tcPOW,  --sidx); continue;
+      case cmLE:   AddOp(tcLE,   --sidx); continue;
+      case cmGE:   AddOp(tcGE,   --sidx); continue;
+      case cmNEQ:  AddOp(tcNEQ,  --sidx); continue;
+      case cmEQ:   AddOp(tcEQ,   --sidx); continue;
+      case cmLT:   AddOp(tcLT,   --sidx); continue;
+      case cmGT:   AddOp(tcGT,   --sidx); continue;
+      case cmLAND: AddOp(tcLAND, --sidx); continue;
+      case cmLOR:  AddOp(tcLOR,  --sidx); continue;
+
+      case cmASSIGN:
+            AddOp(tcASSIGN, --sidx);
+            m_vTape.back().Ptr = tok.Oprt.ptr;
+            continue;
+
+      case cmFUNC:
+            {
+              int iArgc = tok.Fun.argc;
+              switch (iArgc)
+              {
+              case 0:  AddOp(tcFUNC0, ++sidx); break;
+              case 1:  AddOp(tcFUNC1, sidx); break;
+              case 2:  sidx -= 1; AddOp(tcFUNC2, sidx); break;
+              case 3:  sidx -= 2; AddOp(tcFUNC3, sidx); break;
+              default:
+                if (iArgc>0)
+                {
+                  sidx -= iArgc-1;
+                  AddOp(tcFUNCN, sidx);
+                }
+                else
+                {
+                  // functions with variable arguments store the number as a negative value
+                  iArgc = -iArgc;
+                  sidx -= iArgc-1;
+                  AddOp(tcFUNC_MULTI, sidx);
+                }
+              }
+              m_vTape.back().Arg = iArgc;
+              m_vTape.back().Fun = tok.Fun.ptr;
+              continue;
+            }
+
+      case cmFUNC_VAR:
+            sidx -= tok.Fun.argc-1;
+            AddOp(tcFUNC_VAR, sidx);
+            m_vTape.back().Arg = tok.Fun.argc;
+            m_vTape.back().Fun = tok.Fun.ptr;
+            continue;
+
+      // Jump targets are bytecode positions, resolved to tape positions below
+      case cmIF:
+            AddOp(tcIF, sidx--);
+            m_vTape.back().Arg = i + tok.Oprt.offset + 1;
+            vBranch.push_back(sidx);
+            continue;
+
+      case cmELSE:
+            AddOp(tcJMP, sidx);
+            m_vTape.back().Arg = i + tok.Oprt.offset + 1;
+            sidx = vBranch.back();
+            continue;
+
+      case cmENDIF:
+            sidx = vBranch.back() + 1;
+            vBranch.pop_back();
+            continue;
+
+      // string and bulk functions are left to the bytecode interpreter
+      default:
+            clear();
+            return false;
+      }
+    }
+
+    vPos[nTok] = (int)m_vTape.size();
+    AddOp(tcEND, 0);
+
+    for (std::size_t i=0; i<m_vTape.size(); ++i)
+    {
+      if (m_vTape[i].Code==tcIF || m_vTape[i].Code==tcJMP)
+        m_vTape[i].Arg = vPos[m_vTape[i].Arg];
+    }
+    return true;
+  }
+
+  //---------------------------------------------------------------------------
+  void ParserTape::Eval(value_type *Reg, void *p_data) const
+  {
+    const STapeOp *pBase = &m_vTape[0];
+    for (const STapeOp *pOp = pBase; ; ++pOp)
+    {
+      value_type *r = Reg + pOp->Dst;
+      switch (pOp->Code)
+      {
+      case tcVAR:      *r = *pOp->Ptr; continue;
+      case tcVAL:      *r = pOp->Val;  continue;
+      case tcVARPOW2:  *r = *pOp->Ptr * *pOp->Ptr; continue;
+      case tcVARPOW3:  *r = *pOp->Ptr * *pOp->Ptr * *pOp->Ptr; continue;
+      case tcVARPOW4:  *r = *pOp->Ptr * *pOp->Ptr * *pOp->Ptr * *pOp->Ptr; continue;
+      case tcVARMUL:   *r = *pOp->Ptr * pOp->Val + pOp->Val2; continue;
+
+      case tcADD:      *r += r[1]; continue;
+      case tcSUB:      *r -= r[1]; continue;
+      case tcMUL:      *r *= r[1]; continue;
+      case tcPOW:      *r = MathImpl<value_type>::Pow(*r, r[1]); continue;
+      case tcADD_V:    *r += *pOp->Ptr; continue;
+      case tcSUB_V:    *r -= *pOp->Ptr; continue;
+      case tcMUL_V:    *r *= *pOp->Ptr; continue;
+      case tcPOW_V:    *r = MathImpl<value_type>::Pow(*r, *pOp->Ptr); continue;
+      case tcADD_C:    *r += pOp->Val; continue;
+      case tcSUB_C:    *r -= pOp->Val; continue;
+      case tcMUL_C:    *r *= pOp->Val; continue;
+      case tcPOW_C:    *r = MathImpl<value_type>::Pow(*r, pOp->Val); continue;
+
+  #if defined(MUP_MATH_EXCEPTIONS)
+      case tcDIV:      if (r[1]==0) throw ParserError(ecDIV_BY_ZERO); *r /= r[1]; continue;
+      case tcDIV_V:    if (*pOp->Ptr==0) throw ParserError(ecDIV_BY_ZERO); *r /= *pOp->Ptr; continue;
+      case tcDIV_C:    if (pOp->Val==0) throw ParserError(ecDIV_BY_ZERO); *r /= pOp->Val; continue;
+  #else
+      case tcDIV:      *r /= r[1]; continue;
+      case tcDIV_V:    *r /= *pOp->Ptr; continue;
+      case tcDIV_C:    *r /= pOp->Val; continue;
+  #endif
+
+      case tcLE:       *r = *r <= r[1]; continue;
+      case tcGE:       *r = *r >= r[1]; continue;
+      case tcNEQ:      *r = *r != r[1]; continue;
+      case tcEQ:       *r = *r == r[1]; continue;
+      case tcLT:       *r = *r <  r[1]; continue;
+      case tcGT:       *r = *r >  r[1]; continue;
+      case tcLAND:     *r = *r && r[1]; continue;
+      case tcLOR:      *r = *r || r[1]; continue;
+
+      case tcFUNC0:    *r = (*(fun_type0)pOp->Fun)(); continue;
+      case tcFUNC1:    *r = (*(fun_type1)pOp->Fun)(*r); continue;
+      case tcFUNC1_V:  *r = (*(fun_type1)pOp->Fun)(*pOp->Ptr); continue;
+      case tcFUNC2:    *r = (*(fun_type2)pOp->Fun)(r[0], r[1]); continue;
+      case tcFUNC3:    *r = (*(fun_type3)pOp->Fun)(r[0], r[1], r[2]); continue;
+      case tcFUNCN:
+            switch (pOp->Arg)
+            {
+            case 4:  *r = (*(fun_type4)pOp->Fun)(r[0], r[1], r[2], r[3]); continue;
+            case 5:  *r = (*(fun_type5)pOp->Fun)(r[0], r[1], r[2], r[3], r[4]); continue;
+            case 6:  *r = (*(fun_type6)pOp->Fun)(r[0], r[1], r[2], r[3], r[4], r[5]); continue;
+            case 7:  *r = (*(fun_type7)pOp->Fun)(r[0], r[1], r[2], r[3], r[4], r[5], r[6]); continue;
+            case 8:  *r = (*(fun_type8)pOp->Fun)(r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7]); continue;
+            case 9:  *r = (*(fun_type9)pOp->Fun)(r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7], r[8]); continue;
+            case 10: *r = (*(fun_type10)pOp->Fun)(r[0], r[1], r[2], r[3], r[4], r[5], r[6], r[7], r[8], r[9]); continue;
+            default: throw ParserError(ecINTERNAL_ERROR);
+            }
+      case tcFUNC_MULTI: *r = (*(multfun_type)pOp->Fun)(r, pOp->Arg); continue;
+      case tcFUNC_VAR:   *r = (*(fun_class_generic*)pOp->Fun)(r, p_data); continue;
+
+      case tcASSIGN:   *r = *pOp->Ptr = r[1]; continue;
+      case tcIF:       if (*r==0) pOp = pBase + pOp->Arg - 1; continue;
+      case tcJMP:      pOp = pBase + pOp->Arg - 1; continue;
+      case tcEND:      return;
+      }
+    }
+  }
+} // namespace mu
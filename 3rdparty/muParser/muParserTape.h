@@ -0,0 +1,100 @@
+/*
+                 __________
+    _____   __ __\______   \_____  _______  ______  ____ _______
+   /     \ |  |  \|     ___/\__  \ \_  __ \/  ___/_/ __ \\_  __ \
+  |  Y Y  \|  |  /|    |     / __ \_|  | \/\___ \ \  ___/ |  | \/
+  |__|_|  /|____/ |____|    (____  /|__|  /____  > \___  >|__|
+        \/                       \/            \/      \/
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy of this
+  software and associated documentation files (the "Software"), to deal in the Software
+  without restriction, including without limitation the rights to use, copy, modify,
+  merge, publish, distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all copies or
+  substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+  NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+  DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef MU_PARSER_TAPE_H
+#define MU_PARSER_TAPE_H
+
+#include <vector>
+
+#include "muParserDef.h"
+#include "muParserBytecode.h"
+
+/** \file
+    \brief Definition of the register tape the bytecode is compiled to.
+*/
+
+namespace mu
+{
+  /** \brief Operation codes of the register tape.
+
+    Suffix _V denotes a variable operand, _C a constant operand and
+    no suffix a register operand.
+  */
+  enum ETapeCode
+  {
+    tcVAR, tcVAL, tcVARPOW2, tcVARPOW3, tcVARPOW4, tcVARMUL,
+    tcADD, tcSUB, tcMUL, tcDIV, tcPOW,
+    tcADD_V, tcSUB_V, tcMUL_V, tcDIV_V, tcPOW_V,
+    tcADD_C, tcSUB_C, tcMUL_C, tcDIV_C, tcPOW_C,
+    tcLE, tcGE, tcNEQ, tcEQ, tcLT, tcGT, tcLAND, tcLOR,
+    tcFUNC0, tcFUNC1, tcFUNC1_V, tcFUNC2, tcFUNC3, tcFUNCN, tcFUNC_MULTI, tcFUNC_VAR,
+    tcASSIGN, tcIF, tcJMP,
+    tcEND
+  };
+
+  /** \brief Instruction of the register tape. */
+  struct STapeOp
+  {
+    ETapeCode Code;
+    int Dst;                ///< Target register, also the first operand register
+    int Arg;                ///< Argument count of functions or tape position of jumps
+    value_type *Ptr;        ///< Variable operand
+    value_type Val;         ///< Constant operand
+    value_type Val2;        ///< Constant offset of tcVARMUL
+    generic_fun_type Fun;   ///< Function pointer, fun_class_generic* for tcFUNC_VAR
+  };
+
+  /** \brief Register tape compiled from the parser bytecode.
+
+    The stack positions of the bytecode are mapped to a fixed register file, such
+    that no stack pointer must be maintained at runtime. Variable and constant
+    operands of binary operators and unary functions are fused into the consuming
+    instruction, if-then-else branches are resolved to absolute jumps.
+    The result registers are identical to the stack positions of the bytecode.
+  */
+  class ParserTape
+  {
+  public:
+    ParserTape();
+
+    /** \brief Compile the tape from bytecode @p a_ByteCode.
+        \return false if the bytecode contains string or bulk functions, which are not supported.
+    */
+    bool Compile(const ParserByteCode &a_ByteCode);
+    void clear();
+    bool IsEmpty() const { return m_vTape.empty(); }
+    /** \brief Number of registers required for evaluation. */
+    int GetNumRegisters() const { return m_nRegisters; }
+
+    /** \brief Evaluate the tape on register file @p Reg, passing @p p_data to generic functions. */
+    void Eval(value_type *Reg, void *p_data) const;
+
+  private:
+    void AddOp(ETapeCode a_Code, int a_iDst);
+    std::vector<STapeOp> m_vTape;
+    int m_nRegisters;
+  };
+
+} // namespace mu
+
+#endif
@@ -0,0 +1,326 @@
+#include "async_output.h"
+#include <fstream>
+#include <iostream>
+#include <deque>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <future>
+#include <chrono>
+#include <set>
+#include <csignal>
+#include <cstdlib>
+#include <sys/resource.h>
+
+using namespace std;
+
+struct AsyncOutputFile::Handle {
+	string filename;
+	bool append = false;
+	ofstream stream;
+	bool is_open = false;
+	bool dirty = false;
+	list<Handle*>::iterator lru_pos;
+};
+
+namespace {
+
+const size_t chunk_initial_size = 1<<12;
+const size_t chunk_max_size = 1<<20;
+const size_t max_open_files_cap = 1024;
+const size_t max_queued_chunks = 256;
+
+struct Job {
+	shared_ptr<AsyncOutputFile::Handle> handle;
+	vector<char> data;
+	bool close;
+	/// Flush the file and fulfil the promise once all preceding jobs are processed
+	shared_ptr<promise<void>> flushed;
+};
+
+/// The I/O thread serving all AsyncOutputFiles
+class IOThread {
+public:
+	using Handle = AsyncOutputFile::Handle;
+	static IOThread& instance();
+	/// Queue @p job, blocks while the queue is full
+	void push(Job job);
+	/// Wait until all queued jobs are processed and the files are flushed
+	void sync();
+	/// Process all pending jobs and terminate the thread
+	void shutdown();
+	bool idle() const { return is_idle; }
+
+private:
+	IOThread();
+	void run();
+	void process(Job& job);
+	void open(Handle& h);
+	void close(Handle& h);
+	void flushAll();
+
+	thread worker;
+	mutex queue_mutex;
+	condition_variable cv_jobs, cv_space, cv_idle;
+	deque<Job> queue;
+	bool busy = false;
+	bool stopped = false;
+	bool joined = false;
+	atomic<bool> is_idle;
+	/// Leave the larger part of the file descriptors to the rest of the program
+	size_t max_open_files = 64;
+	/// Open files, most recently used first. Only touched by the I/O thread, or by the caller once the thread is stopped.
+	list<Handle*> open_files;
+};
+
+IOThread* io_thread = nullptr;
+
+/// All living AsyncOutputFiles, such that sync() can submit their buffers
+mutex files_mutex;
+set<AsyncOutputFile*> files;
+
+void shutdownIOThread() {
+	io_thread->shutdown();
+}
+
+/// Give the I/O thread the chance to write pending data before the default signal handler terminates the process
+void fatalSignalHandler(int sig) {
+	for (int i=0; i<200 && !io_thread->idle(); i++)
+		this_thread::sleep_for(chrono::milliseconds(10));
+	signal(sig, SIG_DFL);
+	raise(sig);
+}
+
+IOThread& IOThread::instance() {
+	static IOThread* instance = [] () {
+		// Intentionally never deleted, files may still be closed during static destruction
+		io_thread = new IOThread();
+		atexit(shutdownIOThread);
+		vector<int> signals = { SIGINT, SIGTERM, SIGABRT, SIGSEGV, SIGFPE, SIGILL };
+#ifdef SIGBUS
+		signals.push_back(SIGBUS);
+#endif
+		for (int sig : signals) {
+			// Do not override handlers installed by others
+			auto previous = signal(sig, fatalSignalHandler);
+			if (previous != SIG_DFL)
+				signal(sig, previous);
+		}
+		return io_thread;
+	}();
+	return *instance;
+}
+
+IOThread::IOThread() : is_idle(true) {
+	struct rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+		max_open_files = max(max_open_files, min<size_t>(limit.rlim_cur / 2, max_open_files_cap));
+	else
+		max_open_files = max_open_files_cap;
+	worker = thread(&IOThread::run, this);
+}
+
+void IOThread::push(Job job) {
+	unique_lock<mutex> lock(queue_mutex);
+	cv_space.wait(lock, [this] () { return queue.size() < max_queued_chunks || stopped; });
+	if (stopped) {
+		// Write synchronously once the thread is gone
+		cv_idle.wait(lock, [this] () { return joined; });
+		process(job);
+		return;
+	}
+	is_idle = false;
+	queue.push_back(std::move(job));
+	cv_jobs.notify_one();
+}
+
+void IOThread::sync() {
+	unique_lock<mutex> lock(queue_mutex);
+	cv_idle.wait(lock, [this] () { return stopped || (queue.empty() && !busy); });
+}
+
+void IOThread::shutdown() {
+	{
+		lock_guard<mutex> lock(queue_mutex);
+		if (stopped) return;
+		stopped = true;
+	}
+	cv_jobs.notify_all();
+	cv_space.notify_all();
+	worker.join();
+	{
+		lock_guard<mutex> lock(queue_mutex);
+		joined = true;
+	}
+	cv_idle.notify_all();
+}
+
+void IOThread::run() {
+	unique_lock<mutex> lock(queue_mutex);
+	while (true) {
+		cv_jobs.wait(lock, [this] () { return stopped || ! queue.empty(); });
+		if (queue.empty())
+			break;
+		Job job = std::move(queue.front());
+		queue.pop_front();
+		busy = true;
+		cv_space.notify_one();
+		lock.unlock();
+
+		process(job);
+		job.handle.reset();
+
+		lock.lock();
+		if (queue.empty()) {
+			// Get the data to disk as soon as the simulation does not provide more
+			lock.unlock();
+			flushAll();
+			lock.lock();
+			if (queue.empty()) {
+				busy = false;
+				is_idle = true;
+				cv_idle.notify_all();
+			}
+		}
+	}
+	while ( ! open_files.empty())
+		close(*open_files.front());
+	busy = false;
+	is_idle = true;
+}
+
+void IOThread::process(Job& job) {
+	auto& h = *job.handle;
+	if (job.close) {
+		if (h.is_open) close(h);
+		return;
+	}
+	if (job.flushed) {
+		if (h.is_open && h.dirty) {
+			h.stream.flush();
+			h.dirty = false;
+		}
+		job.flushed->set_value();
+		return;
+	}
+	if (h.is_open) {
+		open_files.splice(open_files.begin(), open_files, h.lru_pos);
+	}
+	else {
+		open(h);
+	}
+	h.stream.write(job.data.data(), job.data.size());
+	h.dirty = true;
+}
+
+void IOThread::open(Handle& h) {
+	if (open_files.size() >= max_open_files)
+		close(*open_files.back());
+
+	h.stream.open(h.filename, h.append ? (ofstream::out | ofstream::app) : (ofstream::out | ofstream::trunc));
+	if (!h.stream.is_open())
+		cerr << "AsyncOutputFile: Unable to open file " << h.filename << endl;
+	// Once written, reopening appends to the file
+	h.append = true;
+	h.is_open = true;
+	h.lru_pos = open_files.insert(open_files.begin(), &h);
+}
+
+void IOThread::close(Handle& h) {
+	h.stream.close();
+	h.stream.clear();
+	h.is_open = false;
+	h.dirty = false;
+	open_files.erase(h.lru_pos);
+}
+
+void IOThread::flushAll() {
+	for (auto h : open_files) {
+		if (h->dirty) {
+			h->stream.flush();
+			h->dirty = false;
+		}
+	}
+}
+
+}
+
+
+AsyncOutputFile::AsyncOutputFile(const string& filename, Mode mode) :
+	std::ostream(nullptr), file_name(filename), handle(make_shared<Handle>()), buffer(handle)
+{
+	handle->filename = filename;
+	handle->append = (mode == Mode::APPEND);
+	rdbuf(&buffer);
+	{
+		lock_guard<mutex> lock(files_mutex);
+		files.insert(this);
+	}
+	// Create the file right away, even if no data is written
+	IOThread::instance().push({handle, {}, false});
+}
+
+AsyncOutputFile::~AsyncOutputFile()
+{
+	{
+		lock_guard<mutex> lock(files_mutex);
+		files.erase(this);
+	}
+	buffer.submit();
+	IOThread::instance().push({handle, {}, true});
+}
+
+void AsyncOutputFile::sync()
+{
+	{
+		lock_guard<mutex> lock(files_mutex);
+		for (auto file : files)
+			file->buffer.submit();
+	}
+	IOThread::instance().sync();
+}
+
+void AsyncOutputFile::sync(const vector<AsyncOutputFile*>& files)
+{
+	vector<future<void>> flushed;
+	for (auto file : files) {
+		file->buffer.submit();
+		auto done = make_shared<promise<void>>();
+		flushed.push_back(done->get_future());
+		IOThread::instance().push({file->handle, {}, false, done});
+	}
+	for (auto& f : flushed)
+		f.wait();
+}
+
+void AsyncOutputFile::Buffer::submit()
+{
+	size_t used = pptr() - pbase();
+	if (used == 0) return;
+	chunk.resize(used);
+	IOThread::instance().push({handle, std::move(chunk), false});
+	chunk = vector<char>();
+	setp(nullptr, nullptr);
+}
+
+AsyncOutputFile::Buffer::int_type AsyncOutputFile::Buffer::overflow(int_type c)
+{
+	if (pptr() == epptr()) {
+		size_t used = pptr() - pbase();
+		if (used >= chunk_max_size) {
+			submit();
+			used = 0;
+		}
+		// Grow the chunk geometrically up to chunk_max_size
+		chunk.resize(max(chunk_initial_size, 2 * used));
+		setp(chunk.data(), chunk.data() + chunk.size());
+		pbump(used);
+	}
+	if ( ! traits_type::eq_int_type(c, traits_type::eof())) {
+		*pptr() = traits_type::to_char_type(c);
+		pbump(1);
+	}
+	return traits_type::not_eof(c);
+}
@@ -0,0 +1,66 @@
+//////
+//
+// This file is part of the modelling and simulation framework 'Morpheus',
+// and is made available under the terms of the BSD 3-clause license (see LICENSE
+// file that comes with the distribution or https://opensource.org/licenses/BSD-3-Clause).
+//
+// Authors:  Joern Starruss and Walter de Back
+// Copyright 2009-2016, Technische Universität Dresden, Germany
+//
+//////
+
+#ifndef ASYNC_OUTPUT_H
+#define ASYNC_OUTPUT_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <memory>
+
+/** @brief Output file stream that is written by a background I/O thread
+ *
+ *  Formatted data is collected in memory and handed to a single, process-wide I/O thread through a bounded queue
+ *  whenever the stream is flushed or the buffer exceeds its capacity. Thus, the simulation thread never blocks on
+ *  file system calls unless the queue is full. The I/O thread keeps the files open, a limited number
+ *  of least recently used files are reopened in append mode on demand.
+ *
+ *  Use sync() to wait until all pending data is on disk, e.g. before an external tool reads the files.
+ *  Submitted data is also written when the program exits or receives a fatal signal.
+ */
+class AsyncOutputFile : public std::ostream {
+public:
+	enum class Mode { TRUNCATE, APPEND };
+
+	explicit AsyncOutputFile(const std::string& filename, Mode mode = Mode::TRUNCATE);
+	/// Hands remaining data to the I/O thread and closes the file thereafter
+	~AsyncOutputFile();
+	const std::string& filename() const { return file_name; }
+
+	/// Submit the buffered data of all files and wait until it has been written. Must not run concurrently to writing the streams.
+	static void sync();
+	/// Submit the buffered data of @p files and wait until it has been written. Other files may be written concurrently.
+	static void sync(const std::vector<AsyncOutputFile*>& files);
+
+	struct Handle;
+
+private:
+	/// Stream buffer collecting the data of a single chunk
+	class Buffer : public std::streambuf {
+	public:
+		Buffer(std::shared_ptr<Handle> handle) : handle(handle) {};
+		/// Submit the current chunk to the I/O thread
+		void submit();
+	protected:
+		int_type overflow(int_type c) override;
+		int sync() override { submit(); return 0; }
+	private:
+		std::shared_ptr<Handle> handle;
+		std::vector<char> chunk;
+	};
+
+	std::string file_name;
+	std::shared_ptr<Handle> handle;
+	Buffer buffer;
+};
+
+#endif // ASYNC_OUTPUT_H
@@ -0,0 +1,65 @@
+//////
+//
+// This file is part of the modelling and simulation framework 'Morpheus',
+// and is made available under the terms of the BSD 3-clause license (see LICENSE
+// file that comes with the distribution or https://opensource.org/licenses/BSD-3-Clause).
+//
+// Authors:  Joern Starruss and Walter de Back
+// Copyright 2009-2016, Technische Universität Dresden, Germany
+//
+//////
+
+#ifndef BOLTZMANN_ACCEPTANCE_H
+#define BOLTZMANN_ACCEPTANCE_H
+
+#include <cmath>
+#include <vector>
+
+/** @brief Boltzmann acceptance probability of the Metropolis kinetics.
+ *
+ *  Energy differences of most CPM models are integral, e.g. for integral interaction energies
+ *  and volume / surface constraints with integral targets. For those, the probability exp(-dE/T) is
+ *  looked up from a table that is rebuilt whenever the temperature changes. All other energy differences
+ *  are evaluated directly. Both yield the very same values.
+ */
+class BoltzmannAcceptance {
+public:
+	static const unsigned int table_size = 256;
+
+	BoltzmannAcceptance() : temperature(NAN) {};
+
+	void setTemperature(double T) {
+		if (T == temperature)
+			return;
+		temperature = T;
+		table.resize(table_size);
+		for (unsigned int i=0; i<table_size; i++) {
+			table[i] = exp(-double(i) / temperature);
+		}
+	}
+
+	double temperatureValue() const { return temperature; }
+
+	/// Boltzmann probability to accept an energy change of @p dE > 0
+	double probability(double dE) const {
+		if (dE < table_size) {
+			unsigned int i = static_cast<unsigned int>(dE);
+			if (double(i) == dE)
+				return table[i];
+		}
+		return exp(-dE / temperature);
+	}
+
+	/// Metropolis acceptance of an energy change @p dE, given a uniform random number @p rnd in [0,1)
+	bool accept(double dE, double rnd) const {
+		if (dE <= 0)
+			return true;
+		return rnd < probability(dE);
+	}
+
+private:
+	double temperature;
+	std::vector<double> table;
+};
+
+#endif // BOLTZMANN_ACCEPTANCE_H
@@ -1,5 +1,6 @@
 #include "cell.h"
 #include "celltype.h"
+#include "checkpoint.h"
 
 using namespace SIM;
 
@@ -32,9 +33,7 @@ double Cell::getEccentricity() const {
 Cell::Cell(CPM::CELL_ID cell_name, CellType* ct)
 		: properties(p_properties), id(cell_name), name(to_str(cell_name)), celltype(ct), nodes(), shape_tracker(cell_name,nodes)
 {
-	for (uint i=0;i< celltype->default_properties.size(); i++) {
-		p_properties.push_back(celltype->default_properties[i]->clone());
-	}
+	createProperties();
 
 	track_nodes = true;
 	track_shape = true;
@@ -56,9 +55,7 @@ Cell::Cell( Cell& other_cell, CellType* ct  )
 		: properties(p_properties), id(other_cell.getID()), name(other_cell.name), celltype (ct),nodes(other_cell.nodes), node_sum(other_cell.node_sum),
 		centerL(other_cell.centerL), center(other_cell.center), shape_tracker(id, nodes) 
 {
-	for (uint i=0;i< celltype->default_properties.size(); i++) {
-		p_properties.push_back(celltype->default_properties[i]->clone());
-	}
+	createProperties();
 	
 	track_nodes = other_cell.track_nodes;
 	track_shape = other_cell.track_shape;
@@ -66,6 +63,20 @@ Cell::Cell( Cell& other_cell, CellType* ct  )
 
 Cell::~Cell() {
 	// all containers moved to shared_ptr -- auto cleanup
+	property_store->releaseSlot(property_slot);
+}
+
+void Cell::createProperties()
+{
+	property_store = celltype->property_store;
+	property_slot = property_store->acquireSlot();
+	for (uint i=0;i< celltype->default_properties.size(); i++) {
+		auto property = celltype->default_properties[i]->clone();
+		const auto& column = property_store->column(i);
+		if (column)
+			static_pointer_cast<ColumnarProperty>(property)->bind(column, property_slot);
+		p_properties.push_back(property);
+	}
 }
 
 void Cell::disableNodeTracking() {
@@ -113,6 +124,9 @@ void Cell::loadNodesFromXML(const XMLNode xNode) {
 			if ( sep != ';' and sep != ',') break;
 		}
 	}
+	else if (track_nodes && CPM::restoreCheckpointNodes(id)) {
+		// nodes restored from the cell lattice of a binary checkpoint
+	}
 	else // no nodes specified
 	{
 		cout << "Cell " << id << " already has " << CPM::getCell(id).getNodes().size() << " nodes." << endl;
@@ -147,13 +161,16 @@ XMLNode Cell::saveToXML() const {
 
  	if (track_nodes) {
  		xCNode.addChild("Center").addText( to_cstr(getCenter()) );
- 		ostringstream node_data;
- 		for (Nodes::const_iterator inode = nodes.begin(); inode != nodes.end(); inode++ )
- 		{
- 			if ( inode != nodes.begin() ) node_data << ";";
- 			node_data << *inode;
+ 		// binary checkpoints store the nodes within the cell lattice
+ 		if ( ! Checkpoint::Writer::current()) {
+ 			ostringstream node_data;
+ 			for (Nodes::const_iterator inode = nodes.begin(); inode != nodes.end(); inode++ )
+ 			{
+ 				if ( inode != nodes.begin() ) node_data << ";";
+ 				node_data << *inode;
+ 			}
+ 			xCNode.addChild("Nodes").addText(node_data.str().c_str());
  		}
- 		xCNode.addChild("Nodes").addText(node_data.str().c_str());
  	}
 	return xCNode;
 }
@@ -19,6 +19,8 @@
 #include "cpm_shape.h"
 #include "cpm_shape_tracker.h"
 
+class CellPropertyStore;
+
 /// Interface for all cells, implements basic platform integration
 class Cell
 {
@@ -58,12 +60,13 @@ public:
 	const Nodes& getSurface() const { return shape_tracker.current().surfaceNodes();}
 // 	const Nodes& getUpdatedSurface() const { return shape_tracker.updated().surfaceNodes(); } // __attribute__ ((deprecated));
 // 	const map<CPM::CELL_ID,uint>& getInterfaces() const { return shape_tracker.current().interfaces(); }; /// List of interfaces with other cells. Note that the count is given in number of neighbors.
-	const map< CPM::CELL_ID, double >& getInterfaceLengths() const { return shape_tracker.current().interfaces(); };; /// List of interfaces with other cells. Note that the counts are given in interface length (as getInterfaceLength()).
+	const CPMShape::Interfaces& getInterfaceLengths() const { return shape_tracker.current().interfaces(); };; /// List of interfaces with other cells. Note that the counts are given in interface length (as getInterfaceLength()).
 	double getInterfaceLength() const { return  shape_tracker.current().surface(); };
 	double getUpdatedInterfaceLength() const { return shape_tracker.updated().surface(); };
-	const map<CPM::CELL_ID,double>& getUpdatedInterfaceLengths() const { return shape_tracker.updated().interfaces(); };
+	const CPMShape::Interfaces& getUpdatedInterfaceLengths() const { return shape_tracker.updated().interfaces(); };
 	
 	const vector< shared_ptr<AbstractProperty> >& properties;
+	uint getPropertySlot() const { return property_slot; };          ///< Slot of the cell in the property columns of its celltype
 // 	const vector< shared_ptr<PDE_Layer> >& membranes;
 	void assignMatchingProperties(const vector< shared_ptr<AbstractProperty> > other_properties);
 // 	void assignMatchingMembranes(const vector< shared_ptr<PDE_Layer> > other_membranes);
@@ -95,6 +98,9 @@ protected:
 	VDOUBLE centerL, center;
 	CPMShapeTracker shape_tracker;
 	vector< shared_ptr<AbstractProperty> > p_properties;
+	shared_ptr<CellPropertyStore> property_store;
+	uint property_slot;
+	void createProperties();
 	
 	friend class CellType;
 };
@@ -0,0 +1,90 @@
+#include "cell_field_statistics.h"
+#include "field.h"
+#include "celltype.h"
+
+CellFieldStatistics::CellFieldStatistics(const PDE_Layer* field) : field(field), valid(false), modified(true)
+{}
+
+void CellFieldStatistics::validate()
+{
+	// Several reporters of the same field may validate concurrently
+	std::lock_guard<std::mutex> lock(sync_mutex);
+	if (modified.exchange(false) || !valid)
+		sync();
+}
+
+void CellFieldStatistics::beginSync()
+{
+	CPM::CELL_ID max_id = 0;
+	for (auto ct : CPM::getCellTypes()) {
+		const auto& ids = ct.lock()->getCellIDs();
+		if (!ids.empty())
+			max_id = max(max_id, *std::max_element(ids.begin(), ids.end()));
+	}
+	// Empty state nodes are accumulated as well
+	max_id = max(max_id, CPM::getEmptyState().cell_id);
+	thread_sums.resize(max(1, omp_get_max_threads()));
+	for (auto& t_sums : thread_sums)
+		t_sums.assign(max_id + 1, 0.0);
+}
+
+void CellFieldStatistics::addRow(const VINT& pos, const double* values, int n)
+{
+	auto& t_sums = thread_sums[omp_get_thread_index()];
+	auto layer = CPM::getLayer();
+	VINT node = pos;
+	for (int i=0; i<n; i++, node.x++) {
+		t_sums[layer->get(node).cell_id] += values[i];
+	}
+}
+
+void CellFieldStatistics::endSync()
+{
+	sums.swap(thread_sums[0]);
+	for (uint t=1; t<thread_sums.size(); t++) {
+		for (uint id=0; id<sums.size(); id++)
+			sums[id] += thread_sums[t][id];
+	}
+	modified = false;
+	valid = true;
+}
+
+double CellFieldStatistics::average(CPM::CELL_ID id) const
+{
+	uint n_nodes = CPM::getCell(id).nNodes();
+	return n_nodes ? sum(id) / n_nodes : 0;
+}
+
+void CellFieldStatistics::sync()
+{
+	vector<CPM::CELL_ID> cells;
+	for (auto ct : CPM::getCellTypes()) {
+		const auto& ids = ct.lock()->getCellIDs();
+		cells.insert(cells.end(), ids.begin(), ids.end());
+	}
+	CPM::CELL_ID max_id = cells.empty() ? 0 : *std::max_element(cells.begin(), cells.end());
+	sums.assign(max_id + 1, 0.0);
+
+#pragma omp parallel for schedule(dynamic,16)
+	for (uint i=0; i<cells.size(); i++) {
+		double sum = 0;
+		for (const auto& node : CPM::getCell(cells[i]).getNodes())
+			sum += field->get(node);
+		sums[cells[i]] = sum;
+	}
+	valid = true;
+}
+
+void CellFieldStatistics::nodeChanged(const VINT& pos, CPM::CELL_ID from, CPM::CELL_ID to)
+{
+#ifdef HAVE_OPENMP
+	assert(!omp_in_parallel());
+#endif
+	// Invalid sums are recomputed anyway
+	if (!valid) return;
+	double value = field->get(pos);
+	if (max(from, to) >= sums.size())
+		sums.resize(max(from, to) + 1, 0.0);
+	sums[from] -= value;
+	sums[to] += value;
+}
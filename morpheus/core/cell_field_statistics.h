@@ -0,0 +1,72 @@
+//////
+//
+// This file is part of the modelling and simulation framework 'Morpheus',
+// and is made available under the terms of the BSD 3-clause license (see LICENSE
+// file that comes with the distribution or https://opensource.org/licenses/BSD-3-Clause).
+//
+// Authors:  Joern Starruss and Walter de Back
+// Copyright 2009-2016, Technische Universität Dresden, Germany
+//
+//////
+
+#ifndef CELL_FIELD_STATISTICS_H
+#define CELL_FIELD_STATISTICS_H
+
+#include "config.h"
+#include "cpm_layer.h"
+#include <atomic>
+#include <mutex>
+
+class PDE_Layer;
+
+/** @brief Per cell sums of a scalar field, maintained incrementally
+ *
+ *  Once synchronized, the sums are adjusted for every node that changes its owner in CPM::executeCPMUpdate(),
+ *  such that per cell sums and averages are available in O(cells) instead of a pass over all cell nodes.
+ *  Modifications of the field values invalidate the sums, which are then recomputed upon the next validate().
+ *  Forward euler diffusion instead re-synchronizes the sums within its last sub step (see beginSync()).
+ *
+ *  Instances are owned by the CPM, which creates them on demand (see CPM::getFieldStatistics()) and
+ *  reports every changed node to them.
+ */
+class CellFieldStatistics {
+public:
+	CellFieldStatistics(const PDE_Layer* field);
+	CellFieldStatistics(const CellFieldStatistics&) = delete;
+	CellFieldStatistics& operator=(const CellFieldStatistics&) = delete;
+
+	/// Mark the field values as modified. Thread safe.
+	void invalidate() { modified.store(true, std::memory_order_relaxed); }
+	/// Recompute the sums if the field was modified since the last call. Thread safe.
+	void validate();
+
+	/** Recompute the sums from all field values, which are provided row by row via addRow() while computing them.
+	 *  Thereby, diffusion solvers re-synchronize the sums without another pass over the cell nodes.
+	 */
+	void beginSync();
+	/// Add the @p n values of a lattice row starting at @p pos. Thread safe wrt. other rows.
+	void addRow(const VINT& pos, const double* values, int n);
+	void endSync();
+
+	double sum(CPM::CELL_ID id) const { return id < sums.size() ? sums[id] : 0; }
+	double average(CPM::CELL_ID id) const;
+	const PDE_Layer* getField() const { return field; }
+
+	/** Node @p pos changes its owner from cell @p from to cell @p to. Called by CPM::executeCPMUpdate().
+	 *  Not synchronized, since updates of the cell configuration are applied serially outside of parallel regions.
+	 */
+	void nodeChanged(const VINT& pos, CPM::CELL_ID from, CPM::CELL_ID to);
+
+private:
+	void sync();
+
+	const PDE_Layer* field;
+	vector<double> sums;
+	bool valid;
+	std::atomic<bool> modified;
+	std::mutex sync_mutex;
+	/// Per thread sums of the fused re-synchronization
+	vector< vector<double> > thread_sums;
+};
+
+#endif // CELL_FIELD_STATISTICS_H
@@ -9,26 +9,41 @@ Update::Update(UpdateData* data, shared_ptr<CPM::LAYER> layer) {
 
 void Update::set(VINT source, VINT dir, Update::Operation opx) {
 	
-	VINT pos = source;
-	layer->lattice().resolve(pos);
-	d->add_state = layer->get(pos);
-	// In case we copy from a boundary state, we have to fix pos.
-	if (!layer->lattice().equal_pos(pos,d->add_state.pos))
-		d->add_state.pos = pos;
-	d->source.setCell(d->add_state.cell_id, pos);
+	VINT pos = source + dir;
+	const VINT& size = layer->lattice().size();
+	auto interior = [&size](const VINT& a) {
+		return a.x>=0 && a.x<size.x && a.y>=0 && a.y<size.y && a.z>=0 && a.z<size.z;
+	};
 	
-	d->add_state.pos += dir;
-	pos+=dir;
-	
-	if ( ! layer->lattice().resolve(pos) )  {
-		operation = NONE;
-		return;
+	if (interior(source) && interior(pos)) {
+		// Fast path away from the lattice boundaries: nothing to resolve, and
+		// interior nodes always carry a position consistent with the lattice.
+		d->add_state = layer->get(source);
+		d->source.setCell(d->add_state.cell_id, source);
+		d->add_state.pos += dir;
+	}
+	else {
+		pos = source;
+		layer->lattice().resolve(pos);
+		d->add_state = layer->get(pos);
+		// In case we copy from a boundary state, we have to fix pos.
+		if (!layer->lattice().equal_pos(pos,d->add_state.pos))
+			d->add_state.pos = pos;
+		d->source.setCell(d->add_state.cell_id, pos);
+		
+		d->add_state.pos += dir;
+		pos+=dir;
+		
+		if ( ! layer->lattice().resolve(pos) )  {
+			operation = NONE;
+			return;
+		}
 	}
 	d->remove_state = layer->get(pos);
 	d->focus.setCell(d->remove_state.cell_id, pos);
 	d->focus_updated.setCell(d->add_state.cell_id, pos);
 	
-	
+	// Attached stencils share the neighborhood union, which is gathered lazily once for all of them
 	if (d->boundary) d->boundary->setPosition(focus().pos());
 	if (d->update) d->update->setPosition(focus().pos());
 	if (d->surface) d->surface->setPosition(focus().pos());
@@ -16,6 +16,8 @@ namespace CPM {
 				focus_updated; /// Same as focus, but including this update
 		STATE add_state; /// State after update (so irregardless of operation)
 		STATE remove_state; /// State before update
+		/// Union of all neighborhood stencils below, gathered in a single pass from the lattice
+		shared_ptr<UnionLatticeStencil> neighborhood_union;
 		/// Neighborhood stencil used for selecting Updates of the spatial configuration, in particular for the Monte Carlo Sampler of the CPM.
 		shared_ptr<LatticeStencil> update;
 		/// Neighborhood stencil used to select surface nodes. Any node having a different state in the surface neigborhood is a surface node.
@@ -55,6 +57,8 @@ namespace CPM {
 		/// Most prominently the Interactions, Perimeter, Perimeter constraints, 
 		/// Is determined by CPM/ShapeSurface/Neighborhood
 		shared_ptr< const StatisticalLatticeStencil> boundaryStencil() const { return d->boundary; };
+		/// Union of all the neighborhoods above, order is that of registration (see CPM::getNeighborhoodUnion())
+		shared_ptr< const UnionLatticeStencil> neighborhoodUnion() const { return d->neighborhood_union; };
 		
 		int op() const { return operation; };
 		/// Operation includes addition of Node focus to Cell of focusStateAfter()
@@ -98,7 +98,35 @@ CellIndexStorage CellType::storage;
 
 double CellPopulationSizeSymbol::get(const SymbolFocus&) const { return celltype->getCellIDs().size();}
 
-CellType::CellType(uint ct_id) :  default_properties(_default_properties)
+uint CellPropertyStore::acquireSlot()
+{
+	if ( ! free_slots.empty() ) {
+		uint slot = free_slots.back();
+		free_slots.pop_back();
+		return slot;
+	}
+	slot_count++;
+	for (auto& column : columns) {
+		if (column) column->resize(slot_count);
+	}
+	return slot_count-1;
+}
+
+void CellPropertyStore::releaseSlot(uint slot)
+{
+	free_slots.push_back(slot);
+}
+
+void CellPropertyStore::addColumn(uint pid, shared_ptr<AbstractPropertyColumn> column)
+{
+	if (columns.size() <= pid)
+		columns.resize(pid+1);
+	if (column)
+		column->resize(slot_count);
+	columns[pid] = column;
+}
+
+CellType::CellType(uint ct_id) :  default_properties(_default_properties), property_store(make_shared<CellPropertyStore>())
 {
 	id= ct_id;
 	name ="";
@@ -223,6 +251,15 @@ void CellType::init() {
 		}
 	}
 	
+	if (Profiler::enabled()) {
+		energy_profiles.clear();
+		for (const auto& e : energies)
+			energy_profiles.push_back(Profiler::counter("energy", name + "/" + e->XMLName()));
+		check_update_profiles.clear();
+		for (const auto& c : check_update_listener)
+			check_update_profiles.push_back(Profiler::counter("update_check", name + "/" + c->XMLName()));
+	}
+	
 	// Create all cell populations through Cell definitions / initializers / at random positions
 	map<CPM::CELL_ID, XMLNode> predefined_cells;
 	for (auto& cp : cell_populations) {
@@ -241,7 +278,8 @@ void CellType::init() {
 				cell_id =  createCell();
 			
 			storage.cell(cell_id).loadNodesFromXML(xCellNode);
-			if ( CPM::isEnabled() && storage.cell(cell_id).getNodes().size() == 0){
+			// The medium cell does not track its nodes
+			if ( CPM::isEnabled() && storage.cell(cell_id).isNodeTracking() && storage.cell(cell_id).getNodes().size() == 0){
 				cout << "!!Warning!! Created empty cell,i.e. without occupied node, in spatial simualtion  removing it again" << endl;
 				removeCell( cell_id );
 			}
@@ -649,6 +687,7 @@ bool CellType::check_update(const CPM::Update& update) const
 		if (update.opAdd()) {
 			auto update_add = update.selectOp(CPM::Update::ADD);
 			for ( uint c=0; c < check_update_listener.size(); c++ ) {
+				ProfileTimer timer(check_update_profiles.empty() ? nullptr : check_update_profiles[c].get());
 				if (! check_update_listener[c] -> update_check( update.focusStateAfter().cell_id , update_add))
 					return false;
 			}
@@ -657,6 +696,7 @@ bool CellType::check_update(const CPM::Update& update) const
 		if (update.opRemove()) {
 			auto update_remove = update.selectOp(CPM::Update::REMOVE);
 			for ( uint c=0; c < check_update_listener.size(); c++ ) {
+				ProfileTimer timer(check_update_profiles.empty() ? nullptr : check_update_profiles[c].get());
 				if (! check_update_listener[c] -> update_check( update.focusStateBefore().cell_id , update_remove)) 
 					return false;
 			}
@@ -673,12 +713,14 @@ double CellType::delta(const CPM::Update& update) const
 	if (update.opAdd()) {
 		auto update_add = update.selectOp(CPM::Update::ADD);
 		for (uint e = 0; e<energies.size(); ++e) {
+			ProfileTimer timer(energy_profiles.empty() ? nullptr : energy_profiles[e].get());
 			delta += energies[e]->delta(update.focusUpdated(), update_add);
 		}
 	}
 	if (update.opRemove()) {
 		auto update_remove = update.selectOp(CPM::Update::REMOVE);
 		for (uint e = 0; e<energies.size(); ++e) {
+			ProfileTimer timer(energy_profiles.empty() ? nullptr : energy_profiles[e].get());
 			delta += energies[e]->delta(update.focus(), update_remove);
 		}
 	}
@@ -17,6 +17,7 @@
 #include "cell.h"
 #include "symbol.h"
 #include "ClassFactory.h"
+#include "profiler.h"
 
 class CellIndexStorage {
 public:
@@ -109,17 +110,84 @@ private:
 	const  CellType* celltype;
 };
 
+/// Type-erased column of cell property values
+class AbstractPropertyColumn {
+public:
+	virtual void resize(uint size) =0;
+	virtual ~AbstractPropertyColumn() {};
+};
+
+/// Contiguous values and buffers of a cell property, indexed by the property slot of the cells
 template <class T>
-class PrimitiveProperty : public AbstractProperty {
+class PropertyColumn : public AbstractPropertyColumn {
 public:
-	PrimitiveProperty(string symbol, T value) : symbol_name(make_shared<string>(symbol)), value(value), buffer(value) {};
-	PrimitiveProperty(const PrimitiveProperty<T>& other) : symbol_name(other.symbol_name), value(other.value), buffer(other.value) {};
+	void resize(uint size) override { values.resize(size); buffers.resize(size); }
+	vector<T> values, buffers;
+};
+
+/** Columnar storage of the cell properties of a CellType
+ * 
+ * Each cell occupies a dense slot, and the values of a property are stored in one contiguous column indexed by that slot.
+ * Slots of removed cells are reused by subsequently created cells. The store is shared with the cells, such that it outlives
+ * all cells holding a slot.
+ */
+class CellPropertyStore {
+public:
+	CellPropertyStore() : slot_count(0) {};
+	uint acquireSlot();
+	void releaseSlot(uint slot);
+	/// Number of slots, including the ones currently released
+	uint size() const { return slot_count; }
+	/// Register the column of property @p pid, an empty @p column is used for properties that are not stored columnar
+	void addColumn(uint pid, shared_ptr<AbstractPropertyColumn> column);
+	const shared_ptr<AbstractPropertyColumn>& column(uint pid) const { return columns[pid]; }
+	template <class T>
+	PropertyColumn<T>* column(uint pid) const { return static_cast<PropertyColumn<T>*>(columns[pid].get()); }
+	
+private:
+	uint slot_count;
+	vector<uint> free_slots;
+	vector< shared_ptr<AbstractPropertyColumn> > columns;
+};
+
+/// Cell property that can be bound to a slot of a CellPropertyStore column
+class ColumnarProperty : public AbstractProperty {
+public:
+	virtual shared_ptr<AbstractPropertyColumn> createColumn() const =0;
+	/// Move the property value into @p slot of @p column
+	virtual void bind(const shared_ptr<AbstractPropertyColumn>& column, uint slot) =0;
+};
+
+/** Primitive cell property
+ * 
+ * Default properties of a CellType hold their value themselves, while the properties of the cells are bound to a slot of the 
+ * CellType's CellPropertyStore.
+ */
+template <class T>
+class PrimitiveProperty : public ColumnarProperty {
+public:
+	PrimitiveProperty(string symbol, T value) : symbol_name(make_shared<string>(symbol)), column(nullptr), slot(0), _value(value), _buffer(value) {};
+	PrimitiveProperty(const PrimitiveProperty<T>& other) : symbol_name(other.symbol_name), column(nullptr), slot(0), _value(other.value()), _buffer(other.value()) {};
 	const string& symbol() const override { return *symbol_name; }
 	const string& type() const override { return TypeInfo<T>::name(); }
 	
 	shared_ptr<AbstractProperty> clone() const override { return make_shared< PrimitiveProperty<T> >(*this); }
 	void init(const SymbolFocus& ) override {};
 	
+	shared_ptr<AbstractPropertyColumn> createColumn() const override { return make_shared< PropertyColumn<T> >(); }
+	void bind(const shared_ptr<AbstractPropertyColumn>& c, uint s) override {
+		auto col = static_cast<PropertyColumn<T>*>(c.get());
+		col->values[s] = std::move(_value);
+		col->buffers[s] = std::move(_buffer);
+		column = col; slot = s;
+		_value = T(); _buffer = T();
+	}
+	
+	T& value() { return column ? column->values[slot] : _value; }
+	const T& value() const { return column ? column->values[slot] : _value; }
+	T& buffer() { return column ? column->buffers[slot] : _buffer; }
+	const T& buffer() const { return column ? column->buffers[slot] : _buffer; }
+	
 	void assign(shared_ptr<AbstractProperty> other) override {
 		auto derived = dynamic_pointer_cast<PrimitiveProperty<T>>(other);
 		if (!derived)
@@ -127,8 +195,8 @@ public:
 		assign(derived);
 	};
 	void assign(shared_ptr< PrimitiveProperty<T> > other) {
-		value = other->value;
-		buffer = other->buffer;
+		value() = other->value();
+		buffer() = other->buffer();
 	};
 	
 	string XMLDataName() const override { return type()+"PropertyData"; }
@@ -136,19 +204,23 @@ public:
 		if (XMLDataName() != string(node.getName())) {
 			cout << "Warning: Property Data tagname mismatch: " << XMLDataName() << " != " << node.getName() << endl;
 		}
-		value = TypeInfo<T>::fromString(node.getAttribute("value"));
+		value() = TypeInfo<T>::fromString(node.getAttribute("value"));
 // 		value = TypeInfo<T>::fromString(node.getText());
 	};
 	XMLNode storeData() const override { 
 		auto node = XMLNode::createXMLTopNode(XMLDataName().c_str());
 		node.addAttribute("symbol-ref", symbol().c_str());
-		node.addAttribute("value",TypeInfo<T>::toString(value).c_str());
+		node.addAttribute("value",TypeInfo<T>::toString(value()).c_str());
 // 		node.addText(to_cstr(value));
 		return node;
 	};
 	
 	shared_ptr<string> symbol_name;
-	T value, buffer;
+	
+private:
+	PropertyColumn<T>* column;
+	uint slot;
+	T _value, _buffer;
 };
 
 /** Primitive Symbol (accessor) for cell-attached Properties
@@ -163,22 +235,27 @@ public:
 template <class T>
 class PrimitivePropertySymbol : public SymbolRWAccessorBase<T> {
 public:
-	PrimitivePropertySymbol(string symbol, const CellType* ct,  uint pid) : SymbolRWAccessorBase<T>(symbol), celltype(ct), property_id(pid) {
-		this->flags().granularity = Granularity::Cell;
-	}
+	PrimitivePropertySymbol(string symbol, const CellType* ct,  uint pid);
 	std::string linkType() const override { return "CellPropertyLink"; }
 	const string& description() const override { return this->name(); }
-	typename TypeInfo<T>::SReturn get(const SymbolFocus& f) const override { return getCellProperty(f)->value; }
-	typename TypeInfo<T>::Reference getRef(const SymbolFocus& f) const { return getCellProperty(f)->value; }
+	typename TypeInfo<T>::SReturn get(const SymbolFocus& f) const override { return column->values[slot(f)]; }
+	/// Reference to the value of a cell, invalidated when a cell is created and the column grows
+	typename TypeInfo<T>::Reference getRef(const SymbolFocus& f) const { return column->values[slot(f)]; }
 // 		void init(const SymbolFocus&) const override {};
-	void set(const SymbolFocus& f, typename TypeInfo<T>::Parameter value) const override { getCellProperty(f)->value = value; };
-	void setBuffer(const SymbolFocus& f, typename TypeInfo<T>::Parameter value) const override { getCellProperty(f)->buffer = value; };
+	void set(const SymbolFocus& f, typename TypeInfo<T>::Parameter value) const override { column->values[slot(f)] = value; };
+	void setBuffer(const SymbolFocus& f, typename TypeInfo<T>::Parameter value) const override { column->buffers[slot(f)] = value; };
 	void applyBuffer() const override;
-	void applyBuffer(const SymbolFocus& f) const override {  getCellProperty(f)->value =  getCellProperty(f)->buffer; };
+	void applyBuffer(const SymbolFocus& f) const override { auto s = slot(f); column->values[s] = column->buffers[s]; };
+	/// Contiguous values of all cells, indexed by Cell::getPropertySlot(). Released slots hold stale values.
+	/// Like getRef(), the reference is invalidated when a cell is created.
+	const vector<T>& values() const { return column->values; }
+	const CellType* cellType() const { return celltype; }
 protected:
+	uint slot(const SymbolFocus& f) const { assert(f.cell().getCellType() == celltype); return f.cell().getPropertySlot(); }
 	PrimitiveProperty<T>* getCellProperty(const SymbolFocus& f) const;
 	const CellType* celltype;
 	uint property_id;
+	PropertyColumn<T>* column;
 };
 
 
@@ -221,11 +298,16 @@ public:
 	const vector< CPM::CELL_ID >& getCellIDs() const { return cell_ids; }
 
 	const vector< shared_ptr<AbstractProperty> >& default_properties;
+	/// Columnar storage of the properties of all cells
+	const CellPropertyStore& propertyStore() const { return *property_store; }
 
 // 	
 	uint addProperty(shared_ptr<AbstractProperty> property) {
+		uint pid = _default_properties.size();
 		_default_properties.push_back(property);
-		return _default_properties.size()-1;
+		auto columnar = dynamic_pointer_cast<ColumnarProperty>(property);
+		property_store->addColumn(pid, columnar ? columnar->createColumn() : nullptr);
+		return pid;
 	}
 	
 	template <class T>
@@ -233,8 +315,7 @@ public:
 	
 	template <class T>
 	PropertyAccessor<T> addProperty(string symbol, T value)  {
-		uint pid = _default_properties.size();
-		_default_properties.push_back( make_shared< PrimitiveProperty<T> >(symbol,value));
+		uint pid = addProperty( make_shared< PrimitiveProperty<T> >(symbol,value) );
 		return make_shared<PrimitivePropertySymbol<T> >(symbol,this,pid);
 	}
 
@@ -278,9 +359,13 @@ protected:
 	vector< shared_ptr<CPM_Energy> > energies;
 	vector< shared_ptr<Cell_Update_Checker> > check_update_listener;
 	vector< shared_ptr<Cell_Update_Listener> > update_listener;
+	/// Profile counters of energies and update checkers, empty unless profiling
+	vector< shared_ptr<ProfileCounter> > energy_profiles;
+	vector< shared_ptr<ProfileCounter> > check_update_profiles;
 
 	// Cell specific properties
 	vector< shared_ptr<AbstractProperty> > _default_properties;
+	shared_ptr<CellPropertyStore> property_store;
 
 	// Cell populations
 	vector< CPM::CELL_ID > cell_ids;
@@ -323,13 +408,17 @@ public:
 // /////////////////////////////////////////////////////////////////////
 // // Implemntation of template functions
 
+template <class T>
+PrimitivePropertySymbol<T>::PrimitivePropertySymbol(string symbol, const CellType* ct,  uint pid) : SymbolRWAccessorBase<T>(symbol), celltype(ct), property_id(pid) {
+	this->flags().granularity = Granularity::Cell;
+	column = ct->propertyStore().template column<T>(pid);
+	assert(column);
+}
+
 template <class T>
 void PrimitivePropertySymbol<T>::applyBuffer() const  {
-	auto cells = celltype->getCellIDs();
-	for (auto cell : cells) {
-		auto p = getCellProperty(SymbolFocus(cell));
-		p->value = p->buffer;
-	}
+	// Released slots are copied alongside, which is cheaper than visiting the cells
+	std::copy(column->buffers.begin(), column->buffers.end(), column->values.begin());
 }
 
 template <class T>
@@ -0,0 +1,90 @@
+#include "checkpoint.h"
+#include "simulation.h"
+
+namespace Checkpoint {
+
+namespace {
+	const char magic[] = "MorpheusBinary1";
+}
+
+Writer* Writer::current_writer = nullptr;
+
+Writer::Writer(const string& filename) : file_name(filename), offset(0)
+{
+	out.open(file_name, ios_base::out | ios_base::trunc | ios_base::binary);
+	if (!out.is_open())
+		throw string("Unable to open checkpoint file ") + file_name;
+	out.write(magic, sizeof(magic));
+	offset = sizeof(magic);
+	current_writer = this;
+}
+
+Writer::~Writer()
+{
+	close();
+}
+
+Writer* Writer::current()
+{
+	return current_writer;
+}
+
+XMLNode Writer::write(const void* data, size_t size, size_t word_size)
+{
+	XMLNode xData = XMLNode::createXMLTopNode("Data");
+	xData.addAttribute("encoding", "binary");
+	xData.addAttribute("filename", file_name.c_str());
+	xData.addAttribute("offset", to_cstr(offset));
+	xData.addAttribute("size", to_cstr(size));
+	xData.addAttribute("word-size", to_cstr(word_size));
+
+	out.write(reinterpret_cast<const char*>(data), size);
+	if (out.fail())
+		throw string("Unable to write checkpoint file ") + file_name;
+	offset += size;
+	return xData;
+}
+
+void Writer::close()
+{
+	if (current_writer == this)
+		current_writer = nullptr;
+	if (out.is_open())
+		out.close();
+}
+
+
+bool isBinary(const XMLNode xData)
+{
+	string encoding;
+	return getXMLAttribute(xData, "encoding", encoding) && encoding == "binary";
+}
+
+void read(const XMLNode xData, void* data, size_t size)
+{
+	string filename;
+	uint64_t offset, stored_size;
+	if ( ! getXMLAttribute(xData, "filename", filename) || ! getXMLAttribute(xData, "offset", offset) || ! getXMLAttribute(xData, "size", stored_size) )
+		throw MorpheusException("Incomplete reference to binary data", xData);
+	if (stored_size != size)
+		throw MorpheusException(string("Wrong binary data size ") + to_str(stored_size) + " != " + to_str(size), xData);
+
+	// Relative paths refer to the directory of the model
+	if (filename[0] != '/')
+		filename = SIM::getInputDirectory() + "/" + filename;
+	ifstream in(filename, ios_base::in | ios_base::binary);
+	if (!in.is_open())
+		throw MorpheusException(string("Unable to open binary data file ") + filename, xData);
+
+	char file_magic[sizeof(magic)];
+	in.read(file_magic, sizeof(magic));
+	if (in.fail() || string(file_magic, sizeof(magic)) != string(magic, sizeof(magic)))
+		throw MorpheusException(string("Invalid binary data file ") + filename, xData);
+
+	in.seekg(offset);
+	in.read(reinterpret_cast<char*>(data), size);
+	if (in.fail())
+		throw MorpheusException(string("Unable to read binary data from file ") + filename, xData);
+}
+
+}
@@ -0,0 +1,52 @@
+//////
+//
+// This file is part of the modelling and simulation framework 'Morpheus',
+// and is made available under the terms of the BSD 3-clause license (see LICENSE
+// file that comes with the distribution or https://opensource.org/licenses/BSD-3-Clause).
+//
+// Authors:  Joern Starruss and Walter de Back
+// Copyright 2009-2016, Technische Universität Dresden, Germany
+//
+//////
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "xml_functions.h"
+#include <cstdint>
+
+/** @brief Binary data of checkpoints
+ *
+ *  Binary checkpoints (SaveInterval with format="binary") keep the model description and the cell properties in the XML snapshot,
+ *  while the bulk data, i.e. the field buffers and the cell lattice, is appended as raw memory blocks to a separate binary file.
+ *  The snapshot references the blocks through Data nodes with encoding="binary", such that a simulation is restored
+ *  by loading the snapshot like any other model.
+ */
+namespace Checkpoint {
+
+/// Appends the raw data blocks of a checkpoint to its binary file
+class Writer {
+public:
+	explicit Writer(const string& filename);
+	~Writer();
+	/// The Writer of the checkpoint currently saved, nullptr for plain XML snapshots
+	static Writer* current();
+	/// Append a data block of @p size bytes and return a Data node referencing it
+	XMLNode write(const void* data, size_t size, size_t word_size);
+	void close();
+
+private:
+	string file_name;
+	ofstream out;
+	uint64_t offset;
+	static Writer* current_writer;
+};
+
+/// Whether @p xData references a block of binary checkpoint data
+bool isBinary(const XMLNode xData);
+/// Read the block referenced by @p xData to @p data, the block must comprise @p size bytes
+void read(const XMLNode xData, void* data, size_t size);
+
+}
+
+#endif // CHECKPOINT_H
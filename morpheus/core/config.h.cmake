@@ -10,8 +10,16 @@
 
 #ifdef HAVE_OPENMP
     #include <omp.h>
+    /// Index of the calling thread within the innermost team of more than one thread.
+    /// Unlike omp_get_thread_num(), it stays unique in serialized nested regions, e.g. when plugins run as tasks.
+    inline int omp_get_thread_index() {
+        for (int level = omp_get_level(); level > 0; level--)
+            if (omp_get_team_size(level) > 1) return omp_get_ancestor_thread_num(level);
+        return 0;
+    }
 #else
     inline int omp_get_thread_num()  { return 0;} 
+    inline int omp_get_thread_index()  { return 0;} 
     inline int omp_get_num_threads() { return 1;}
     inline int omp_get_max_threads() { return 1;}
     typedef int omp_lock_t;
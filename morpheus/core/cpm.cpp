@@ -1,6 +1,8 @@
 #define CPM_CPP
 
 #include "cpm_p.h"
+#include "checkpoint.h"
+#include "cell_field_statistics.h"
 // #include "simulation_p.h"
 
 
@@ -23,11 +25,15 @@ namespace CPM {
 	
 	bool surface_everywhere=false;
 	shared_ptr<EdgeTrackerBase> edgeTracker;
+	/// Per cell field sums that follow the cell configuration
+	vector< shared_ptr<CellFieldStatistics> > field_statistics;
 	
 	vector< shared_ptr<CellType> > celltypes;
 	map< std::string, uint > celltype_names;
 	Scope* scope;
 	XMLNode xCellPop,xCellTypes,xCPM;
+	/// Nodes of the cells restored from a binary checkpoint, valid until the cell populations are created
+	map< CELL_ID, vector<VINT> > checkpoint_nodes;
 	
 	class BoundaryReader : public CPM::LAYER::ValueReader {
 	public:
@@ -116,7 +122,8 @@ void enableEgdeTracking()
 	// Don't enable the edge tracker when just creating a dependency graph
 	if (SIM::dependencyGraphMode()) return ;
 	
-	if (!dynamic_pointer_cast<EdgeListTracker>(edgeTracker)) {
+	// Any edge tracker will do, but one has to exist
+	if (!edgeTracker || dynamic_pointer_cast<NoEdgeTracker>(edgeTracker)) {
 		if ( ! update_neighborhood.empty() ) {
 			edgeTracker = shared_ptr<EdgeTrackerBase>(new EdgeListTracker(layer, update_neighborhood.neighbors(), surface_neighborhood.neighbors()));
 		}
@@ -126,10 +133,35 @@ void enableEgdeTracking()
 	}
 }
 
+void enableCompactEdgeTracking()
+{
+	// Don't enable the edge tracker when just creating a dependency graph
+	if (SIM::dependencyGraphMode()) return ;
+	
+	if (!dynamic_pointer_cast<CompactEdgeTracker>(edgeTracker)) {
+		if ( ! update_neighborhood.empty() ) {
+			edgeTracker = shared_ptr<EdgeTrackerBase>(new CompactEdgeTracker(layer, update_neighborhood.neighbors(), surface_neighborhood.neighbors()));
+		}
+		else {
+			edgeTracker = shared_ptr<EdgeTrackerBase>(new CompactEdgeTracker(layer, surface_neighborhood.neighbors(), surface_neighborhood.neighbors()));
+		}
+	}
+}
+
 shared_ptr<const EdgeTrackerBase> cellEdgeTracker() {                                                      
 	return edgeTracker;
 }
 
+shared_ptr<CellFieldStatistics> getFieldStatistics(const PDE_Layer* field)
+{
+	for (const auto& stats : field_statistics) {
+		if (stats->getField() == field)
+			return stats;
+	}
+	field_statistics.push_back(make_shared<CellFieldStatistics>(field));
+	return field_statistics.back();
+}
+
 const Neighborhood& getBoundaryNeighborhood()
 {
 	return boundary_neighborhood;
@@ -140,6 +172,11 @@ const Neighborhood& getSurfaceNeighborhood()
 	return surface_neighborhood;
 }
 
+shared_ptr<const UnionLatticeStencil> getNeighborhoodUnion()
+{
+	return global_update_data.neighborhood_union;
+}
+
 void setInteractionSurface(bool enabled) {
 	surface_everywhere = enabled;
 }
@@ -326,14 +363,18 @@ void init() {
 						layer->set(InitialState.pos, InitialState);
 
 		// Creating a default global update template
-		global_update_data.boundary = unique_ptr<StatisticalLatticeStencil>(new StatisticalLatticeStencil(layer, boundary_neighborhood.neighbors()));
-		global_update_data.surface = unique_ptr<LatticeStencil>(new LatticeStencil(layer, surface_neighborhood.neighbors()));
+		// All stencils read from a common neighborhood union, such that every node is fetched only once per update.
+		// The union starts with the boundary neighborhood in its original order.
+		global_update_data.neighborhood_union = make_shared<UnionLatticeStencil>(layer);
+		global_update_data.neighborhood_union->addNeighbors(boundary_neighborhood.neighbors());
+		global_update_data.boundary = make_shared<StatisticalLatticeStencil>(global_update_data.neighborhood_union, boundary_neighborhood.neighbors());
+		global_update_data.surface = make_shared<LatticeStencil>(global_update_data.neighborhood_union, surface_neighborhood.neighbors());
 		if ( ! update_neighborhood.empty() ) {
 			if (update_neighborhood.neighbors() == surface_neighborhood.neighbors()) {
 				global_update_data.update = global_update_data.surface;
 			}
 			else {
-				global_update_data.update = make_unique<LatticeStencil>(layer, update_neighborhood.neighbors());
+				global_update_data.update = make_shared<LatticeStencil>(global_update_data.neighborhood_union, update_neighborhood.neighbors());
 			}
 			// Setting up the EdgeTracker
 			edgeTracker = shared_ptr<EdgeTrackerBase>(new NoEdgeTracker(layer, update_neighborhood.neighbors(), surface_neighborhood.neighbors()));
@@ -344,6 +385,7 @@ void init() {
 		
 	}
 	else {
+		global_update_data.neighborhood_union = 0;
 		global_update_data.boundary = 0;
 		global_update_data.update = 0;
 		global_update_data.surface = 0;
@@ -356,6 +398,7 @@ void init() {
 		cout << "Initializing celltype \'" << celltypes[i]->getName() << "\'" <<endl;
 		celltypes[i]->init();
 	}
+	checkpoint_nodes.clear();
 	// Init the sampler
 	if ( cpm_sampler) {
 		cpm_sampler->init(SIM::getGlobalScope());
@@ -377,6 +420,20 @@ void loadCellPopulations()
 // 	}
 	
 	
+	// Binary checkpoints store the cell lattice as a whole
+	XMLNode xData = xCellPop.getChildNode("Data");
+	if ( ! xData.isEmpty() && Checkpoint::isBinary(xData)) {
+		VINT size = SIM::lattice().size();
+		vector<STATE> states(size.x * size.y * size.z);
+		Checkpoint::read(xData, states.data(), states.size() * sizeof(STATE));
+		VINT pos; uint i=0;
+		for (pos.z=0; pos.z<size.z; pos.z++)
+			for (pos.y=0; pos.y<size.y; pos.y++)
+				for (pos.x=0; pos.x<size.x; pos.x++, i++)
+					if (states[i].cell_id != layer->get(pos).cell_id)
+						checkpoint_nodes[states[i].cell_id].push_back(states[i].pos);
+	}
+	
 	vector<XMLNode> defered_poulations;
 	for (int i=0; i<xCellPop.nChildNode("Population"); i++) {
 		XMLNode population = xCellPop.getChildNode("Population",i);
@@ -405,6 +462,20 @@ void loadCellPopulations()
 	}
 }
 
+bool restoreCheckpointNodes(CELL_ID cell_id)
+{
+	auto nodes = checkpoint_nodes.find(cell_id);
+	if (nodes == checkpoint_nodes.end())
+		return false;
+	for (const auto& position : nodes->second) {
+		if ( ! setNode(position, cell_id) ) {
+			cout << "Cell::loadFromXML  unable to put cell [" << cell_id << "] at " << position << endl; break;
+		}
+	}
+	checkpoint_nodes.erase(nodes);
+	return true;
+}
+
 XMLNode saveCPM() { return xCPM; };
 
 XMLNode saveCellTypes() { return xCellTypes; }
@@ -416,6 +487,10 @@ XMLNode saveCellPopulations() {
 			xCP.addChild(celltypes[ct] -> savePopulationToXML());
 		}
 		xCP.addChild(layer->saveToXML().getChildNode("BoundaryValues") );
+		if (Checkpoint::Writer::current()) {
+			valarray<STATE> states = layer->getData();
+			xCP.addChild(Checkpoint::Writer::current()->write(&states[0], states.size() * sizeof(STATE), sizeof(STATE)));
+		}
 		return xCP; 
 	}
 	else 
@@ -464,6 +539,8 @@ bool executeCPMUpdate(const CPM::Update& update) {
 			}
 			VINT position = update.focus().pos();
 // 			assert( layer -> writable_resolve(position) );
+			for (const auto& stats : field_statistics)
+				stats->nodeChanged(position, update.focusStateBefore().cell_id, update.focusStateAfter().cell_id);
 			layer->set(position,update.focusStateAfter());
 			assert(edgeTracker);
 			if (update.updateStencil())
@@ -597,11 +674,14 @@ void setUpdate(CPM::Update& update) {
 }
 
 void wipe() {
+	enabled = false;
+	xCPM = xCellPop = xCellTypes = XMLNode();
 	cpm_sampler.reset();
 	celltype_names.clear();
 	celltypes.clear();
 	
 	CellType::storage.wipe();
+	field_statistics.clear();
 	global_update.reset();
 	layer.reset();
 }
@@ -11,6 +11,8 @@
 #include "cell_update.h"
 
 class EdgeTrackerBase;
+class CellFieldStatistics;
+class PDE_Layer;
 
 namespace CPM {
 	
@@ -43,6 +45,8 @@ namespace CPM {
 	
 	/// Set CPM state at @position to be occupied by cell @cell_id
 	bool setNode(VINT position, CELL_ID cell_id);
+	/// Set the nodes of cell @cell_id stored in a binary checkpoint, returns false if there are none
+	bool restoreCheckpointNodes(CELL_ID cell_id);
 
 	/**
 	 * Create an Update encoding the operation described by @sourece, @direction, @opx
@@ -106,16 +110,22 @@ namespace CPM {
 	
 	/// Manually enable edge tracking. Usually this is done automatically.
 	void enableEgdeTracking();
+	/// Enable edge tracking using the compact edge tracker. Replaces any other edge tracker.
+	void enableCompactEdgeTracking();
 	
 	/// Get the current edgeTracker
 	shared_ptr<const EdgeTrackerBase> cellEdgeTracker();
 	
+	/// Per cell sums of @p field, adjusted by every executeCPMUpdate(). Created on the first request and kept until wipe().
+	shared_ptr<CellFieldStatistics> getFieldStatistics(const PDE_Layer* field);
+	
 	/// 
 	bool isSurface(const VINT& pos);
 	uint nSurfaces(const VINT& pos);
 	void setInteractionSurface(bool enabled = true);
 	const Neighborhood& getBoundaryNeighborhood(); /// Returns the Neighborhood of a node boundary, sorted counterclockwise
 	const Neighborhood& getSurfaceNeighborhood(); /// Returns the Neighborhood, that designates a node to be surface node, sorted counterclockwise
+	shared_ptr<const UnionLatticeStencil> getNeighborhoodUnion(); /// Returns the union of all update neighborhoods, gathered once per update
 	
 	/// release all data
 	void wipe();
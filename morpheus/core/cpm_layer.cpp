@@ -5,6 +5,40 @@
 template class Lattice_Data_Layer<CPM::STATE>;
 
 
+UnionLatticeStencil::UnionLatticeStencil(shared_ptr< const CPM::LAYER > data_layer) : valid_data(false), data_layer(data_layer)
+{}
+
+vector<uint> UnionLatticeStencil::addNeighbors(const vector< VINT >& neighbors)
+{
+	vector<uint> indices;
+	int center_index = data_layer->get_data_index(VINT(0,0,0));
+	for (const auto& neighbor : neighbors) {
+		auto it = find(union_neighbors.begin(), union_neighbors.end(), neighbor);
+		if (it == union_neighbors.end()) {
+			union_neighbors.push_back(neighbor);
+			union_offsets.push_back(data_layer->get_data_index(neighbor) - center_index);
+			it = union_neighbors.end()-1;
+		}
+		indices.push_back(it - union_neighbors.begin());
+	}
+	// The buffer is only resized here, never while gathering
+	union_states.resize(union_neighbors.size());
+	valid_data = false;
+	return indices;
+}
+
+void UnionLatticeStencil::applyPos() const
+{
+	assert(data_layer->lattice().inside(pos));
+	const CPM::STATE* center = &data_layer->data[ data_layer->get_data_index(pos) ];
+	const uint union_size = union_offsets.size();
+	for (uint k=0; k<union_size; ++k) {
+		union_states[k] = center[ union_offsets[k] ].cell_id;
+	}
+	valid_data = true;
+}
+
+
 StatisticalLatticeStencil::StatisticalLatticeStencil(std::shared_ptr< const CPM::LAYER > data_layer, const vector< VINT >& neighbors)
 {
 	this->data_layer = data_layer;
@@ -12,11 +46,21 @@ StatisticalLatticeStencil::StatisticalLatticeStencil(std::shared_ptr< const CPM:
 	
 }
 
+StatisticalLatticeStencil::StatisticalLatticeStencil(shared_ptr< UnionLatticeStencil > gather, const vector< VINT >& neighbors)
+{
+	this->data_layer = gather->getLayer();
+	this->gather = gather;
+	setStencil( data_layer->optimizeNeighborhood(neighbors) );
+	gather_indices = gather->addNeighbors(stencil_neighbors);
+}
+
 void StatisticalLatticeStencil::setStencil(const vector< VINT >& neighbors)
 {
 	stencil_neighbors = neighbors;
 	stencil_states.resize(neighbors.size());
 	stencil_offsets.resize(neighbors.size());
+	// there can never be more distinct states than neighbors
+	stencil_statistics.reserve(neighbors.size());
 	int center_index = data_layer->get_data_index(VINT(0,0,0));
 	int last_offset = -10000000;
 	for (uint i=0; i<stencil_neighbors.size(); i++) {
@@ -33,39 +77,41 @@ void StatisticalLatticeStencil::setPosition(const VINT& pos)
 {
 	this->pos = pos;
 	valid_data = false;
+	if (gather) gather->setPosition(pos);
 }
 
 void StatisticalLatticeStencil::applyPos() const
 {
-	stencil_statistics.resize(0);
-	assert(data_layer->lattice().inside(pos));
-	int center_index = data_layer->get_data_index(pos);
-// #ifdef __GNUC__
-// 		for (uint k=0; k<stencil_row_offsets.size(); ++k ) {
-// 			__builtin_prefetch(&data_layer->data[ center_index + stencil_row_offsets[k]],0,1);
-// 		}
-// #endif
 	const uint stencil_offsets_size = stencil_offsets.size();
-	uint stencil_statistics_size = 0;
+	if (gather) {
+		const CPM::CELL_ID* union_states = gather->getStates();
+		for (uint k=0; k<stencil_offsets_size; ++k ) {
+			stencil_states[k] = union_states[ gather_indices[k] ];
+		}
+	}
+	else {
+		assert(data_layer->lattice().inside(pos));
+		int center_index = data_layer->get_data_index(pos);
+		for (uint k=0; k<stencil_offsets_size; ++k ) {
+			stencil_states[k] = data_layer->data[ center_index + stencil_offsets[k] ].cell_id;
+		}
+	}
 	
+	// Capacity is reserved in setStencil(), thus the statistics never reallocate
+	stencil_statistics.clear();
+	uint stencil_statistics_size = 0;
 	for (uint k=0; k<stencil_offsets_size; ++k ) {
-		stencil_states[k] = data_layer->data[ center_index + stencil_offsets[k] ].cell_id;
+		const CPM::CELL_ID state = stencil_states[k];
 		uint stack_id = 0;
-		
-		while(1) {
-			if (stack_id == stencil_statistics_size) {
-				STATS s;
-				s.cell  = stencil_states[k];
-				s.count = 1;
-				stencil_statistics.push_back( s );
-				stencil_statistics_size++;
-				break;
-			}
-			if (stencil_statistics[stack_id].cell == stencil_states[k]) {
-				stencil_statistics[stack_id].count++;
-				break;
-			}
+		while (stack_id < stencil_statistics_size && stencil_statistics[stack_id].cell != state)
 			stack_id++;
+		
+		if (stack_id == stencil_statistics_size) {
+			stencil_statistics.push_back( { state, 1 } );
+			stencil_statistics_size++;
+		}
+		else {
+			stencil_statistics[stack_id].count++;
 		}
 	}
 	valid_data = true;
@@ -78,18 +124,34 @@ LatticeStencil::LatticeStencil(shared_ptr< const CPM::LAYER >  data_layer, const
 	
 }
 
+LatticeStencil::LatticeStencil(shared_ptr< UnionLatticeStencil > gather, const std::vector< VINT >& neighbors )
+{
+	this->data_layer = gather->getLayer();
+	this->gather = gather;
+	setStencil(neighbors);
+	gather_indices = gather->addNeighbors(stencil_neighbors);
+}
+
 void LatticeStencil::setPosition(const VINT& pos)
 {
 	this->pos = pos;
 // 	applyPos();
 	valid_data = false;
+	if (gather) gather->setPosition(pos);
 }
 
 void LatticeStencil::applyPos() const {
-	int center_index = data_layer->get_data_index(pos);
-
-	for (uint i=0; i< stencil_neighbors.size(); i++) {
-		stencil_states[i] = data_layer->data[center_index + stencil_offsets[i] ].cell_id;
+	if (gather) {
+		const CPM::CELL_ID* union_states = gather->getStates();
+		for (uint i=0; i< stencil_neighbors.size(); i++) {
+			stencil_states[i] = union_states[ gather_indices[i] ];
+		}
+	}
+	else {
+		int center_index = data_layer->get_data_index(pos);
+		for (uint i=0; i< stencil_neighbors.size(); i++) {
+			stencil_states[i] = data_layer->data[center_index + stencil_offsets[i] ].cell_id;
+		}
 	}
 	valid_data = true;
 }
@@ -101,10 +163,8 @@ void LatticeStencil::setStencil(const vector< VINT >& neighbors)
 	stencil_states.resize(neighbors.size());
 	stencil_offsets.resize(neighbors.size());
 	int center_index = data_layer->get_data_index(VINT(0,0,0));
-	int last_offset = -10000000;
 	for (uint i=0; i<stencil_neighbors.size(); i++) {
 		int index_offset = data_layer->get_data_index(stencil_neighbors[i]) - center_index;
 		stencil_offsets[i] = index_offset;
 	}
 }
-
@@ -78,6 +78,36 @@ namespace CPM {
 	
 }
 
+/** @brief Gathers the union of several neighborhood stencils in a single pass.
+ *
+ *  Stencils attached to a UnionLatticeStencil read their states from the shared buffer instead of
+ *  accessing the lattice on their own. The buffer is sized when neighbors are registered. Offsets are
+ *  kept in registration order, such that the indices returned by addNeighbors() remain valid when
+ *  further neighbors are registered.
+ */
+class UnionLatticeStencil {
+	public:
+		UnionLatticeStencil( shared_ptr< const CPM::LAYER > data_layer );
+		/// Register @p neighbors and return their indices within the union buffer
+		vector<uint> addNeighbors(const std::vector< VINT >& neighbors);
+		void setPosition(const VINT& pos) { this->pos = pos; valid_data = false; };
+		const VINT& getPosition() const { return pos; };
+		shared_ptr< const CPM::LAYER > getLayer() const { return data_layer; };
+		const vector<VINT>& getStencil() const { return union_neighbors; };
+		/// Cell ids of the union neighborhood, in the order of registration
+		const CPM::CELL_ID* getStates() const { if (!valid_data) applyPos(); return union_states.data(); };
+		
+	private:
+		void applyPos() const;
+		
+		VINT pos;
+		mutable bool valid_data;
+		shared_ptr< const CPM::LAYER > data_layer;
+		vector<VINT> union_neighbors;
+		vector<int> union_offsets;
+		mutable vector<CPM::CELL_ID> union_states;
+};
+
 /** @brief Extracts Information of a Neighborhood in terms of statistics in an efficient way.
 
  *  In particular it provides a CPM::CELL_ID - count statistics and the neighbor states, respecting boundary conditions.
@@ -88,6 +118,8 @@ class StatisticalLatticeStencil  {
 	public:
 		struct STATS { CPM::CELL_ID cell; uint count; };
 		StatisticalLatticeStencil( shared_ptr< const CPM::LAYER > data_layer, const std::vector< VINT >& neighbors );
+		/// Create a stencil that reads its states from the shared @p gather buffer
+		StatisticalLatticeStencil( shared_ptr< UnionLatticeStencil > gather, const std::vector< VINT >& neighbors );
 		void setPosition(const VINT& pos);
 		const vector<VINT>& getStencil() const { return stencil_neighbors; };
 		const vector<StatisticalLatticeStencil::STATS>& getStatistics() const { if (!valid_data) applyPos(); return stencil_statistics; };
@@ -100,6 +132,8 @@ class StatisticalLatticeStencil  {
 		VINT pos;
 		mutable bool valid_data;
 		shared_ptr< const CPM::LAYER > data_layer;
+		shared_ptr< UnionLatticeStencil > gather;
+		vector<uint> gather_indices;
 		vector<VINT> stencil_neighbors;
 		vector<int> stencil_offsets;
 		vector<int> stencil_row_offsets;
@@ -118,6 +152,8 @@ class LatticeStencil {
 	public:
 		
 		LatticeStencil( shared_ptr< const CPM::LAYER > data_layer, const std::vector< VINT >& neighbors );
+		/// Create a stencil that reads its states from the shared @p gather buffer
+		LatticeStencil( shared_ptr< UnionLatticeStencil > gather, const std::vector< VINT >& neighbors );
 		void setPosition(const VINT& pos);
 		const vector<VINT>& getStencil() const { return stencil_neighbors; };
 		const vector<CPM::CELL_ID>& getStates() const { if (!valid_data) applyPos(); return stencil_states; };
@@ -129,6 +165,8 @@ class LatticeStencil {
 		VINT pos;
 		mutable bool valid_data;
 		shared_ptr< const CPM::LAYER > data_layer;
+		shared_ptr< UnionLatticeStencil > gather;
+		vector<uint> gather_indices;
 		vector<VINT> stencil_neighbors;
 		vector<int> stencil_offsets;
 		mutable vector<CPM::CELL_ID> stencil_states;
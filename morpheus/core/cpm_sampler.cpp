@@ -14,6 +14,7 @@ CPMSampler::CPMSampler() :
 	stepper_type.setXMLPath("MonteCarloSampler/stepper");
 	map<string, StepperType> stepper_map;
 	stepper_map["edgelist"] = StepperType::EDGELIST;
+	stepper_map["compact-edgelist"] = StepperType::COMPACT_EDGELIST;
 	stepper_map["random"] = StepperType::RANDOM;
 	stepper_type.setConversionMap(stepper_map);
 	registerPluginParameter(stepper_type);
@@ -56,6 +57,7 @@ void CPMSampler::init(const Scope* scope)
 	}
 	
 	ContinuousProcessPlugin::init(scope);
+	interaction_profile = Profiler::counter("energy", "Interaction");
 	setTimeStep(mcs_duration.get());
 	is_adjustable = false;
 	
@@ -68,6 +70,9 @@ void CPMSampler::init(const Scope* scope)
 	if (stepper_type() == StepperType::EDGELIST) {
 		CPM::enableEgdeTracking();
 	}
+	else if (stepper_type() == StepperType::COMPACT_EDGELIST) {
+		CPM::enableCompactEdgeTracking();
+	}
 	else if (stepper_type() == StepperType::RANDOM) {
 		// That's the default case;
 	}
@@ -81,6 +86,9 @@ void CPMSampler::init(const Scope* scope)
 		throw MorpheusException(string("Metropolis temperature is required to be homogeneous in space."),stored_node.getChildNode("MonteCarloSampler").getChildNode("MetropolisKinetics"));
 	}
 	
+	yield_is_const = metropolis_yield.isConst();
+	const_yield = yield_is_const ? metropolis_yield(SymbolFocus::global) : 0;
+	
 // 	current_update = CPM::createUpdate(); // we also might require a Stencil for the connectivity constraint.
 // 	current_update.boundary = unique_ptr<LatticeStencil> (new LatticeStencil(cell_layer,edge_tracker->getNeighborhood()));
 // 	current_update.interaction = unique_ptr<StatisticalLatticeStencil> (new StatisticalLatticeStencil(cell_layer,interaction_energy->getNeighborhood()));
@@ -125,15 +133,18 @@ const Neighborhood& CPMSampler::getUpdateNeighborhood()
 void CPMSampler::executeTimeStep()
 {
 	MonteCarloStep();
+	if (Profiler::enabled())
+		Profiler::recordMCS(mcs_attempts, mcs_vetoed, mcs_accepted);
+	mcs_attempts = mcs_vetoed = mcs_accepted = 0;
 }
 
 void CPMSampler::MonteCarloStep() 
 {
+	boltzmann.setTemperature(metropolis_temperature.get(SymbolFocus::global));
 	int success=0;
 	assert(edge_tracker != NULL);
 	uint nupdates = edge_tracker->updates_per_mcs();
 	bool is_random = dynamic_pointer_cast<const NoEdgeTracker>(edge_tracker) != nullptr;
-	cached_temp = metropolis_temperature.get(SymbolFocus::global);
 	
 	for (uint i=0; i < nupdates; ++i) {
 		// an update is actually a copy operation of a value at source to position source + direction
@@ -143,17 +154,26 @@ void CPMSampler::MonteCarloStep()
 		edge_tracker->get_update(source_pos, direction);
 		if (is_random)
 			if (cell_layer->get(source_pos) == cell_layer->get(source_pos+direction)) continue;
-		const CPM::Update& current_update = CPM::createUpdate( source_pos, direction, CPM::Update::Operation::Extend);
-
-		if (current_update.focusStateBefore().cell_id == current_update.focusStateAfter().cell_id) continue;
 		
-		// and we check whether the update should take place
-		if ( evalCPMUpdate(current_update) ) {
-			success += CPM::executeCPMUpdate(current_update);
-		}
+		success += tryCPMUpdate(source_pos, direction);
 	}
 }
 
+bool CPMSampler::tryCPMUpdate(const VINT& source, const VINT& direction)
+{
+	const CPM::Update& current_update = CPM::createUpdate( source, direction, CPM::Update::Operation::Extend);
+
+	if (current_update.focusStateBefore().cell_id == current_update.focusStateAfter().cell_id) return false;
+	mcs_attempts++;
+	
+	// and we check whether the update should take place
+	if ( evalCPMUpdate(current_update) && CPM::executeCPMUpdate(current_update) ) {
+		mcs_accepted++;
+		return true;
+	}
+	return false;
+}
+
 bool CPMSampler::evalCPMUpdate(const CPM::Update& update)
 {
 	double dE=0, dInteraction=0, dCell=0;
@@ -162,19 +182,24 @@ bool CPMSampler::evalCPMUpdate(const CPM::Update& update)
 	uint source_ct = update.source().celltype();
 	uint focus_ct =  update.focus().celltype();
 	
+	bool permitted;
 	if ( focus_ct == source_ct ) {
-		if ( ! celltypes[focus_ct] -> check_update(update) )
-			return false;
+		permitted = celltypes[focus_ct] -> check_update(update);
 	}
 	else {
-		if ( ! celltypes[source_ct] -> check_update(update.selectOp(CPM::Update::ADD)) )
-			return false;
-		if ( ! celltypes[focus_ct] -> check_update( update.selectOp(CPM::Update::REMOVE)) )
-			return false;
+		permitted = celltypes[source_ct] -> check_update(update.selectOp(CPM::Update::ADD))
+			&& celltypes[focus_ct] -> check_update( update.selectOp(CPM::Update::REMOVE));
+	}
+	if ( ! permitted ) {
+		mcs_vetoed++;
+		return false;
 	}
 	
 	// InteractionEnergy
-	dInteraction = interaction_energy -> delta(update);
+	{
+		ProfileTimer timer(interaction_profile.get());
+		dInteraction = interaction_energy -> delta(update);
+	}
 	// CellType dependend energies
 	if ( focus_ct == source_ct ) {
 		dCell += celltypes[source_ct] -> delta(update);
@@ -185,16 +210,19 @@ bool CPMSampler::evalCPMUpdate(const CPM::Update& update)
 		// TODO crawl through the neighborhood for CPM::Update::Neighborhood energy changes, if any CPMEnergy requires that
 	}
 	// the magic Metropolis Kinetics with Boltzmann probability ...
-	VDOUBLE dir = update.focus().pos() - update.source().pos();
-	metropolis_yield.setLocals(&dir.x);
-	dE = dInteraction + dCell + metropolis_yield(update.focus()); //metropolis_yield(update.focus);
+	if (yield_is_const) {
+		dE = dInteraction + dCell + const_yield;
+	}
+	else {
+		VDOUBLE dir = update.focus().pos() - update.source().pos();
+		metropolis_yield.setLocals(&dir.x);
+		dE = dInteraction + dCell + metropolis_yield(update.focus()); //metropolis_yield(update.focus);
+	}
 
 	if (dE <= 0)
 		return true;
 	
-	double p = exp(-dE / cached_temp);
 	double rnd = getRandom01();
-
-	return rnd < p;
+	return rnd < boltzmann.probability(dE);
 }
 
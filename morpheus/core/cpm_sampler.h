@@ -18,6 +18,8 @@
 #include "plugin_parameter.h"
 #include "edge_tracker.h"
 #include "interaction_energy.h"
+#include "profiler.h"
+#include "boltzmann_acceptance.h"
 
 /**
 \defgroup ML_CPM CPM
@@ -48,7 +50,7 @@ Acceptance probability
 
 
 \b MonteCarloSampler
-  - \b stepper: \b edgelist chooses updates from a tracked list of lattice sites that can potentially change configuration; \b random sampling chooses a lattice site with uniform random distribution over all lattice sites.
+  - \b stepper: \b edgelist chooses updates from a tracked list of lattice sites that can potentially change configuration; \b random sampling chooses a lattice site with uniform random distribution over all lattice sites; \b compact-edgelist samples like edgelist, but stores the edges as packed lattice indices in a flat hash table. It is a memory saving option for large lattices and runs at about the same speed as edgelist.
   - \b MetropolisKinetics:
     - \b temperature: specifies Boltzmann probability to accept updates that increase energy, required to be homogeneous in space.
     - \b yield: offset for Boltzmann probability distribution representing resistance to membrane deformations (see Kafer, Hogeweg and Maree, PLoS Comp Biol, 2006).
@@ -82,7 +84,7 @@ public:
 	set< SymbolDependency > getInteractionDependencies() const;
 	
 private:
-	enum class StepperType { EDGELIST, RANDOM };
+	enum class StepperType { EDGELIST, COMPACT_EDGELIST, RANDOM };
 	PluginParameter2<double,XMLValueReader,RequiredPolicy> mcs_duration;
 	PluginParameter2<string,XMLValueReader,OptionalPolicy> mcs_duration_symbol;
 	PluginParameter2<StepperType,XMLNamedValueReader,RequiredPolicy> stepper_type;
@@ -94,14 +96,23 @@ private:
 	Neighborhood update_neighborhood;
 	shared_ptr<const EdgeTrackerBase> edge_tracker;
 	shared_ptr<InteractionEnergy> interaction_energy;
+	shared_ptr<ProfileCounter> interaction_profile;
+	/// Copy attempts of the current Monte Carlo step, and how many were vetoed or accepted
+	uint64_t mcs_attempts = 0, mcs_vetoed = 0, mcs_accepted = 0;
 	
 	///  Run one MonteCarloStep, i.e. as many updates as determined by the mcs stepper
 	void MonteCarloStep();
+	/// Evaluate and apply a copy attempt from @p source to @p source + @p direction. Returns true on success.
+	bool tryCPMUpdate(const VINT& source, const VINT& direction);
 	bool evalCPMUpdate(const CPM::Update& update);
 	
 	shared_ptr<const CPM::LAYER> cell_layer;
 	vector <std::shared_ptr <const CellType > > celltypes;
-	mutable double cached_temp;
+	/// Boltzmann acceptance for the current temperature
+	BoltzmannAcceptance boltzmann;
+	/// A constant yield is folded into the energy difference without evaluating the expression
+	bool yield_is_const;
+	double const_yield;
 };
 
 #endif
@@ -4,6 +4,8 @@
 #include "vec.h"
 #include "lattice.h"
 #include "cpm_layer.h"
+#include "node_set.h"
+#include "flat_map.h"
 
 
 /** 
@@ -24,7 +26,13 @@ struct EllipsoidShape{
 class CPMShape
 {
 public:
+#ifdef MORPHEUS_FLAT_NODES
+	typedef FlatNodeSet Nodes;
+#else
 	typedef set<VINT,less_VINT> Nodes;
+#endif
+	/// Interface lengths to the neighboring cells, a cell typically has only a few neighbors
+	typedef FlatMap<CPM::CELL_ID, double> Interfaces;
 	enum class BoundaryScalingMode {Magno, NeigborNumber, None};
 	static double BoundaryLengthScaling(const Neighborhood& neighborhood);
 	static Neighborhood boundaryNeighborhood;
@@ -63,7 +63,7 @@ const CPMShape::Nodes& AdaptiveCPMShapeTracker::surfaceNodes() const
 	return surface_nodes;
 }
 
-const map<CPM::CELL_ID,double>&  AdaptiveCPMShapeTracker::interfaces() const {
+const CPMShape::Interfaces&  AdaptiveCPMShapeTracker::interfaces() const {
 	if (last_interface_update!=n_updates) {
 		if (n_updates - last_interface_update< 5*(10 + _nodes.size())) {
 			tracking.interfaces=true;
@@ -73,6 +73,7 @@ const map<CPM::CELL_ID,double>&  AdaptiveCPMShapeTracker::interfaces() const {
 	}
 	if (! scaled_interfaces_valid) {
 		scaled_interfaces.clear();
+		scaled_interfaces.reserve(_interfaces.size());
 		for (const auto& i : _interfaces) {
 			scaled_interfaces.insert( make_pair(i.first,double(i.second) / boundary_scaling) );
 		}
@@ -235,7 +236,6 @@ void AdaptiveCPMShapeTracker::apply(const CPM::Update& update, AdaptiveCPMShapeT
 				for (; ui != other->_interfaces.end(); ++ui,++i) {
 					if (ui->first == i->first) {
 						i->second = ui->second;
-						++i;
 					}
 					else {
 						brute_force_copy = true;
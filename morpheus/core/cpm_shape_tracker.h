@@ -36,7 +36,7 @@ public:
 	/// Cell surface nodes -- all nodes that have contact via edge or corner to foreign occupied nodes
 	const CPMShape::Nodes& surfaceNodes() const;
 	/// Interface length to other cells / entities
-	const map<CPM::CELL_ID,double>&  interfaces() const;
+	const CPMShape::Interfaces&  interfaces() const;
 	/// Ellipsoid approximation of the cell
 	const EllipsoidShape& ellipsoidApprox() const;
 	/// Approcimation of the cell by a deformed sphere. 
@@ -101,10 +101,10 @@ private:
 	
 	
 	mutable double _interface_length;
-	mutable map<CPM::CELL_ID, int> _interfaces;
+	mutable FlatMap<CPM::CELL_ID, int> _interfaces;
 	mutable int last_interface_update;
 	mutable bool scaled_interfaces_valid;
-	mutable map<CPM::CELL_ID, double> scaled_interfaces;
+	mutable CPMShape::Interfaces scaled_interfaces;
 	
 	mutable EllipsoidShape ellipsoid_approx;
 	mutable valarray<double> Ell_I;
@@ -21,6 +21,9 @@
  * 
  * use the creator method to generate a statistics collector of your choice.
  * Per OMP thread private containers are used. Use getCollapsed to obtain overall statistics
+ * 
+ * For keyed reductions, the number of containers (slots) can be changed by resize() and
+ * partial statistics can be combined by merge().
  */
 
 class DataMapper {
@@ -31,6 +34,10 @@ public:
 	virtual double get(int slot=thread()) = 0;
 	virtual double getCollapsed() = 0;
 	virtual void reset(int slot=thread()) = 0;
+	/// Resize to @p n_slots containers, all being reset
+	virtual void resize(int n_slots) = 0;
+	/// Merge the statistics of slot @p from into slot @p to
+	virtual void merge(int to, int from) = 0;
 	[[deprecated]] virtual DataMapper*  clone()  =0;
 	static shared_ptr<DataMapper> create(Mode mode);
 	static std::map<std::string, DataMapper::Mode> getModeNames();
@@ -39,7 +46,7 @@ public:
 	void setWeightsAreBuckets(bool enabled) { weightsAreBuckets = enabled; };
 	virtual ~DataMapper() {}
 protected:
-	static inline int thread() { return omp_get_thread_num(); }
+	static inline int thread() { return omp_get_thread_index(); }
 	DataMapper() :weightsAreBuckets(false) {};
 	bool weightsAreBuckets;
 	DataMapper::Mode mode;
@@ -56,6 +63,8 @@ public:
 	void addValW(double value, double weight, int slot=thread()) override { sum[slot]+=value*weight; };
 	double get(int slot=thread()) override { return sum[slot]; }
 	void reset(int slot=thread()) override { sum[slot]=0;};
+	void resize(int n_slots) override { sum.assign(n_slots,0); }
+	void merge(int to, int from) override { sum[to]+=sum[from]; }
 	DataMapper*  clone() override { return new DataMapperSum(*this); };
 	double getCollapsed() override { 
 		double csum=0; 
@@ -77,6 +86,8 @@ public:
 	void addValW(double value, double weight, int slot=thread()) override {  sum[slot]+=value*weight; count[slot]+=weight; };
 	double get(int slot=thread()) override { if (count[slot]<=0) return 0;  return sum[slot] / count[slot]; }
 	void reset(int slot=thread()) override { sum[slot]=0; count[slot]=0; };
+	void resize(int n_slots) override { sum.assign(n_slots,0); count.assign(n_slots,0); }
+	void merge(int to, int from) override { sum[to]+=sum[from]; count[to]+=count[from]; }
 	DataMapper*  clone() override { return new DataMapperAverage(*this); };
 	double getCollapsed() override {
 		double csum=0; double ccount=0; 
@@ -101,6 +112,8 @@ public:
 	void addValW(double value, double weight, int slot=thread()) override { sum[slot]+=value * weight; sum_of_squares[slot]+=value*value * weight; count[slot]+=weight; }
 	double get(int slot=thread()) override { if (count[slot]<=0) return 0; return (sum_of_squares[slot]  - sum[slot]*(sum[slot]/count[slot])) / count[slot]; }
 	void reset(int slot=thread()) override { sum[slot]=0; sum_of_squares[slot]=0; count[slot]=0; };
+	void resize(int n_slots) override { sum.assign(n_slots,0); sum_of_squares.assign(n_slots,0); count.assign(n_slots,0); }
+	void merge(int to, int from) override { sum[to]+=sum[from]; sum_of_squares[to]+=sum_of_squares[from]; count[to]+=count[from]; }
 	DataMapper* clone() override { return new DataMapperVariance(*this); };
 	double getCollapsed() override { 
 		double csum=0; double ccount=0; double csum_of_squares=0;
@@ -124,6 +137,8 @@ public:
 	void addValW(double value, double weight, int slot=thread()) override { if (this->weightsAreBuckets) min[slot] = value*weight<min[slot] ? value*weight : min[slot]; else min[slot] = value<min[slot] ? value : min[slot]; }
 	double get(int slot=thread()) override { return min[slot]; }
     void reset(int slot=thread()) override { min[slot] = std::numeric_limits< double >::max(); };
+	void resize(int n_slots) override { min.assign(n_slots,std::numeric_limits< double >::max()); }
+	void merge(int to, int from) override { min[to] = min[from]<min[to] ? min[from] : min[to]; }
 	DataMapper*  clone() override { return new DataMapperMin(*this); };
 	double getCollapsed() override { 
 		double cmin=std::numeric_limits< double >::max();
@@ -146,6 +161,8 @@ public:
 	void addValW(double value, double weight, int slot=thread()) override { if (this->weightsAreBuckets) max[slot] = value*weight>max[slot] ? value*weight : max[slot]; else  max[slot] = value>max[slot] ? value : max[slot]; } 
 	double get(int slot=thread()) override { return max[slot]; }
     void reset(int slot=thread()) override { max[slot] = std::numeric_limits< double >::min(); };
+	void resize(int n_slots) override { max.assign(n_slots,std::numeric_limits< double >::min()); }
+	void merge(int to, int from) override { max[to] = max[from]>max[to] ? max[from] : max[to]; }
 	DataMapper*  clone() override { return new DataMapperMax(*this); };
 	double getCollapsed() override { 
 		double cmax = std::numeric_limits< double >::min();
@@ -174,6 +191,8 @@ public:
 		
 	double get(int slot=thread()) override;
     void reset(int slot=thread()) override { values[slot].clear(); };
+	void resize(int n_slots) override { values.assign(n_slots, map<double,double>()); }
+	void merge(int to, int from) override { for (const auto& v : values[from]) values[to][v.first] += v.second; }
 	DataMapper*  clone() override { return new DataMapperDiscrete(*this); };
 	double getCollapsed() override;
 private:
@@ -194,7 +213,7 @@ public:
 	VectorDataMapper::Mode getMode() const { return mode; }
 	virtual ~VectorDataMapper() {}
 protected:
-	static inline int thread() { return omp_get_thread_num(); }
+	static inline int thread() { return omp_get_thread_index(); }
 	VectorDataMapper(VectorDataMapper::Mode mode) : mode(mode) {};
 private:
 	VectorDataMapper::Mode mode;
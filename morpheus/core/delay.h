@@ -84,7 +84,7 @@ public:
 	double get(const SymbolFocus& f, double time) const {
 		auto p = getCellProperty(f);
 		if (!p->initialized) p->init(f);
-		auto& history = p->value;
+		auto& history = p->value();
 		auto delay = parent->getDelay();
 		clearHistory(history, time);
 		if (time-delay<=SIM::getStartTime()) {
@@ -122,7 +122,7 @@ public:
 		set(f, SIM::getTime(), value);
 	}
 	void set(const SymbolFocus& f, double time, double value) const { 
-		auto& history = getCellProperty(f)->value;
+		auto& history = getCellProperty(f)->value();
 		clearHistory(history,time);
 		if (history.full()) history.set_capacity((history.size()*4)/3);
 		history.push_back({time, value});
@@ -157,7 +157,7 @@ public:
 	double get(const SymbolFocus& f, double time) const {
 		auto delay = parent->getDelay();
 		clearHistory(time);
-		auto& history = property.value;
+		auto& history = property.value();
 		
 		if (time-delay<=SIM::getStartTime()) {
 // 			cout << "Delay ini " << this->name() << " -> {" << time-delay << "," <<  parent->getInitValue(f,time-delay) <<"}" << endl;
@@ -191,7 +191,7 @@ public:
 		set(f, SIM::getTime(), value);
 	}
 	void set(const SymbolFocus&, double time, double value) const {
-		auto& history = property.value;
+		auto& history = property.value();
 		clearHistory(time-parent->getDelay());
 		if (history.full()) history.set_capacity((history.size() * 4)/3);
 		history.push_back({time,value});
@@ -204,7 +204,7 @@ private:
 	mutable DelayProperty property;
 	void clearHistory(double time) const {
 		// auto cleanup
-		while (property.value.size()>1 && (property.value[1].time + max(1.0,0.1*time-parent->getDelay()))<=time-parent->getDelay()) property.value.pop_front();
+		while (property.value().size()>1 && (property.value()[1].time + max(1.0,0.1*time-parent->getDelay()))<=time-parent->getDelay()) property.value().pop_front();
 	}
 	friend class DelayPropertyPlugin;
 };
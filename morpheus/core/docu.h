@@ -453,6 +453,7 @@ This is handy within automated parameter exploration via parameter sweeps.
 
 \b SaveInterval specifies the interval for checkpointing: writing the complete simulation state to a file (xml.gz). 
 Use the special value '-1' to never save simulation state (default) or '0' to save state at end of simulation (either \b StopTime or after fulfilling \b StopCondition).
+With \b format="binary", field data and the cell lattice are written as raw memory blocks to a separate file (.bin) referenced from the xml.gz snapshot, which is much faster to save and restore for large lattices. Both files are required to restart the simulation.
 
 
 \section Example
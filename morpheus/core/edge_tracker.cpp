@@ -378,3 +378,256 @@ string EdgeListTracker::getStatInfo() const {
 	return info.str(); 
 	
 }
+
+
+vector< pair<VINT,VINT> > EdgeListTracker::getEdges() const {
+	vector< pair<VINT,VINT> > edge_nodes;
+	for (const auto& edge : edges) {
+		if (edge.valid)
+			edge_nodes.push_back(make_pair(edge.pos_a, edge.pos_b));
+	}
+	return edge_nodes;
+}
+
+
+const uint64_t CompactEdgeTracker::EdgeTable::empty_key;
+const uint32_t CompactEdgeTracker::EdgeTable::not_found;
+
+void CompactEdgeTracker::EdgeTable::rehash(size_t capacity) {
+	vector<uint64_t> old_keys(capacity, empty_key);
+	vector<uint32_t> old_values(capacity, not_found);
+	swap(old_keys, keys);
+	swap(old_values, values);
+	mask = capacity - 1;
+	shift = 64;
+	while (capacity > 1) { capacity >>= 1; shift--; }
+	
+	n_entries = 0;
+	for (uint i=0; i<old_keys.size(); i++) {
+		if (old_keys[i] != empty_key)
+			insert(old_keys[i], old_values[i]);
+	}
+}
+
+uint32_t CompactEdgeTracker::EdgeTable::find(uint64_t key) const {
+	for (size_t i = slot(key); ; i = (i+1) & mask) {
+		if (keys[i] == key) return values[i];
+		if (keys[i] == empty_key) return not_found;
+	}
+}
+
+void CompactEdgeTracker::EdgeTable::insert(uint64_t key, uint32_t value) {
+	// Keep the load factor below 0.5 to have short probing sequences
+	if (2 * (n_entries+1) > keys.size())
+		rehash(2 * keys.size());
+	size_t i = slot(key);
+	while (keys[i] != empty_key) {
+		assert(keys[i] != key);
+		i = (i+1) & mask;
+	}
+	keys[i] = key;
+	values[i] = value;
+	n_entries++;
+}
+
+void CompactEdgeTracker::EdgeTable::update(uint64_t key, uint32_t value) {
+	for (size_t i = slot(key); ; i = (i+1) & mask) {
+		if (keys[i] == key) { values[i] = value; return; }
+		if (keys[i] == empty_key) throw string("CompactEdgeTracker:: Unable to update unknown edge");
+	}
+}
+
+void CompactEdgeTracker::EdgeTable::erase(uint64_t key) {
+	size_t i = slot(key);
+	while (keys[i] != key) {
+		if (keys[i] == empty_key) return;
+		i = (i+1) & mask;
+	}
+	// Backward shift deletion, which keeps probing sequences intact without tombstones
+	size_t j = i;
+	while (true) {
+		j = (j+1) & mask;
+		if (keys[j] == empty_key) break;
+		size_t home = slot(keys[j]);
+		// Move the entry at j into the hole at i, if its home slot is not within (i,j]
+		if ( (j > i && (home <= i || home > j)) || (j < i && (home <= i && home > j)) ) {
+			keys[i] = keys[j];
+			values[i] = values[j];
+			i = j;
+		}
+	}
+	keys[i] = empty_key;
+	values[i] = not_found;
+	n_entries--;
+}
+
+
+CompactEdgeTracker::CompactEdgeTracker(shared_ptr< const CPM::LAYER >p, const vector<VINT> &opx_nei, const vector<VINT>& surface_nei) :
+	EdgeTrackerBase(p, opx_nei, surface_nei)
+{
+	if (this->opx_neighbors.size() > numeric_limits<uint8_t>::max())
+		throw string("CompactEdgeTracker:: Update neighborhood is too large");
+	
+	l_size = this->lattice->size();
+	if (double(l_size.x) * l_size.y * l_size.z >= numeric_limits<uint32_t>::max())
+		throw string("CompactEdgeTracker:: Lattice is too large");
+	
+	// creating a list of the indices of the neighbors in the opposite direction
+	vector<VINT> other_neighbors(this->opx_neighbors);
+	for (const auto& nei : this->opx_neighbors) {
+		for (uint o_nei = 0; ; o_nei++) {
+			if (o_nei == other_neighbors.size()) {
+				throw string("CompactEdgeTracker:: unsymmetric opx_neighbors !");
+			}
+			if (other_neighbors[o_nei] + nei == VINT(0,0,0) ) {
+				inverse_neighbor.push_back(o_nei);
+				other_neighbors[o_nei]=VINT(0,0,0);
+				break;
+			}
+		}
+	}
+	
+	init_edge_list();
+}
+
+void CompactEdgeTracker::reset() {
+	edges.clear();
+	edge_table.clear();
+	init_edge_list();
+}
+
+uint64_t CompactEdgeTracker::edge_key(uint32_t a, uint dir, const uint32_t* b) const {
+	// Edges between two lattice nodes are keyed from the node with the lower index
+	const uint64_t n_dirs = this->opx_neighbors.size();
+	if (b && ( *b < a || (*b == a && inverse_neighbor[dir] < dir) ))
+		return *b * n_dirs + inverse_neighbor[dir];
+	return a * n_dirs + dir;
+}
+
+void CompactEdgeTracker::set_edge(const VINT& pos, uint dir, bool is_edge) {
+	VINT pos_b = pos + this->opx_neighbors[dir];
+	Boundary::Type bt;
+	uint32_t a = node_index(pos);
+	uint64_t key;
+	uint8_t flags = 0;
+	if ( this->cell_layer->writable_resolve(pos_b, bt) ) {
+		uint32_t b = node_index(pos_b);
+		key = edge_key(a, dir, &b);
+	}
+	else if (bt == Boundary::constant) {
+		// that neighboring node is not writable, but can source new nodes
+		key = edge_key(a, dir, nullptr);
+		flags = FOCUS_FIXED;
+	}
+	else {
+		// noflux boundary, nothing can be copied
+		return;
+	}
+	
+	uint32_t eid = edge_table.find(key);
+	if (is_edge) {
+		if (eid == EdgeTable::not_found) {
+			Edge edge;
+			edge.node = key / this->opx_neighbors.size();
+			edge.direction = key % this->opx_neighbors.size();
+			edge.flags = flags;
+			edge_table.insert(key, edges.size());
+			edges.push_back(edge);
+		}
+	}
+	else if (eid != EdgeTable::not_found) {
+		// swap the last edge into the free slot
+		edge_table.erase(key);
+		if (eid != edges.size()-1) {
+			edges[eid] = edges.back();
+			edge_table.update(uint64_t(edges[eid].node) * this->opx_neighbors.size() + edges[eid].direction, eid);
+		}
+		edges.pop_back();
+	}
+}
+
+void CompactEdgeTracker::init_edge_list() {
+	VINT pos;
+	for (pos.z = 0; pos.z<l_size.z; pos.z++) {
+		for (pos.y = 0; pos.y<l_size.y; pos.y++) {
+			for (pos.x = 0; pos.x<l_size.x; pos.x++) {
+				if ( ! this->cell_layer->writable(pos) )
+					continue;
+				const CPM::CELL_ID cell_a = this->cell_layer->get(pos).cell_id;
+				for (uint neighbor = 0; neighbor < this->opx_neighbors.size(); neighbor++) {
+					if (cell_a != this->cell_layer->get(pos + this->opx_neighbors[neighbor]).cell_id)
+						set_edge(pos, neighbor, true);
+				}
+			}
+		}
+	}
+	cout << "CompactEdgeTracker::init() : Found " << edges.size() << " edges that can be modified." << endl;
+}
+
+void CompactEdgeTracker::get_update(VINT& origin, VINT& direction) const {
+	assert(edges.size() > 0);
+	uint n_try=0;
+	do {
+		const Edge& edge = edges[ getRandomUint( edges.size()-1 ) ];
+		assert(++n_try < 500);
+		if ( getRandomBool() ) {
+			if ( edge.flags & FOCUS_FIXED ) continue; // node b, the focus, is not writable ...
+			origin = node_pos(edge.node);
+			direction = this->opx_neighbors[edge.direction];
+			return;
+		} else {
+			origin = node_pos(edge.node) + this->opx_neighbors[edge.direction];
+			direction = this->opx_neighbors[inverse_neighbor[edge.direction]];
+			return;
+		}
+	} while (1);
+}
+
+void CompactEdgeTracker::update_notifier(const VINT& pos, const LatticeStencil& neighborhood) {
+	VINT pos_a(pos);
+	this->lattice->resolve(pos_a);
+	const CPM::CELL_ID cell_a = this->cell_layer->get(pos_a).cell_id;
+	const vector<CPM::CELL_ID>& states = neighborhood.getStates();
+	for (uint neighbor = 0; neighbor < this->opx_neighbors.size(); neighbor++) {
+		set_edge(pos_a, neighbor, cell_a != states[neighbor]);
+	}
+}
+
+bool CompactEdgeTracker::has_surface(const VINT& pos) const {
+	const CPM::STATE& spin = this->cell_layer->get(pos);
+	for (const auto& offset : this->surface_neighbors) {
+		if (spin != this->cell_layer->get(pos+offset) )
+			return true;
+	}
+	return false;
+}
+
+uint CompactEdgeTracker::n_surfaces(const VINT& pos) const {
+	const CPM::STATE& spin = this->cell_layer->get(pos);
+	uint n_edges=0;
+	for (const auto& offset : this->surface_neighbors) {
+		if (spin != this->cell_layer->get(pos+offset) )
+			n_edges++;
+	}
+	return n_edges;
+}
+
+vector< pair<VINT,VINT> > CompactEdgeTracker::getEdges() const {
+	vector< pair<VINT,VINT> > edge_nodes;
+	edge_nodes.reserve(edges.size());
+	for (const auto& edge : edges) {
+		VINT pos_a = node_pos(edge.node);
+		VINT pos_b = pos_a + this->opx_neighbors[edge.direction];
+		this->lattice->resolve(pos_b);
+		edge_nodes.push_back(make_pair(pos_a, pos_b));
+	}
+	return edge_nodes;
+}
+
+string CompactEdgeTracker::getStatInfo() const {
+	stringstream info;
+	info << "CompactEdgeTracker: EdgeList size " << edges.size() << endl;
+	info << "                    Edge table load " <<  double (edge_table.size()) / edge_table.capacity() << endl;
+	info << "                    Opx Neighborhood is " << this->opx_neighbors.size() << endl;
+	return info.str();
+}
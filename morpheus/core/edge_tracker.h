@@ -162,10 +162,84 @@ public:
 	virtual bool has_surface(const VINT& pos) const;
 	virtual uint n_surfaces(const VINT& pos) const;
 	virtual string getStatInfo() const;
+	/// The tracked edges as pairs of nodes, for validation
+	vector< pair<VINT,VINT> > getEdges() const;
 
 };
 
 
+/**
+ * Edge tracker with a compact memory layout
+ * 
+ * Edges are stored as the linear lattice index of one node plus the direction
+ * towards the other node in a dense edge vector, i.e. 8 bytes per edge.
+ * Edges are looked up via a flat open-addressing table keyed on (node index, direction),
+ * which replaces the per-node edge id lists of the EdgeListTracker and thus
+ * avoids any per-node allocation.
+ * Edge removal swaps the last edge into the free slot, thus there are no invalid
+ * edges to be skipped when selecting an update.
+ */
+class CompactEdgeTracker : public EdgeTrackerBase {
+public:
+	CompactEdgeTracker(shared_ptr< const CPM::LAYER > p, const vector<VINT> &opx_nei, const vector<VINT>& surface_nei);
+	uint updates_per_mcs() const override {
+		return uint( edges.size() * 2.0 / this->opx_neighbors.size() );
+	};
+	void get_update(VINT& origin, VINT& direction) const override;
+	void update_notifier(const VINT& pos, const LatticeStencil& neighborhood) override;
+	void reset() override;
+	
+	bool has_surface(const VINT& pos) const override;
+	uint n_surfaces(const VINT& pos) const override;
+	string getStatInfo() const override;
+	/// The tracked edges as pairs of nodes, for validation
+	vector< pair<VINT,VINT> > getEdges() const;
+	
+private:
+	struct Edge {
+		uint32_t node;  ///< linear lattice index of node a
+		uint8_t direction;  ///< index of the opx neighbor pointing from a to b
+		uint8_t flags;  ///< FOCUS_FIXED if node b is a constant boundary node
+	};
+	static const uint8_t FOCUS_FIXED = 0x1;
+	
+	/// Flat hash table with linear probing, mapping edge keys to edge ids
+	class EdgeTable {
+	public:
+		EdgeTable() : n_entries(0) { rehash(64); };
+		static const uint64_t empty_key = numeric_limits<uint64_t>::max();
+		static const uint32_t not_found = numeric_limits<uint32_t>::max();
+		uint32_t find(uint64_t key) const;
+		void insert(uint64_t key, uint32_t value);
+		void update(uint64_t key, uint32_t value);
+		void erase(uint64_t key);
+		void clear() { keys.clear(); values.clear(); n_entries = 0; rehash(64); };
+		size_t size() const { return n_entries; };
+		size_t capacity() const { return keys.size(); };
+	private:
+		size_t slot(uint64_t key) const { return (key * 0x9E3779B97F4A7C15ull) >> shift; };
+		void rehash(size_t capacity);
+		vector<uint64_t> keys;
+		vector<uint32_t> values;
+		size_t n_entries;
+		size_t mask;
+		uint shift;
+	};
+	
+	vector<Edge> edges;
+	EdgeTable edge_table;
+	vector<uint8_t> inverse_neighbor;
+	VINT l_size;
+	
+	uint32_t node_index(const VINT& pos) const { return pos.x + l_size.x * (pos.y + l_size.y * pos.z); };
+	VINT node_pos(uint32_t index) const { return VINT(index % l_size.x, (index / l_size.x) % l_size.y, index / (l_size.x * l_size.y)); };
+	/// Unique key of the edge from @p a in direction @p dir, @p b is the resolved neighbor or nullptr for boundary nodes
+	uint64_t edge_key(uint32_t a, uint dir, const uint32_t* b) const;
+	/// Add or remove the edge from @p pos in direction @p dir, depending on whether the states differ
+	void set_edge(const VINT& pos, uint dir, bool is_edge);
+	void init_edge_list();
+};
+
 
 #endif // EDGE_LIST
 
@@ -1,4 +1,5 @@
 #include "evaluator_cache.h"
+#include "simulation.h"
 
 EvaluatorCache::NS::NS(string name, const Scope* scope) :
  scope(scope), ns_name(name) {}
@@ -16,14 +17,10 @@ void EvaluatorCache::NS::setFocus(const SymbolFocus& f) const
 {
 	for (const auto& sym : used_symbols) {
 		auto sd = sym.second;
-		if (sd->type == SymbolDesc::DOUBLE) {
-			auto accessor = static_pointer_cast<const SymbolAccessorBase<double>>(sd->sym);
-			sd->valD = accessor->get(f);
-		}
-		else {
-			auto accessor = static_pointer_cast<const SymbolAccessorBase<VDOUBLE>>(sd->sym);
-			sd->valV = accessor->get(f);
-		}
+		if (sd->type == SymbolDesc::DOUBLE)
+			sd->valD = sd->accessorD->get(f);
+		else
+			sd->valV = sd->accessorV->get(f);
 	}
 }
 
@@ -63,6 +60,7 @@ EvaluatorCache::EvaluatorCache(const EvaluatorCache& other)
 	
 	// External variable storage
 	externals = other.externals;
+	has_stamped_externals = other.has_stamped_externals;
 	external_namespaces = other.external_namespaces;
 	
 	// infrastructure for vector symbol expansion
@@ -158,10 +156,14 @@ mu::value_type* EvaluatorCache::registerSymbol_internal(const mu::char_type* sym
 	// From search scope
 	if (search_scope->getAllSymbolNames<double>(allow_partial_spec).count(search_symbol)) {
 		SymbolDesc sd;
-		sd.sym  = search_scope->findSymbol<double>(search_symbol, allow_partial_spec);
+		auto accessor = search_scope->findSymbol<double>(search_symbol, allow_partial_spec);
+		sd.sym  = accessor;
+		sd.accessorD = accessor.get();
 		sd.valD = 0;
 		sd.type = SymbolDesc::DOUBLE;
 		sd.source = ns ? SymbolDesc::NS : SymbolDesc::Ext;
+		sd.stamped = accessor->flags().stamped && accessor->flags().granularity == Granularity::Global;
+		has_stamped_externals |= sd.stamped;
 		auto ext_it = externals.insert({ symbol, sd }).first;
 		if (ns) ns->used_symbols.insert({search_symbol, &ext_it->second});
 		flat_externals.push_back(&ext_it->second);
@@ -174,10 +176,14 @@ mu::value_type* EvaluatorCache::registerSymbol_internal(const mu::char_type* sym
 		if (ext_it == externals.end()) {
 			
 			SymbolDesc sd;
-			sd.sym = search_scope->findSymbol<VDOUBLE>(search_symbol, allow_partial_spec);
+			auto accessor = search_scope->findSymbol<VDOUBLE>(search_symbol, allow_partial_spec);
+			sd.sym = accessor;
+			sd.accessorV = accessor.get();
 			sd.valV = VDOUBLE(0,0,0);
 			sd.type = SymbolDesc::VECTOR;
 			sd.source = ns ? SymbolDesc::NS : SymbolDesc::Ext;
+			sd.stamped = accessor->flags().stamped && accessor->flags().granularity == Granularity::Global;
+			has_stamped_externals |= sd.stamped;
 			ext_it = externals.insert({symbol,sd}).first;
 			flat_externals.push_back(&ext_it->second);
 			if (ns) ns->used_symbols.insert({search_symbol, &ext_it->second});
@@ -335,21 +341,23 @@ void EvaluatorCache::attach(mu::Parser *parser) {
 
 /// Fill the cache with data wrt. @p focus
 void EvaluatorCache::fetch(const SymbolFocus& focus, const bool safe) {
-// 	if (current_focus == focus && current_time = SIM::getTime()) return;
-	for (auto& sym : flat_externals) {
-		
+	// Global stamped symbols are only refetched if they changed since the last fetch
+	const double time = has_stamped_externals ? SIM::getTime() : 0;
+	for (auto sym : flat_externals) {
 		if (sym->source == SymbolDesc::Ext) {
-			if (sym->type == SymbolDesc::DOUBLE) {
-				auto accessor = static_pointer_cast<const SymbolAccessorBase<double> >(sym->sym);
-				sym->valD = safe ? accessor->safe_get(focus) : accessor->get(focus);
-			}
-			else if (sym->type == SymbolDesc::VECTOR) {
-				auto accessor = static_pointer_cast<const SymbolAccessorBase<VDOUBLE> >(sym->sym);
-				sym->valV = safe ? accessor->safe_get(focus) : accessor->get(focus);
+			if (sym->stamped) {
+				auto stamp = sym->sym->stamp();
+				if (!safe && stamp == sym->stamp && time == sym->time)
+					continue;
+				sym->stamp = stamp;
+				sym->time = time;
 			}
+			if (sym->type == SymbolDesc::DOUBLE)
+				sym->valD = safe ? sym->accessorD->safe_get(focus) : sym->accessorD->get(focus);
+			else
+				sym->valV = safe ? sym->accessorV->safe_get(focus) : sym->accessorV->get(focus);
 		}
 	}
-// 	current_focus = focus;
 }
 
 /// A list of used external symbols.
@@ -4,6 +4,7 @@
 #include "scope.h"
 #include "muParser/muParser.h"
 #include <functional>
+#include <limits>
 
 /**
  * \brief Value cache for the Expression evaluators
@@ -159,6 +160,13 @@ protected:
 		enum Type { DOUBLE, VECTOR } type;
 		enum Source {NS, Ext} source;
 		Symbol sym;
+		/// Typed accessors of sym, resolved at registration to keep the fetch free of shared pointer casts
+		const SymbolAccessorBase<double>* accessorD = nullptr;
+		const SymbolAccessorBase<VDOUBLE>* accessorV = nullptr;
+		/// Global symbol with change stamps, the cached value remains valid while stamp and time are unchanged
+		bool stamped = false;
+		uint64_t stamp = 0;
+		double time = std::numeric_limits<double>::quiet_NaN();
 	};
 
 	struct ExpansionDesc {
@@ -210,6 +218,7 @@ protected:
 	// External variable storage
 	map<string, SymbolDesc> externals;
 	vector<SymbolDesc*> flat_externals;
+	bool has_stamped_externals = false;
 	vector< NS > external_namespaces;
 	
 	// infrastructure for vector symbol expansion
@@ -2,6 +2,22 @@
 #include "simulation.h"
 #include "boost/math/special_functions/factorials.hpp"
 
+template <class T>
+bool ExpressionEvaluator<T>::memoLookup() const
+{
+	// Stamps only increase, thus their sum changes whenever any of the dependencies changed
+	uint64_t stamp = 0;
+	for (const auto& sym : memo_symbols)
+		stamp += sym->stamp();
+	double time = SIM::getTime();
+	if (memo_valid && stamp == memo_stamp && time == memo_time)
+		return true;
+	memo_valid = false;
+	memo_stamp = stamp;
+	memo_time = time;
+	return false;
+}
+
 template <>
 int ExpressionEvaluator<double>::expectedNumResults() const { return 1; }
 
@@ -14,6 +30,12 @@ double ExpressionEvaluator<double>::get(const SymbolFocus& focus, bool safe) con
 	if (expr_is_const)
 		return const_val;
 	
+	if (profile)
+		profile->count();
+	
+	if (memo_enabled && memoLookup())
+		return memo_val;
+	
 	if (is_evaluating)
 		throw string("Recursive evaluation of expression '")+this->clean_expression+"'!" ;
 
@@ -47,6 +69,10 @@ double ExpressionEvaluator<double>::get(const SymbolFocus& focus, bool safe) con
 		const_val = value;
 		expr_is_const = true;
 	}
+	if (memo_enabled) {
+		memo_val = value;
+		memo_valid = true;
+	}
 	is_evaluating = false;
 	return value;
 }
@@ -85,6 +111,12 @@ float ExpressionEvaluator<float>::get(const SymbolFocus& focus, bool safe) const
 	if (expr_is_const)
 		return const_val;
 	
+	if (profile)
+		profile->count();
+	
+	if (memo_enabled && memoLookup())
+		return memo_val;
+	
 	if (is_evaluating)
 		throw string("Recursive evaluation of expression '")+this->clean_expression+"'!" ;
 
@@ -113,6 +145,10 @@ float ExpressionEvaluator<float>::get(const SymbolFocus& focus, bool safe) const
 		const_val = value;
 		expr_is_const = true;
 	}
+	if (memo_enabled) {
+		memo_val = value;
+		memo_valid = true;
+	}
 	is_evaluating = false;
 	return value;
 }
@@ -151,6 +187,12 @@ VDOUBLE ExpressionEvaluator<VDOUBLE>::get(const SymbolFocus& focus, bool safe) c
 	if (expr_is_const)
 		return const_val;
 	
+	if (profile)
+		profile->count();
+	
+	if (memo_enabled && memoLookup())
+		return memo_val;
+	
 	if (is_evaluating)
 		throw string("Recursive evaluation of expression '")+this->clean_expression+"'!" ;
 
@@ -204,6 +246,10 @@ VDOUBLE ExpressionEvaluator<VDOUBLE>::get(const SymbolFocus& focus, bool safe) c
 		const_val = value;
 		expr_is_const = true;
 	}
+	if (memo_enabled) {
+		memo_val = value;
+		memo_valid = true;
+	}
 	
 	is_evaluating = false;
 	return value;
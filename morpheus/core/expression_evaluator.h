@@ -16,6 +16,7 @@
 #include "evaluator_cache.h"
 #include "random_functions.h"
 #include "scope.h"
+#include "profiler.h"
 #include <mutex>
 
 unique_ptr<mu::Parser> createMuParserInstance();
@@ -89,6 +90,7 @@ public:
 	/// Set the notation of the Vector expression. Non-Vector types ignore this property.
 	void setNotation(VecNotation notation) {
 		_notation = notation;
+		memo_valid = false;
 		if (initialized && expr_is_const) {
 			delay_const_expr_init = true;
 		}
@@ -106,6 +108,12 @@ public:
 	};
 	/// \brief expressions spatial granularity
 	Granularity getGranularity() const { return flags().granularity; }
+	/// \brief Expression is constant in space and time and does not depend on local variables
+	bool isConst() const {
+		if (!initialized )
+			const_cast<ExpressionEvaluator*>(this)->init();
+		return expr_is_const;
+	}
 
 	/// Description used for graphical visualization and reporting
 	const string& getDescription() const;
@@ -124,6 +132,8 @@ public:
 private:
 	
 	int expectedNumResults() const;
+	/// Check whether the memoized value of a global expression is up to date
+	bool memoLookup() const;
 	
 	const Scope *scope;
 	string expression;
@@ -147,6 +157,16 @@ private:
 	
 	set< SymbolDependency > depend_symbols;
 	
+	// Memoization of global expressions that only depend on stamped symbols, evaluated once per change of the stamps or the time
+	bool memo_enabled = false;
+	vector<Symbol> memo_symbols;
+	mutable bool memo_valid = false;
+	mutable uint64_t memo_stamp = 0;
+	mutable double memo_time = 0;
+	mutable T memo_val;
+	/// Counts the evaluations, if profiling
+	shared_ptr<ProfileCounter> profile;
+	
 	friend class EventSystem;
 	friend class SystemSolver; // Allow the SystemSolver to rewire the parser's function definitions to thread-local instances
 	template <class S>
@@ -205,11 +225,10 @@ public:
 	}
 
 	uint addNameSpaceScope(const string& ns_name, const Scope* scope) {
-		uint id=0;
-		base_evaluator->addNameSpaceScope(ns_name, scope);
+		uint id = base_evaluator->addNameSpaceScope(ns_name, scope);
 		for (auto& evaluator : evaluators)
 			if (evaluator)
-				id = evaluator->addNameSpaceScope(ns_name, scope);
+				evaluator->addNameSpaceScope(ns_name, scope);
 		return id;
 	}
 	set<Symbol> getNameSpaceUsedSymbols(uint ns_id) const { return base_evaluator->getNameSpaceUsedSymbols(ns_id); }
@@ -232,6 +251,7 @@ public:
 	const string& getDescription() const { return base_evaluator->getDescription(); };
 	const SymbolBase::Flags& flags() const { return base_evaluator->flags(); }
 	Granularity getGranularity() const { return base_evaluator->getGranularity(); };
+	bool isConst() const { return base_evaluator->isConst(); };
 	const string& getExpression() const { return base_evaluator->getExpression(); };
 
 	typename TypeInfo<T>::SReturn get(const SymbolFocus& focus) const { return getEvaluator()->get(focus); };
@@ -239,7 +259,7 @@ public:
 	set<SymbolDependency> getDependSymbols() const { return base_evaluator->getDependSymbols(); };
 private:
 	ExpressionEvaluator<T>* getEvaluator() const {
-		uint t = omp_get_thread_num();
+		uint t = omp_get_thread_index();
 		if (/*evaluators.size()<=t || */! evaluators[t] ) {
 // 			mutex.lock();
 // 			auto n_threads = omp_get_max_threads();
@@ -318,6 +338,9 @@ ExpressionEvaluator<T>::ExpressionEvaluator(const ExpressionEvaluator<T> & other
 	expr_flags = other.expr_flags;
 	expand_scalar_expr = other.expand_scalar_expr;
 	depend_symbols = other.depend_symbols;
+	memo_enabled = other.memo_enabled;
+	memo_symbols = other.memo_symbols;
+	profile = other.profile;
 	is_evaluating = false;
 	
 	
@@ -453,10 +476,12 @@ void ExpressionEvaluator<T>::init()
 	volatile_functions.insert(sym_RandomGamma);
 	volatile_functions.insert(sym_RandomNorm);
 	set<string> const_functions;
+	set<string> scope_functions;
 	
 // 	auto scope_symbols = scope->getAllSymbols<double>();
 	for (const auto& symbol :scope_symbols) {
 		if (symbol->flags().function) {
+			scope_functions.insert(symbol->name());
 			if (symbol->flags().stochastic) {
 				volatile_functions.insert(symbol->name());
 			}
@@ -466,18 +491,33 @@ void ExpressionEvaluator<T>::init()
 		}
 	}
 	
+	bool pure_functions = true;
 	for ( auto fun : parser->GetUsedFun()) {
 		if (volatile_functions.count(fun)) {
 			expr_flags.space_const = expr_flags.time_const = false;
 			expr_flags.stochastic = true;
+			pure_functions = false;
 		}
 		else if (const_functions.count(fun)==0) {
 			expr_flags.space_const = expr_flags.time_const = false;
+			if (scope_functions.count(fun))
+				pure_functions = false;
 		}
 	}
 	
 	expr_is_const = expr_flags.time_const && expr_flags.space_const && desc.loc_symbols.empty();
 	
+	// Global expressions only depending on stamped symbols are memoized, i.e. evaluated once per time step instead of once per element
+	memo_enabled = ! expr_is_const && pure_functions && desc.loc_symbols.empty() && ! depend_symbols.empty() && expr_flags.granularity == Granularity::Global;
+	for ( const auto& symb : depend_symbols) {
+		if ( ! symb->flags().stamped || symb->flags().granularity != Granularity::Global)
+			memo_enabled = false;
+	}
+	memo_symbols.clear();
+	if (memo_enabled)
+		memo_symbols.assign(depend_symbols.begin(), depend_symbols.end());
+	memo_valid = false;
+	
 	if (parser->GetNumResults() == 1 && expectedNumResults() > 1) {
 		if ( !  desc.requires_expansion )
 			throw string("Refuse to expand scalar expression ") + clean_expression + " to vector. Require at least one vector symbol";
@@ -488,6 +528,7 @@ void ExpressionEvaluator<T>::init()
 		expand_scalar_expr = false;
 	}
 	
+	profile = Profiler::counter("expression", clean_expression);
 	initialized = true;
 	
 	// update and collect data
@@ -519,6 +560,7 @@ void ExpressionEvaluator<T>::init()
 		// cast the symbol into a typed SymbolAccessor
 		symbol_val = dynamic_pointer_cast< const SymbolAccessorBase<T> >(*depend_symbols.begin());
 		expr_flags.integer = symbol_val->flags().integer;
+		memo_enabled = false;
 		cout << "Expression " << this->getExpression() << " is a symbol" << endl;
 
 	}
@@ -10,11 +10,13 @@
 //
 //
 #include "field.h"
+#include "checkpoint.h"
 
 #include "lattice_data_layer.cpp"
 // #include "expression_evaluator.h"
 #include "focusrange.h"
 #include "diffusion.h"
+#include "field_kernels.h"
 #include <valarray>
 
 REGISTER_PLUGIN(Field);
@@ -102,6 +104,10 @@ PDE_Layer::PDE_Layer(shared_ptr<const Lattice> l, double p_node_length, bool sur
 	is_surface = surface;
 	init_by_restore = false;
 	initialized = false;
+	diffusion_solver = DiffusionSolver::Explicit;
+	adi_reverse_sweep = false;
+	multigrid_alpha = 0;
+	sync_cell_statistics = false;
 	
 	useBuffer(true);
 }
@@ -138,7 +144,24 @@ void PDE_Layer::loadFromXML(const XMLNode xNode, const Scope* scope)
 		exit(-1);
 	}
 
+	string solver_name;
+	getXMLAttribute(xNode,"Diffusion/solver", solver_name);
+	if (solver_name == "adi")
+		diffusion_solver = DiffusionSolver::ADI;
+	else if (solver_name == "multigrid")
+		diffusion_solver = DiffusionSolver::Multigrid;
+	else if ( ! solver_name.empty() && solver_name != "explicit")
+		throw MorpheusException(string("Unknown diffusion solver ") + solver_name + ". Valid solvers are explicit, adi, multigrid", xNode);
+	
+	if (diffusion_solver != DiffusionSolver::Explicit) {
+		if (is_surface || has_reduction || ! (structure == Lattice::linear || structure == Lattice::square || structure == Lattice::cubic))
+			throw MorpheusException("Implicit diffusion solvers require a linear, square or cubic lattice without reduction", xNode);
+	}
+
 	getXMLAttribute(xNode, "time-step", max_time_step);
+	// Implicit solvers impose no stability limit, a field not coupled to any other process would never be advanced
+	if (diffusion_solver != DiffusionSolver::Explicit && diffusion_rate > 0 && max_time_step <= 0)
+		throw MorpheusException("Implicit diffusion solvers require a positive time-step of the Field", xNode);
 
 	getXMLAttribute(xNode,"value", initial_expression);
 	string symbol_name;
@@ -177,7 +200,8 @@ void PDE_Layer::loadFromXML(const XMLNode xNode, const Scope* scope)
 		}
 	}
 
-	if ( diffusion_rate>0 ) {
+	// Implicit solvers are unconditionally stable, the time step is bound by the user and the coupled processes
+	if ( diffusion_rate>0 && diffusion_solver == DiffusionSolver::Explicit) {
 		// forward euler diffusion stability condition
 // 		 alpha = (diffusion_rate * time_interval) / sqr(node_length)* getLattice() -> getNeighborhood(1).size();
 		max_time_step = 0.75 * sqr(node_length)/(lattice().getNeighborhoodByOrder(1).size() * diffusion_rate);
@@ -186,6 +210,13 @@ void PDE_Layer::loadFromXML(const XMLNode xNode, const Scope* scope)
 
 const string PDE_Layer::getXMLPath() { return ::getXMLPath(stored_node); }
 
+CellFieldStatistics& PDE_Layer::cellStatistics()
+{
+	if (!cell_statistics)
+		cell_statistics = CPM::getFieldStatistics(this);
+	return *cell_statistics;
+}
+
 void PDE_Layer::init(const SymbolFocus& focus)
 {
 	if (initialized) return;
@@ -268,6 +299,10 @@ XMLNode PDE_Layer::storeData(string filename) const
 		Lattice_Data_Layer< double >::storeData(out);
 		out.close();
 	}
+	else if (Checkpoint::Writer::current()) {
+		valarray<double> data = getData();
+		xNode = Checkpoint::Writer::current()->write(&data[0], data.size() * sizeof(double), sizeof(double));
+	}
 	else {
 		XMLParserBase64Tool encoder;
 		valarray<double> data = getData();
@@ -287,7 +322,13 @@ bool PDE_Layer::restoreData(const XMLNode node)
 {
 // 	try {
 		string filename;
-		if (getXMLAttribute(node, "filename",filename)) {
+		if (Checkpoint::isBinary(node)) {
+			valarray<double> raw_data(l_size.x * l_size.y * l_size.z);
+			Checkpoint::read(node, &raw_data[0], raw_data.size() * sizeof(double));
+			setData(raw_data);
+			init_by_restore = true;
+		}
+		else if (getXMLAttribute(node, "filename",filename)) {
 			ifstream in(filename.c_str());
 			if (!in.is_open())
 				throw string("Unable to open file: ") + filename;
@@ -334,6 +375,7 @@ bool PDE_Layer::restoreData(const XMLNode node)
 void PDE_Layer::doDiffusion(double delta_t){
 
 	if( wellmixed ){
+		touchValues();
 		double average_concentration = mean();
 		if (using_domain) {
 			for (uint i=0; i<shadow_size_size_xyz; i++) {
@@ -348,35 +390,17 @@ void PDE_Layer::doDiffusion(double delta_t){
 
 // do the diffusion
 	if (diffusion_rate != 0) {
-
-		//cout << "BoundaryConditions:: x = " << get_boundary_type("x") << " and y = " << get_boundary_type("y") << endl;
-
-// 		if(  lattice->getDimensions() == 2 and get_boundary_type(Lattice::b_x) == Lattice::constant && get_boundary_type(Lattice::b_y) == Lattice::constant){
-// // 			cout << "running ADI ";
-// 			// some algorithm to automatically refine the time steps if necessary
-// 			double solved_time  = 0;
-// 			double partial_delta_t = delta_t;
-// 			while (solved_time < delta_t) {
-// 				if (solved_time > 0.0) // ADI step depends on intermediate result
-// 					swap(data, write_buffer);
-// 				if ( ! solve_adi_diffusion(partial_delta_t)) {
-// // 					cout << "refining" << partial_delta_t << "s" << endl;
-// 					partial_delta_t  = partial_delta_t / 2;
-// 				} else {
-// // 					cout << "+";
-// 					solved_time += partial_delta_t;
-// 					partial_delta_t  = min(delta_t - solved_time, partial_delta_t*2);
-// 				}
-// 			}
-// 		} else { // else assume periodic boundary conditions ?!?!
-
-			// some algorithm to automatically refine the time steps if necessary
-			double solved_time  = 0;
-			double partial_delta_t = delta_t;
-
-			typedef bool (PDE_Layer::*SolverMethod)(double) ; 
-			SolverMethod solver;
-			
+		touchValues();
+		typedef bool (PDE_Layer::*SolverMethod)(double) ; 
+		SolverMethod solver;
+		uint n_substeps = 1;
+		uint wavefront_depth = 1;
+		
+		if (diffusion_solver == DiffusionSolver::ADI)
+			solver = & PDE_Layer::solve_adi_diffusion;
+		else if (diffusion_solver == DiffusionSolver::Multigrid)
+			solver = & PDE_Layer::solve_multigrid_diffusion;
+		else {
 			if (is_surface && dimensions==2)
 				solver = & PDE_Layer::solve_fwd_euler_diffusion_spheric;
 			else if (using_domain) {
@@ -385,23 +409,38 @@ void PDE_Layer::doDiffusion(double delta_t){
 			else 
 				solver = & PDE_Layer::solve_fwd_euler_diffusion;
 			
-			while (solved_time < delta_t) {
-// 				if (solved_time > 0.0) // euler step depends on intermediate result
-// 					data = write_buffer;
-// 					swap(data, write_buffer);
-				if ((this->*solver)(partial_delta_t)) {
-// 				if (solve_fwd_euler_diffusion_generalized(partial_delta_t)) {
-					// Apply the discrete interpolation step be forwarding time
-					// and setting the state real from the buffer.
-					// Diffusion does not follow the compute/apply discrimination of other time steppers since all symbols are independent.
-					// This will alse readjust all the boundary values.
-					solved_time += partial_delta_t;
-				} else {
-					// Refine the step width in order to not break the stability criterion
-					partial_delta_t  = partial_delta_t / 2;
-				}
+			// Number of sub steps required by the stability criterion, such that the sub step is strictly below the limit
+			n_substeps = uint(floor(delta_t / getStableTimeStep())) + 1;
+			// Several sub steps may be advanced at once by a cache blocked wavefront
+			wavefront_depth = wavefrontApplicable() ? FieldKernels::wavefrontDepth(l_size) : 1;
+		}
+		double partial_delta_t = delta_t / n_substeps;
+		// Tracked per cell sums are re-synchronized within the last sub step of the plain forward euler solver
+		bool fused_cell_sync = cell_statistics && solver == & PDE_Layer::solve_fwd_euler_diffusion;
+		
+		while (n_substeps > 0) {
+			uint n_steps = min(n_substeps, wavefront_depth);
+			if (fused_cell_sync && n_steps == n_substeps && n_steps > 1)
+				n_steps--;
+			sync_cell_statistics = fused_cell_sync && n_steps == n_substeps;
+			if (sync_cell_statistics)
+				cell_statistics->beginSync();
+			bool solved = (n_steps > 1) ? solve_fwd_euler_diffusion_wavefront(partial_delta_t, n_steps) : (this->*solver)(partial_delta_t);
+			if (solved && sync_cell_statistics)
+				cell_statistics->endSync();
+			sync_cell_statistics = false;
+			if (solved) {
+				// Apply the discrete interpolation step be forwarding time
+				// and setting the state real from the buffer.
+				// Diffusion does not follow the compute/apply discrimination of other time steppers since all symbols are independent.
+				// This will alse readjust all the boundary values.
+				n_substeps -= n_steps;
+			} else {
+				// Rounding right at the stability limit or no convergence, refine the step width
+				n_substeps *= 2;
+				partial_delta_t  = partial_delta_t / 2;
 			}
-// 		}
+		}
 	}
 }
 
@@ -411,112 +450,231 @@ double PDE_Layer::getMaxTimeStep() {
 
 };
 
-
-bool PDE_Layer::solve_adi_diffusion(double time_interval)
+double PDE_Layer::getStableTimeStep() const
 {
-	value_type alpha  = (diffusion_rate * time_interval) / sqr(node_length);
-// 	cout << "alpha "  << alpha << endl;
-// 	Lattice::Boundary_Type b_mx = get_boundary_type(Boundary::mx);
-// 	Lattice::Boundary_Type b_my = get_boundary_type(Lattice::b_my);
-// 	Lattice::Boundary_Type b_mz = get_boundary_type(Lattice::b_mz);
-// 
-// 	Lattice::Boundary_Type b_px = get_boundary_type(Lattice::b_px);
-// 	Lattice::Boundary_Type b_py = get_boundary_type(Lattice::b_py);
-// 	Lattice::Boundary_Type b_pz = get_boundary_type(Lattice::b_pz);
-
-	// explicit in the first coordinate (y) and implicit in the second one (x)
-	valarray<value_type> b(l_size.x); // independent term of the system
-	valarray<value_type> r(l_size.x); // temporary storage for solver results
-	valarray<value_type> d1(-alpha,l_size.x); //
-	valarray<value_type> d2(1+2*alpha,l_size.x);
-
-	// We assume row aligned arrays. If not, one could switch to VINT index(i,j,0) * offset for indexing
-	for ( int j=0; j < l_size.y; j++) {
-		if (j==0) {
-			if (boundary_types[Boundary::my] == Boundary::constant) {
-				value_type cy = this->get(VINT(0,-1,0));
-				for ( int i=0; i< l_size.x; i++) {
-					b[i] = alpha * cy+(1-2*alpha)*data[j * shadow_offset.y +i]+alpha*data[(j+1)*shadow_offset.y+i];
-				}
-			} else {
-				for ( int i=0; i< l_size.x; i++) {
-					b[i] = (1-alpha)*data[j * shadow_offset.y +i]+alpha*data[(j+1)*shadow_offset.y+i];
-				}
-			}
+	// diffusion coefficient alpha of a unit time step
+	const double alpha_unit = diffusion_rate / sqr(node_length);
+	
+	if (is_surface && dimensions==2) {
+		return 1.0 / (4 * alpha_unit * _lattice->getNeighborhoodByOrder(1).size());
+	}
+	else if (using_domain) {
+		vector<VINT> neighbors = _lattice->getNeighborhoodByOrder(1).neighbors();
+		double alpha_total = 0;
+		for (const auto& neighbor : neighbors) {
+			alpha_total += alpha_unit * 2.0 * _lattice->getDimensions() / neighbors.size() / sqr(_lattice->to_orth(neighbor).abs());
+		}
+		return 0.8 / alpha_total;
+	}
+	else {
+		// The critical beta of solve_fwd_euler_diffusion() is 0.2
+		switch (structure) {
+			case Lattice::linear: return 0.4 / alpha_unit;
+			case Lattice::square: 
+			case Lattice::hexagonal: return 0.2 / alpha_unit;
+			case Lattice::cubic: return 0.8 / 6 / alpha_unit;
+			default: return 0.8 / 6 / alpha_unit;
 		}
-		else if (j==l_size.y-1) {
-			if (boundary_types[Boundary::py] == Boundary::constant) {
-				value_type cy = this->get(VINT(0, l_size.y, 0));
-				for ( int i=0; i< l_size.x; i++) {
-					b[i] = alpha * data[(j-1)*shadow_offset.y + i] + (1-2*alpha)*data[j * shadow_offset.y +i] + alpha*cy;
+	}
+}
+
+bool PDE_Layer::wavefrontApplicable() const
+{
+	return structure == Lattice::cubic && !using_domain && !is_surface && !has_reduction
+		&& boundary_types[Boundary::mz] != Boundary::periodic && boundary_types[Boundary::pz] != Boundary::periodic
+		&& shadow_width == VINT(1,1,1);
+}
+
+bool PDE_Layer::solve_fwd_euler_diffusion_wavefront(double time_interval, uint n_steps)
+{
+	double alpha = (diffusion_rate * time_interval) / sqr(node_length);
+	double beta = (1.0-6*alpha);
+	// numerical stability criterion, same as solve_fwd_euler_diffusion()
+	const double beta_critical = 0.2;
+	if (beta <= beta_critical) return false;
+	
+	set_fwd_euler_diffusion_boundaries();
+	FieldKernels::diffusionCubicWavefront(&data[0], &write_buffer[0], l_size, alpha, beta, n_steps, &boundary_types[0], wavefront_workspace);
+	swapBuffer();
+	return true;
+}
+
+
+namespace {
+	/// Component @p d of @p v
+	inline int& axis(VINT& v, uint d) { return d==0 ? v.x : (d==1 ? v.y : v.z); }
+	inline int axis(const VINT& v, uint d) { return d==0 ? v.x : (d==1 ? v.y : v.z); }
+}
+
+void PDE_Layer::setup_implicit_links()
+{
+	using ImplicitDiffusion::Link;
+	const size_t n_nodes = size_t(l_size.x) * l_size.y * l_size.z;
+	if (implicit_links.size() == n_nodes)
+		return;
+	implicit_links.resize(n_nodes);
+	
+#pragma omp parallel for
+	for (int row=0; row<l_size.y*l_size.z; row++) {
+		for (int x=0; x<l_size.x; x++) {
+			const VINT pos(x, row % l_size.y, row / l_size.y);
+			ImplicitDiffusion::Links& links = implicit_links[implicit_index(pos)];
+			links.fill(Link::None);
+			// nodes outside of the domain keep their value
+			if (using_domain && domain[get_data_index(pos)] != Boundary::none)
+				continue;
+			
+			for (uint k=0; k<2*dimensions; k++) {
+				const uint d = k/2;
+				VINT neighbor = pos;
+				axis(neighbor,d) += (k%2) ? 1 : -1;
+				if (axis(neighbor,d) < 0 || axis(neighbor,d) >= axis(l_size,d)) {
+					if (boundary_types[k] != Boundary::periodic) {
+						links[k] = (boundary_types[k] == Boundary::noflux) ? Link::None : Link::Fixed;
+						continue;
+					}
+					// a periodic node would be coupled to itself
+					if (axis(l_size,d) == 1)
+						continue;
+					axis(neighbor,d) = (axis(neighbor,d) + axis(l_size,d)) % axis(l_size,d);
 				}
-			} else {
-				for ( int i=0; i< l_size.x; i++) {
-					b[i] = alpha * data[(j-1)*shadow_offset.y + i] + (1-alpha)*data[j * shadow_offset.y +i];
+				if (using_domain) {
+					const Boundary::Type type = domain[get_data_index(neighbor)];
+					links[k] = (type == Boundary::none) ? Link::Coupled : (type == Boundary::noflux ? Link::None : Link::Fixed);
 				}
+				else
+					links[k] = Link::Coupled;
 			}
 		}
-		else {
-			for ( int i=0; i< l_size.x; i++) {
-				b[i] = alpha * data[(j-1)*shadow_offset.y + i]+(1-2*alpha)*data[j * shadow_offset.y +i]+alpha*data[(j+1)*shadow_offset.y+i];
-			}
-		}
-		if (b.min() < 0.0) {
-			cout << "neg fwd euler in ADI: " << b.min()  << " at y=" << j << endl;
-			return false;
-		}
-		// solving the tridiagonal system
-		tridiag_solver(d1,d2,d1,b,r); // result is stored in r;
-		write_buffer[slice(j * shadow_offset.y, l_size.x,1)] = r;
 	}
+}
 
-	b.resize(l_size.y); // independent term of the system
-	r.resize(l_size.y);
-	d1.resize(l_size.y, -alpha);
-	d2.resize(l_size.y, 1+2*alpha);
-// we save another matrix if we temporarily store some values  in b_save
-	valarray<value_type> b_save(l_size.y);
-
-	// implicit in the first coordinate (y) and explicit in the second one (x)
-	for (int i=0; i<l_size.x; i++) {
-		if (i==0) {
-			if ( boundary_types[Boundary::mx] == Boundary::constant) {
-				value_type cx  = this->get(VINT(-1,0,0));
-				for (int j=0; j<l_size.y; j++) {
-					b[j] = alpha*cx + (1-2*alpha)*write_buffer[j*shadow_offset.y+i] + alpha*write_buffer[j*shadow_offset.y+i+1];
+bool PDE_Layer::solve_adi_diffusion(double time_interval)
+{
+	using ImplicitDiffusion::Link;
+	const double alpha = (diffusion_rate * time_interval) / sqr(node_length);
+	setup_implicit_links();
+	// provides the constant boundary values in the shadow
+	reset_boundaries();
+	
+	const VINT compact_offset(1, l_size.x, l_size.x * l_size.y);
+	// Implicit euler sweeps along one axis after another (locally one-dimensional splitting).
+	// The order of the axes is reversed every step to balance the splitting error.
+	for (uint s=0; s<dimensions; s++) {
+		const uint d = adi_reverse_sweep ? dimensions-1-s : s;
+		const valarray<double>& src = (s==0) ? data : write_buffer;
+		const int n = axis(l_size,d);
+		const int stride = axis(shadow_offset,d);
+		const size_t compact_stride = axis(compact_offset,d);
+		// Lines along y and z are solved for a whole x row at once, which keeps memory access contiguous
+		const int width = (d==0) ? 1 : l_size.x;
+		VINT batches = l_size;
+		axis(batches,d) = 1;
+		batches.x /= width;
+		const int n_batches = batches.x * batches.y * batches.z;
+		
+#pragma omp parallel
+		{
+			vector<double> lower(n*width), diag(n*width), upper(n*width), x(n*width), work;
+#pragma omp for schedule(static)
+			for (int l=0; l<n_batches; l++) {
+				const VINT start(l % batches.x, (l / batches.x) % batches.y, l / (batches.x * batches.y));
+				const int first = get_data_index(start);
+				const size_t first_compact = implicit_index(start);
+				for (int i=0; i<n; i++) {
+					for (int w=0; w<width; w++) {
+						const int idx = first + i * stride + w;
+						const int k = i * width + w;
+						const ImplicitDiffusion::Links& links = implicit_links[first_compact + i * compact_stride + w];
+						lower[k] = upper[k] = 0;
+						diag[k] = 1;
+						x[k] = src[idx];
+						// couplings at the line ends are the cyclic corners of periodic boundaries
+						if (links[2*d] == Link::Coupled) { lower[k] = -alpha; diag[k] += alpha; }
+						else if (links[2*d] == Link::Fixed) { diag[k] += alpha; x[k] += alpha * data[idx - stride]; }
+						if (links[2*d+1] == Link::Coupled) { upper[k] = -alpha; diag[k] += alpha; }
+						else if (links[2*d+1] == Link::Fixed) { diag[k] += alpha; x[k] += alpha * data[idx + stride]; }
+					}
 				}
-		} else {
-				for (int j=0; j<l_size.y; j++) {
-					b[j] = (1-alpha)*write_buffer[j*shadow_offset.y+i] + alpha*write_buffer[j*shadow_offset.y+i+1];
+				ImplicitDiffusion::solveTridiagonal(lower, diag, upper, x, width, work);
+				for (int i=0; i<n; i++) {
+					for (int w=0; w<width; w++) {
+						write_buffer[first + i * stride + w] = x[i * width + w];
+					}
 				}
 			}
 		}
-		else if (i==l_size.x-1) {
-			if (boundary_types[Boundary::px] == Boundary::constant) {
-				value_type cx  = this->get(VINT(l_size.x,0,0));
-				for (int j=0; j<l_size.y; j++) {
-						b[j] = alpha*b_save[j] + (1-2*alpha)*write_buffer[j*shadow_offset.y+i] + alpha*cx;
-				}
-			} else {
-				for (int j=0; j<l_size.y; j++) {
-					b[j] = alpha*b_save[j] + (1-alpha)*write_buffer[j*shadow_offset.y+i];
-				}
+	}
+	adi_reverse_sweep = ! adi_reverse_sweep;
+	swapBuffer();
+	return true;
+}
+
+bool PDE_Layer::solve_multigrid_diffusion(double time_interval)
+{
+	using ImplicitDiffusion::Link;
+	const double alpha = (diffusion_rate * time_interval) / sqr(node_length);
+	const double tolerance = 1e-10;
+	const uint max_iterations = 100;
+	setup_implicit_links();
+	// provides the constant boundary values in the shadow
+	reset_boundaries();
+	const size_t n_nodes = implicit_links.size();
+	
+	// The operator (I - alpha L) only changes with the time step
+	if ( ! multigrid || multigrid_alpha != alpha) {
+		ImplicitDiffusion::Stencil stencil(l_size, dimensions);
+		for (size_t i=0; i<n_nodes; i++) {
+			stencil.diag[i] = 1;
+			for (uint k=0; k<2*dimensions; k++) {
+				if (implicit_links[i][k] != Link::None)
+					stencil.diag[i] += alpha;
+				if (implicit_links[i][k] == Link::Coupled)
+					stencil.coupling[k][i] = alpha;
 			}
 		}
-		else {
-			for (int j=0; j<l_size.y; j++) {
-				b[j] = alpha*b_save[j] + (1-2*alpha)*write_buffer[j*shadow_offset.y+i] + alpha*write_buffer[j*shadow_offset.y+i+1];
+		multigrid = make_shared<ImplicitDiffusion::Multigrid>(std::move(stencil));
+		multigrid_alpha = alpha;
+	}
+	
+	int offsets[Boundary::nCodes];
+	for (uint k=0; k<Boundary::nCodes; k++) {
+		offsets[k] = ((k%2) ? 1 : -1) * axis(shadow_offset, k/2);
+	}
+	
+	multigrid_rhs.resize(n_nodes);
+	multigrid_solution.resize(n_nodes);
+#pragma omp parallel for
+	for (int row=0; row<l_size.y*l_size.z; row++) {
+		const int first = get_data_index(VINT(0, row % l_size.y, row / l_size.y));
+		const size_t first_compact = size_t(row) * l_size.x;
+		for (int x=0; x<l_size.x; x++) {
+			const int idx = first + x;
+			const ImplicitDiffusion::Links& links = implicit_links[first_compact + x];
+			double b = data[idx];
+			for (uint k=0; k<2*dimensions; k++) {
+				if (links[k] == Link::Fixed)
+					b += alpha * data[idx + offsets[k]];
 			}
+			multigrid_rhs[first_compact + x] = b;
+			multigrid_solution[first_compact + x] = data[idx];
 		}
-		if (b.min() < 0.0) {
-			cout << "neg fwd euler in ADI: " << b.min()  << " at x=" << i << endl;
-			return false;
+	}
+	
+	if ( ! multigrid->solve(multigrid_rhs, multigrid_solution, tolerance, max_iterations)) {
+		cout << "PDE_Layer: Multigrid diffusion solver did not converge within " << max_iterations << " iterations, refining the time step" << endl;
+		return false;
+	}
+	
+#pragma omp parallel for
+	for (int row=0; row<l_size.y*l_size.z; row++) {
+		const int first = get_data_index(VINT(0, row % l_size.y, row / l_size.y));
+		const size_t first_compact = size_t(row) * l_size.x;
+		for (int x=0; x<l_size.x; x++) {
+			write_buffer[first + x] = multigrid_solution[first_compact + x];
 		}
-		tridiag_solver(d1,d2,d1,b,r); // result is stored in r;
-
-		b_save = write_buffer[slice(i ,l_size.y, shadow_offset.y)];
-		write_buffer[slice(i,l_size.y, shadow_offset.y)] = r;
 	}
+	swapBuffer();
 	return true;
 }
 
@@ -577,10 +735,9 @@ bool PDE_Layer::solve_fwd_euler_diffusion(double time_interval)
 #pragma omp parallel for
 		for (uint y=0; y<l_size.y; y++) {
 			uint row_start = get_data_index(VINT(0,y,0));
-			uint row_end = row_start + l_size.x;
-			for (uint ii=row_start; ii<row_end;ii++) {
-				write_buffer[ii] = data[ii]*beta + alpha * ( data[ii-1] + data[ii+1] + data[ii+shadow_size.x] + data[ii-shadow_size.x] );
-			}
+			FieldKernels::diffusionSquare(&data[row_start], &write_buffer[row_start], l_size.x, shadow_size.x, alpha, beta);
+			if (sync_cell_statistics)
+				cell_statistics->addRow(VINT(0,y,0), &write_buffer[row_start], l_size.x);
 		}
 	} 
 	else if (structure == Lattice::hexagonal )  {
@@ -592,12 +749,9 @@ bool PDE_Layer::solve_fwd_euler_diffusion(double time_interval)
 #pragma omp parallel for
 		for (uint y=0; y<l_size.y; y++) {
 			uint row_start = get_data_index(VINT(0,y,0));
-			uint row_end = row_start + l_size.x;
-			for (uint ii=row_start; ii<row_end;ii++) {
-				write_buffer[ii] = data[ii]*beta + alpha * (data[ii-1] + data[ii+1] 
-					+ data[ii+shadow_size.x] + data[ii+shadow_size.x-1]
-					+ data[ii-shadow_size.x] + data[ii-shadow_size.x+1] );
-			}
+			FieldKernels::diffusionHexagonal(&data[row_start], &write_buffer[row_start], l_size.x, shadow_size.x, alpha, beta);
+			if (sync_cell_statistics)
+				cell_statistics->addRow(VINT(0,y,0), &write_buffer[row_start], l_size.x);
 		}
 	} 
 	else if (structure == Lattice::linear ) {
@@ -610,6 +764,8 @@ bool PDE_Layer::solve_fwd_euler_diffusion(double time_interval)
 		for (uint ii=row_start; ii<row_end;ii++) {
 			write_buffer[ii] = data[ii]*beta + alpha * (data[ii-1]+ data[ii+1]);
 		}
+		if (sync_cell_statistics)
+			cell_statistics->addRow(VINT(0,0,0), &write_buffer[row_start], l_size.x);
 	}
 	else if ( structure == Lattice::cubic ) {
 		double beta = (1.0-6*alpha);
@@ -620,12 +776,9 @@ bool PDE_Layer::solve_fwd_euler_diffusion(double time_interval)
 		for (int z=0; z<l_size.z;z++) {
 			for (uint y=0; y<l_size.y; y++) {
 				uint row_start = get_data_index(VINT(0,y,z));
-				uint row_end = row_start + l_size.x;
-				for (uint ii=row_start; ii<row_end;ii++) {
-					write_buffer[ii] = data[ii]*beta + alpha * (data[ii-1] + data[ii+1]
-						+ data[ii+shadow_offset.y] + data[ii-shadow_offset.y]
-						+ data[ii+shadow_offset.z] + data[ii-shadow_offset.z]);
-				}
+				FieldKernels::diffusionCubic(&data[row_start], &write_buffer[row_start], l_size.x, shadow_offset.y, shadow_offset.z, alpha, beta);
+				if (sync_cell_statistics)
+					cell_statistics->addRow(VINT(0,y,z), &write_buffer[row_start], l_size.x);
 			}
 		}
 	}
@@ -708,10 +861,15 @@ bool PDE_Layer::solve_fwd_euler_diffusion_generalized(double time_interval)
 	}
 	else {
 		set_fwd_euler_diffusion_boundaries();
-		write_buffer = data  * (1-alpha_total);
-#pragma omp parallel for 
-		for (uint i=0; i<neighbors.size(); i++) {
-			write_buffer += neighbor_alpha[i] * (data.shift(neighbor_index_offst[i]));
+		// Fused kernel over all neighbors, row by row
+		const double beta = 1-alpha_total;
+#pragma omp parallel for
+		for (int z=0; z<l_size.z; z++) {
+			for (int y=0; y<l_size.y; y++) {
+				uint row_start = get_data_index(VINT(0,y,z));
+				FieldKernels::diffusionGeneralized(&data[row_start], &write_buffer[row_start], l_size.x,
+					&neighbor_index_offst[0], &neighbor_alpha[0], neighbors.size(), beta);
+			}
 		}
 	}
 	
@@ -991,27 +1149,6 @@ void PDE_Layer::write_binary(ostream& fout, int max_resolution) {
 
 }
 
-void PDE_Layer::tridiag_solver(const valarray<value_type>& a, const valarray<value_type>& b, valarray<value_type> c, valarray<value_type> d,  valarray<value_type>& x)
-{
-// 	assert(a.size() == b.size());
-// 	assert(a.size() == c.size());
-// 	assert(a.size() == d.size());
-// 	assert(a.size() == x.size());
-// 	assert(b[0] != 0);
-// 	uint n = a.size();
-// 	c[0] = c[0] / b[0];
-// 	d[0] = d[0] / b[0];
-// 	for (int i=1; i<n; i++) {
-// 		double denom = b[i]-c[i-1]*a[i];
-// 		c[i] = c[i] / denom;
-// 		d[i] = (d[i]-d[i-1]*a[i])/denom;
-// 	}
-// 	x[n-1] = d[n-1];
-// 	for (int i=n-2; i>=0; i--) {
-// 		x[i] = d[i] - c[i] * x[i+1];
-// 	}
-}
-
 void PDE_Layer::setDiffusionRate(double diff_rate){
 	diffusion_rate = diff_rate;
 }
@@ -1177,6 +1314,10 @@ XMLNode VectorField_Layer::storeData(string filename) const
 		Lattice_Data_Layer< VDOUBLE >::storeData(out);
 		out.close();
 	}
+	else if (Checkpoint::Writer::current()) {
+		valarray<VDOUBLE> data = getData();
+		xNode = Checkpoint::Writer::current()->write(&data[0], data.size() * sizeof(VDOUBLE), sizeof(VDOUBLE));
+	}
 	else {
 		XMLParserBase64Tool encoder;
 		valarray<VDOUBLE> data = getData();
@@ -1195,7 +1336,13 @@ XMLNode VectorField_Layer::storeData(string filename) const
 bool VectorField_Layer::restoreData(const XMLNode node)
 {
 	string filename;
-	if (getXMLAttribute(node, "filename",filename)) {
+	if (Checkpoint::isBinary(node)) {
+		valarray<VDOUBLE> raw_data(l_size.x * l_size.y * l_size.z);
+		Checkpoint::read(node, &raw_data[0], raw_data.size() * sizeof(VDOUBLE));
+		setData(raw_data);
+		init_by_restore = true;
+	}
+	else if (getXMLAttribute(node, "filename",filename)) {
 		ifstream in(filename.c_str());
 		if (!in.is_open())
 			throw string("Unable to open file: ") + filename;
@@ -26,6 +26,8 @@
 #include "lattice_data_layer.h"
 #include "config.h"
 #include "interfaces.h"
+#include "implicit_diffusion.h"
+#include "cell_field_statistics.h"
 #include <iostream>
 #include <fstream>
 #include <iterator>
@@ -55,6 +57,12 @@ Optionally, a \b Diffusion rate may be specified.
 
 - \b rate: diffusion coefficient [(node length)² per (global time)]
 - \b well-mixed (optional): if true, homogenizes scalar field. Requires rate=0.
+- \b solver (optional): numerical scheme of the diffusion on linear, square and cubic lattices.
+  - \b explicit (default): forward euler, sub-stepped according to its stability limit.
+  - \b adi: implicit euler split into alternating directions, solved line by line.
+  - \b multigrid: implicit euler, solved by multigrid preconditioned conjugate gradients.
+
+  Implicit solvers are unconditionally stable. They require the \b time-step of the Field, which is further bounded by the coupled processes.
 
 
 **/
@@ -90,6 +98,7 @@ class PDE_Layer : public Lattice_Data_Layer<double>
 {
 public:
 	static const float NO_VALUE;
+	enum class DiffusionSolver { Explicit, ADI, Multigrid };
 
 	PDE_Layer(shared_ptr<const Lattice> l, double p_node_length, bool surface=false);
 	~PDE_Layer();
@@ -122,6 +131,8 @@ public:
 	void doDiffusion(double delta_t );
 	/// The maximal time step to proceed without loosing too much precision.
 	double getMaxTimeStep();
+	/// Largest time step the explicit diffusion solver accepts, exclusive
+	double getStableTimeStep() const;
 	double getDiffusionRate();
 	void setDiffusionRate(double diff_rate);
 	void updateNodeLength(double nl); /// Update the physical length the lattice discretization. Used in MembraneProperties of CPM cells that can vary in cell size.
@@ -140,7 +151,12 @@ public:
 // 	/// Get the gradient at position @p pos
 // 	VDOUBLE getGrad(const VINT& pos);
 
-	shared_ptr<PDE_Layer> clone() {return shared_ptr<PDE_Layer> ( new PDE_Layer(*this) ); };
+	shared_ptr<PDE_Layer> clone() { auto c = shared_ptr<PDE_Layer> ( new PDE_Layer(*this) ); c->multigrid.reset(); c->cell_statistics.reset(); return c; };
+
+	/// Per cell sums of the field values, created upon the first request
+	CellFieldStatistics& cellStatistics();
+	/// Notify the per cell sums about modified field values
+	void touchValues() const { if (cell_statistics) cell_statistics->invalidate(); }
 	/**
 		*  Write the layer data to stream @param out in a space/row/row separated ascii format.
 		*/
@@ -187,29 +203,39 @@ private:
 // 	VDOUBLE xy_thetaphi_mapping( VDOUBLE xy );
 
 // 	void reset_boundaries(bool diffusion=false);
-	bool solve_adi_diffusion(double time_interval);
+	DiffusionSolver diffusion_solver;
 
 /**  @brief Forward Euler Solver for time step @param time_interval
 */
 	void set_fwd_euler_diffusion_boundaries();
 	bool solve_fwd_euler_diffusion(double time_interval);
+	/// Provide the updated rows to the per cell sums, see CellFieldStatistics::beginSync()
+	bool sync_cell_statistics;
 	bool solve_fwd_euler_diffusion_spheric(double time_interval);
 	
 	bool solve_fwd_euler_diffusion_generalized(double time_interval);
+	/// Advance @p n_steps cubic forward euler steps by a cache blocked wavefront, see FieldKernels::diffusionCubicWavefront()
+	bool solve_fwd_euler_diffusion_wavefront(double time_interval, uint n_steps);
+	bool wavefrontApplicable() const;
+	vector<double> wavefront_workspace;
 
-/**  @brief Tridiagonal Solver for a,b,c beeing a tridiagonal system
- *   This function solves a tridiagonal system using the Thomas algorithm.
- *   a,b,c are the vectors at the subdiagonal, diagonal and superdiagonal
- *   of the tridiagonal matrix.
- *   d is the vector containing the independent term of the system
- *   n is the dimension of the system (squared)
- *
- *   a,b,c and d must be all n-dimensional vectors
- *
- *   The tridiagonal matrix should be diagonal dominance:
- *              |a_i| + |c_i| < |b_i|  for all i
- */
-	void tridiag_solver(const valarray<value_type>& a, const valarray<value_type>& b,  valarray<value_type> c, valarray<value_type> d,  valarray<value_type>& x);
+/**  @brief Implicit euler solvers for time step @param time_interval on orthogonal lattices
+*/
+	/// Alternating direction implicit, one implicit sweep per axis with alternating order
+	bool solve_adi_diffusion(double time_interval);
+	bool adi_reverse_sweep;
+	/// Implicit euler step, solved by ImplicitDiffusion::Multigrid
+	bool solve_multigrid_diffusion(double time_interval);
+	shared_ptr<ImplicitDiffusion::Multigrid> multigrid;
+	double multigrid_alpha;
+	vector<double> multigrid_rhs, multigrid_solution;
+	/// Links of all lattice nodes (in compact x-y-z order) to their neighbors, derived from boundaries and the domain
+	void setup_implicit_links();
+	vector<ImplicitDiffusion::Links> implicit_links;
+	/// Compact index of lattice position @p pos
+	size_t implicit_index(const VINT& pos) const { return (size_t(pos.z) * l_size.y + pos.y) * l_size.x + pos.x; }
+
+	shared_ptr<CellFieldStatistics> cell_statistics;
 };
 
 class Field : public Plugin {
@@ -240,10 +266,10 @@ public:
 		}
 		
 		shared_ptr<PDE_Layer> getField() const { return field; };
-		void set(const SymbolFocus & f, typename TypeInfo<double>::Parameter value) const override { field->set(f.pos(), value); };
+		void set(const SymbolFocus & f, typename TypeInfo<double>::Parameter value) const override { field->set(f.pos(), value); field->touchValues(); };
 		void setBuffer(const SymbolFocus & f, TypeInfo<double>::Parameter value) const override { field->setBuffer(f.pos(), value); }
-		void applyBuffer() const override { field->swapBuffer(); };
-		void applyBuffer(const SymbolFocus & f) const override { field->applyBuffer(f.pos()); }
+		void applyBuffer() const override { field->swapBuffer(); field->touchValues(); };
+		void applyBuffer(const SymbolFocus & f) const override { field->applyBuffer(f.pos()); field->touchValues(); }
 		
 	private: 
 		string descr;
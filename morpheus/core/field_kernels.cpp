@@ -0,0 +1,256 @@
+#include "field_kernels.h"
+#include <algorithm>
+#include <cassert>
+
+// Do not contract mul/add into FMA, which would break bit-identity across the instruction sets
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#elif defined(__clang__)
+#pragma clang fp contract(off)
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FIELD_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace FieldKernels {
+
+namespace scalar {
+	typedef double V;
+	const unsigned int W = 1;
+	inline V vload(const double* p) { return *p; }
+	inline void vstore(double* p, V a) { *p = a; }
+	inline V vset1(double a) { return a; }
+	inline V vadd(V a, V b) { return a + b; }
+	inline V vmul(V a, V b) { return a * b; }
+#define KERNEL_TARGET
+#include "field_kernels_impl.h"
+#undef KERNEL_TARGET
+}
+
+#ifdef FIELD_KERNELS_X86
+
+namespace sse2 {
+#define KERNEL_TARGET __attribute__((target("sse2")))
+	typedef __m128d V;
+	const unsigned int W = 2;
+	KERNEL_TARGET inline V vload(const double* p) { return _mm_loadu_pd(p); }
+	KERNEL_TARGET inline void vstore(double* p, V a) { _mm_storeu_pd(p, a); }
+	KERNEL_TARGET inline V vset1(double a) { return _mm_set1_pd(a); }
+	KERNEL_TARGET inline V vadd(V a, V b) { return _mm_add_pd(a, b); }
+	KERNEL_TARGET inline V vmul(V a, V b) { return _mm_mul_pd(a, b); }
+#include "field_kernels_impl.h"
+#undef KERNEL_TARGET
+}
+
+namespace avx {
+#define KERNEL_TARGET __attribute__((target("avx")))
+	typedef __m256d V;
+	const unsigned int W = 4;
+	KERNEL_TARGET inline V vload(const double* p) { return _mm256_loadu_pd(p); }
+	KERNEL_TARGET inline void vstore(double* p, V a) { _mm256_storeu_pd(p, a); }
+	KERNEL_TARGET inline V vset1(double a) { return _mm256_set1_pd(a); }
+	KERNEL_TARGET inline V vadd(V a, V b) { return _mm256_add_pd(a, b); }
+	KERNEL_TARGET inline V vmul(V a, V b) { return _mm256_mul_pd(a, b); }
+#include "field_kernels_impl.h"
+#undef KERNEL_TARGET
+}
+
+namespace avx512 {
+#define KERNEL_TARGET __attribute__((target("avx512f")))
+	typedef __m512d V;
+	const unsigned int W = 8;
+	KERNEL_TARGET inline V vload(const double* p) { return _mm512_loadu_pd(p); }
+	KERNEL_TARGET inline void vstore(double* p, V a) { _mm512_storeu_pd(p, a); }
+	KERNEL_TARGET inline V vset1(double a) { return _mm512_set1_pd(a); }
+	KERNEL_TARGET inline V vadd(V a, V b) { return _mm512_add_pd(a, b); }
+	KERNEL_TARGET inline V vmul(V a, V b) { return _mm512_mul_pd(a, b); }
+#include "field_kernels_impl.h"
+#undef KERNEL_TARGET
+}
+
+#endif // FIELD_KERNELS_X86
+
+namespace {
+	struct KernelTable {
+		SIMD simd;
+		decltype(&scalar::diffusionSquare) square;
+		decltype(&scalar::diffusionHexagonal) hexagonal;
+		decltype(&scalar::diffusionCubic) cubic;
+		decltype(&scalar::diffusionCubicPlanes) cubic_planes;
+		decltype(&scalar::diffusionGeneralized) generalized;
+	};
+
+#define KERNEL_TABLE(ns, s) KernelTable{ s, &ns::diffusionSquare, &ns::diffusionHexagonal, &ns::diffusionCubic, &ns::diffusionCubicPlanes, &ns::diffusionGeneralized }
+
+	KernelTable kernelTable(SIMD s) {
+		switch (s) {
+#ifdef FIELD_KERNELS_X86
+			case SIMD::AVX512: return KERNEL_TABLE(avx512, SIMD::AVX512);
+			case SIMD::AVX: return KERNEL_TABLE(avx, SIMD::AVX);
+			case SIMD::SSE2: return KERNEL_TABLE(sse2, SIMD::SSE2);
+#endif
+			default: return KERNEL_TABLE(scalar, SIMD::Scalar);
+		}
+	}
+
+#undef KERNEL_TABLE
+
+	KernelTable bestKernelTable() {
+		for (SIMD s : { SIMD::AVX512, SIMD::AVX, SIMD::SSE2 }) {
+			if (simdSupported(s))
+				return kernelTable(s);
+		}
+		return kernelTable(SIMD::Scalar);
+	}
+
+	KernelTable& kernels() {
+		static KernelTable table = bestKernelTable();
+		return table;
+	}
+}
+
+bool simdSupported(SIMD s) {
+	switch (s) {
+		case SIMD::Scalar: return true;
+#ifdef FIELD_KERNELS_X86
+		case SIMD::SSE2: return __builtin_cpu_supports("sse2");
+		case SIMD::AVX: return __builtin_cpu_supports("avx");
+		case SIMD::AVX512: return __builtin_cpu_supports("avx512f");
+#endif
+		default: return false;
+	}
+}
+
+std::string simdName(SIMD s) {
+	switch (s) {
+		case SIMD::SSE2: return "SSE2";
+		case SIMD::AVX: return "AVX";
+		case SIMD::AVX512: return "AVX-512";
+		default: return "scalar";
+	}
+}
+
+SIMD simd() { return kernels().simd; }
+
+bool selectSIMD(SIMD s) {
+	if (!simdSupported(s))
+		return false;
+	kernels() = kernelTable(s);
+	return true;
+}
+
+void diffusionSquare(const double* src, double* dst, unsigned int n, int sy, double alpha, double beta) {
+	kernels().square(src, dst, n, sy, alpha, beta);
+}
+
+void diffusionHexagonal(const double* src, double* dst, unsigned int n, int sy, double alpha, double beta) {
+	kernels().hexagonal(src, dst, n, sy, alpha, beta);
+}
+
+void diffusionCubic(const double* src, double* dst, unsigned int n, int sy, int sz, double alpha, double beta) {
+	kernels().cubic(src, dst, n, sy, sz, alpha, beta);
+}
+
+void diffusionGeneralized(const double* src, double* dst, unsigned int n, const int* offsets, const double* alphas, unsigned int n_neighbors, double beta) {
+	kernels().generalized(src, dst, n, offsets, alphas, n_neighbors, beta);
+}
+
+void diffusionCubicPlanes(const double* prev, const double* cur, const double* next, double* dst, unsigned int n, int sy, double alpha, double beta) {
+	kernels().cubic_planes(prev, cur, next, dst, n, sy, alpha, beta);
+}
+
+namespace {
+	/// Cache budget for the planes kept by the wavefront
+	const size_t wavefront_cache_bytes = 4 * 1024 * 1024;
+	const unsigned int wavefront_max_depth = 8;
+}
+
+unsigned int wavefrontDepth(const VINT& size) {
+	const size_t plane_bytes = size_t(size.x+2) * (size.y+2) * sizeof(double);
+	size_t depth = wavefront_cache_bytes / (3 * plane_bytes);
+	if (depth < 2 || size.z < 4)
+		return 1;
+	return std::min(size_t(wavefront_max_depth), depth);
+}
+
+void diffusionCubicWavefront(const double* src, double* dst, const VINT& size, double alpha, double beta, unsigned int n_steps,
+	const Boundary::Type boundaries[Boundary::nCodes], std::vector<double>& workspace)
+{
+	assert(boundaries[Boundary::mz] != Boundary::periodic && boundaries[Boundary::pz] != Boundary::periodic);
+	const int sy = size.x + 2;
+	const int sz = sy * (size.y + 2);
+	if (n_steps > 1)
+		workspace.resize(size_t(n_steps-1) * 3 * sz);
+	
+	// Plane z of step t, including the boundary planes z=-1 and z=size.z
+	auto plane = [&](unsigned int t, int z) -> double* {
+		if (t == 0)
+			return const_cast<double*>(src) + (z+1) * sz;
+		if (z == -1) {
+			if (boundaries[Boundary::mz] != Boundary::noflux)
+				return const_cast<double*>(src);
+			z = 0;
+		}
+		else if (z == size.z) {
+			if (boundaries[Boundary::pz] != Boundary::noflux)
+				return const_cast<double*>(src) + (size.z+1) * sz;
+			z = size.z-1;
+		}
+		if (t == n_steps)
+			return dst + (z+1) * sz;
+		return &workspace[ (size_t(t-1) * 3 + z % 3) * sz ];
+	};
+	
+	// Fill the shadow of plane z of an intermediate step as a full step would do, constant values are taken from the source
+	auto set_row_boundaries = [&](double* row, const double* src_row) {
+		if (boundaries[Boundary::mx] == Boundary::periodic) row[-1] = row[size.x-1];
+		else if (boundaries[Boundary::mx] == Boundary::noflux) row[-1] = row[0];
+		else row[-1] = src_row[-1];
+		if (boundaries[Boundary::px] == Boundary::periodic) row[size.x] = row[0];
+		else if (boundaries[Boundary::px] == Boundary::noflux) row[size.x] = row[size.x-1];
+		else row[size.x] = src_row[size.x];
+	};
+	auto set_plane_boundaries = [&](double* p, const double* src_p) {
+		double* first = p + sy + 1;
+		double* last = p + size.y * sy + 1;
+		double* lower = p + 1;
+		double* upper = p + (size.y+1) * sy + 1;
+		for (int x=0; x<size.x; x++) {
+			if (boundaries[Boundary::my] == Boundary::periodic) lower[x] = last[x];
+			else if (boundaries[Boundary::my] == Boundary::noflux) lower[x] = first[x];
+			else lower[x] = src_p[1+x];
+			if (boundaries[Boundary::py] == Boundary::periodic) upper[x] = first[x];
+			else if (boundaries[Boundary::py] == Boundary::noflux) upper[x] = last[x];
+			else upper[x] = src_p[(size.y+1) * sy + 1 + x];
+		}
+	};
+	
+#pragma omp parallel
+	for (int w=0; w < size.z + int(n_steps) - 1; w++) {
+		for (unsigned int t=1; t<=n_steps; t++) {
+			const int z = w - int(t-1);
+			if (z < 0 || z >= size.z)
+				continue;
+			const double* prev = plane(t-1, z-1);
+			const double* cur = plane(t-1, z);
+			const double* next = plane(t-1, z+1);
+			double* out = plane(t, z);
+			const double* src_plane = plane(0, z);
+#pragma omp for schedule(static)
+			for (int y=0; y<size.y; y++) {
+				const int row = (y+1) * sy + 1;
+				diffusionCubicPlanes(prev + row, cur + row, next + row, out + row, size.x, sy, alpha, beta);
+				if (t < n_steps)
+					set_row_boundaries(out + row, src_plane + row);
+			}
+			if (t < n_steps) {
+#pragma omp single
+				set_plane_boundaries(out, src_plane);
+			}
+		}
+	}
+}
+
+}
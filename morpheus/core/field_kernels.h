@@ -0,0 +1,67 @@
+//////
+//
+// This file is part of the modelling and simulation framework 'Morpheus',
+// and is made available under the terms of the BSD 3-clause license (see LICENSE
+// file that comes with the distribution or https://opensource.org/licenses/BSD-3-Clause).
+//
+// Authors:  Joern Starruss and Walter de Back
+// Copyright 2009-2016, Technische Universität Dresden, Germany
+//
+//////
+
+#ifndef FIELD_KERNELS_H
+#define FIELD_KERNELS_H
+
+#include <string>
+#include <vector>
+#include "domain.h"
+
+/** @brief Vectorized row kernels of the forward Euler diffusion solvers of the PDE_Layer.
+ *
+ *  All kernels process @p n contiguous nodes starting at @p src / @p dst. The neighbors are addressed by
+ *  index offsets into the shadowed data grid, which must thus be accessible around the whole row.
+ *  The instruction set is selected at runtime from the capabilities of the host CPU.
+ *
+ *  The kernels do not use fused multiply-add and evaluate the terms in the very same order as the
+ *  scalar reference, such that all instruction sets produce bit-identical results.
+ */
+namespace FieldKernels {
+
+	enum class SIMD { Scalar, SSE2, AVX, AVX512 };
+
+	/// Instruction set currently in use
+	SIMD simd();
+	std::string simdName(SIMD s);
+	/// Check whether instruction set @p s is supported by the host
+	bool simdSupported(SIMD s);
+	/// Select instruction set @p s, returns false if not supported. Default is the best supported one.
+	bool selectSIMD(SIMD s);
+
+	/// dst[i] = beta * src[i] + alpha * (src[i-1] + src[i+1] + src[i+sy] + src[i-sy])
+	void diffusionSquare(const double* src, double* dst, unsigned int n, int sy, double alpha, double beta);
+	/// dst[i] = beta * src[i] + alpha * (src[i-1] + src[i+1] + src[i+sy] + src[i+sy-1] + src[i-sy] + src[i-sy+1])
+	void diffusionHexagonal(const double* src, double* dst, unsigned int n, int sy, double alpha, double beta);
+	/// dst[i] = beta * src[i] + alpha * (src[i-1] + src[i+1] + src[i+sy] + src[i-sy] + src[i+sz] + src[i-sz])
+	void diffusionCubic(const double* src, double* dst, unsigned int n, int sy, int sz, double alpha, double beta);
+	/// Same as diffusionCubic(), but the z-neighbors are taken from the separate planes @p prev and @p next
+	void diffusionCubicPlanes(const double* prev, const double* cur, const double* next, double* dst, unsigned int n, int sy, double alpha, double beta);
+	/// dst[i] = beta * src[i] + sum_k alphas[k] * src[i+offsets[k]], fused over all @p n_neighbors neighbors
+	void diffusionGeneralized(const double* src, double* dst, unsigned int n, const int* offsets, const double* alphas, unsigned int n_neighbors, double beta);
+
+	/** @brief Advance @p n_steps cubic diffusion steps at once, by a wavefront over the z-planes.
+	 *
+	 *  @p src and @p dst are shadowed grids of @p size with a shadow width of one, i.e. sy = size.x+2 and
+	 *  sz = sy * (size.y+2). The shadow of @p src must hold the boundary values of the first step.
+	 *  Intermediate steps only keep three planes per step in @p workspace, which thus remain in cache
+	 *  while the wavefront passes. The shadow of @p dst is left untouched.
+	 *
+	 *  Boundaries in z must not be periodic, since the wavefront cannot wrap around.
+	 *  Results are identical to @p n_steps individual steps with boundaries reset in between.
+	 */
+	void diffusionCubicWavefront(const double* src, double* dst, const VINT& size, double alpha, double beta, unsigned int n_steps,
+		const Boundary::Type boundaries[Boundary::nCodes], std::vector<double>& workspace);
+	/// Number of steps diffusionCubicWavefront() should advance at once, such that the wavefront fits into cache. Returns 1 if blocking does not pay off.
+	unsigned int wavefrontDepth(const VINT& size);
+}
+
+#endif // FIELD_KERNELS_H
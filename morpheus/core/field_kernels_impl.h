@@ -0,0 +1,94 @@
+//////
+//
+// This file is part of the modelling and simulation framework 'Morpheus',
+// and is made available under the terms of the BSD 3-clause license (see LICENSE
+// file that comes with the distribution or https://opensource.org/licenses/BSD-3-Clause).
+//
+// Authors:  Joern Starruss and Walter de Back
+// Copyright 2009-2016, Technische Universität Dresden, Germany
+//
+//////
+
+// Kernel bodies of field_kernels.cpp, included once per instruction set.
+// No include guard by intention. The including namespace provides
+//   V, W                       vector type and its width in doubles
+//   vload, vstore, vset1       unaligned load / store and broadcast
+//   vadd, vmul                 element-wise arithmetics
+//   KERNEL_TARGET              function attribute selecting the instruction set
+
+KERNEL_TARGET void diffusionSquare(const double* src, double* dst, unsigned int n, int sy, double alpha, double beta) {
+	const V va = vset1(alpha), vb = vset1(beta);
+	unsigned int i=0;
+	for (; i+W<=n; i+=W) {
+		const double* s = src+i;
+		V sum = vadd(vadd(vadd(vload(s-1), vload(s+1)), vload(s+sy)), vload(s-sy));
+		vstore(dst+i, vadd(vmul(vload(s), vb), vmul(va, sum)));
+	}
+	for (; i<n; i++) {
+		const double* s = src+i;
+		dst[i] = s[0]*beta + alpha * ( s[-1] + s[1] + s[sy] + s[-sy] );
+	}
+}
+
+KERNEL_TARGET void diffusionHexagonal(const double* src, double* dst, unsigned int n, int sy, double alpha, double beta) {
+	const V va = vset1(alpha), vb = vset1(beta);
+	unsigned int i=0;
+	for (; i+W<=n; i+=W) {
+		const double* s = src+i;
+		V sum = vadd(vadd(vadd(vadd(vadd(vload(s-1), vload(s+1)), vload(s+sy)), vload(s+sy-1)), vload(s-sy)), vload(s-sy+1));
+		vstore(dst+i, vadd(vmul(vload(s), vb), vmul(va, sum)));
+	}
+	for (; i<n; i++) {
+		const double* s = src+i;
+		dst[i] = s[0]*beta + alpha * ( s[-1] + s[1] + s[sy] + s[sy-1] + s[-sy] + s[-sy+1] );
+	}
+}
+
+KERNEL_TARGET void diffusionCubic(const double* src, double* dst, unsigned int n, int sy, int sz, double alpha, double beta) {
+	const V va = vset1(alpha), vb = vset1(beta);
+	unsigned int i=0;
+	for (; i+W<=n; i+=W) {
+		const double* s = src+i;
+		V sum = vadd(vadd(vadd(vadd(vadd(vload(s-1), vload(s+1)), vload(s+sy)), vload(s-sy)), vload(s+sz)), vload(s-sz));
+		vstore(dst+i, vadd(vmul(vload(s), vb), vmul(va, sum)));
+	}
+	for (; i<n; i++) {
+		const double* s = src+i;
+		dst[i] = s[0]*beta + alpha * ( s[-1] + s[1] + s[sy] + s[-sy] + s[sz] + s[-sz] );
+	}
+}
+
+KERNEL_TARGET void diffusionCubicPlanes(const double* prev, const double* cur, const double* next, double* dst, unsigned int n, int sy, double alpha, double beta) {
+	const V va = vset1(alpha), vb = vset1(beta);
+	unsigned int i=0;
+	for (; i+W<=n; i+=W) {
+		const double* s = cur+i;
+		V sum = vadd(vadd(vadd(vadd(vadd(vload(s-1), vload(s+1)), vload(s+sy)), vload(s-sy)), vload(next+i)), vload(prev+i));
+		vstore(dst+i, vadd(vmul(vload(s), vb), vmul(va, sum)));
+	}
+	for (; i<n; i++) {
+		const double* s = cur+i;
+		dst[i] = s[0]*beta + alpha * ( s[-1] + s[1] + s[sy] + s[-sy] + next[i] + prev[i] );
+	}
+}
+
+KERNEL_TARGET void diffusionGeneralized(const double* src, double* dst, unsigned int n, const int* offsets, const double* alphas, unsigned int n_neighbors, double beta) {
+	const V vb = vset1(beta);
+	unsigned int i=0;
+	for (; i+W<=n; i+=W) {
+		const double* s = src+i;
+		V acc = vmul(vload(s), vb);
+		for (unsigned int k=0; k<n_neighbors; k++) {
+			acc = vadd(acc, vmul(vset1(alphas[k]), vload(s+offsets[k])));
+		}
+		vstore(dst+i, acc);
+	}
+	for (; i<n; i++) {
+		const double* s = src+i;
+		double acc = s[0] * beta;
+		for (unsigned int k=0; k<n_neighbors; k++) {
+			acc += alphas[k] * s[offsets[k]];
+		}
+		dst[i] = acc;
+	}
+}
@@ -0,0 +1,126 @@
+//////
+//
+// This file is part of the modelling and simulation framework 'Morpheus',
+// and is made available under the terms of the BSD 3-clause license (see LICENSE
+// file that comes with the distribution or https://opensource.org/licenses/BSD-3-Clause).
+//
+// Authors:  Joern Starruss and Walter de Back
+// Copyright 2009-2016, Technische Universität Dresden, Germany
+//
+//////
+
+#ifndef FLAT_MAP_H
+#define FLAT_MAP_H
+
+#include "config.h"
+#include <algorithm>
+#include <stdexcept>
+
+/** @brief Sorted small-vector map with inline storage for up to N entries
+ *
+ *  Read compatible replacement for small std::maps, such as the interfaces of a cell (see CPMShape::Interfaces).
+ *  Entries are kept sorted by key in one contiguous array, which is stored within the object unless it exceeds N entries.
+ *  In contrast to std::map, the key of an entry is not const and iterators are invalidated by any insertion or erasure.
+ */
+template <class Key, class T, int N = 8>
+class FlatMap {
+public:
+	typedef Key key_type;
+	typedef T mapped_type;
+	typedef pair<Key,T> value_type;
+	typedef size_t size_type;
+	typedef value_type* iterator;
+	typedef const value_type* const_iterator;
+
+	FlatMap() : data(local), _size(0), _capacity(N) {};
+	FlatMap(const FlatMap& other) : FlatMap() { *this = other; }
+	FlatMap& operator=(const FlatMap& other) {
+		if (this != &other) {
+			_size = 0;
+			reserve(other._size);
+			std::copy(other.begin(), other.end(), data);
+			_size = other._size;
+		}
+		return *this;
+	}
+	~FlatMap() { if (data != local) delete[] data; }
+
+	iterator begin() { return data; }
+	iterator end() { return data + _size; }
+	const_iterator begin() const { return data; }
+	const_iterator end() const { return data + _size; }
+	const_iterator cbegin() const { return data; }
+	const_iterator cend() const { return data + _size; }
+	size_t size() const { return _size; }
+	bool empty() const { return _size == 0; }
+	void clear() { _size = 0; }
+
+	iterator lower_bound(const Key& key) {
+		return std::lower_bound(begin(), end(), key, [](const value_type& a, const Key& k) { return a.first < k; });
+	}
+	const_iterator lower_bound(const Key& key) const {
+		return std::lower_bound(begin(), end(), key, [](const value_type& a, const Key& k) { return a.first < k; });
+	}
+	iterator find(const Key& key) { auto it = lower_bound(key); return (it != end() && it->first == key) ? it : end(); }
+	const_iterator find(const Key& key) const { auto it = lower_bound(key); return (it != end() && it->first == key) ? it : end(); }
+	size_t count(const Key& key) const { return find(key) != end(); }
+	const T& at(const Key& key) const {
+		auto it = find(key);
+		if (it == end()) throw std::out_of_range("FlatMap::at");
+		return it->second;
+	}
+
+	T& operator[](const Key& key) {
+		auto it = lower_bound(key);
+		if (it == end() || it->first != key)
+			it = insertAt(it, value_type(key, T()));
+		return it->second;
+	}
+	pair<iterator, bool> insert(const value_type& value) {
+		auto it = lower_bound(value.first);
+		if (it != end() && it->first == value.first)
+			return make_pair(it, false);
+		return make_pair(insertAt(it, value), true);
+	}
+	size_t erase(const Key& key) {
+		auto it = find(key);
+		if (it == end()) return 0;
+		erase(it);
+		return 1;
+	}
+	iterator erase(iterator it) {
+		std::move(it + 1, end(), it);
+		_size--;
+		return it;
+	}
+
+	void reserve(size_t n) {
+		if (n <= _capacity) return;
+		size_t capacity = max(n, 2 * _capacity);
+		value_type* heap = new value_type[capacity];
+		std::copy(begin(), end(), heap);
+		if (data != local) delete[] data;
+		data = heap;
+		_capacity = capacity;
+	}
+
+private:
+	iterator insertAt(iterator it, const value_type& value) {
+		if (_size == _capacity) {
+			size_t pos = it - begin();
+			reserve(_size + 1);
+			it = begin() + pos;
+		}
+		std::move_backward(it, end(), end() + 1);
+		*it = value;
+		_size++;
+		return it;
+	}
+
+	value_type local[N];
+	value_type* data;
+	size_t _size;
+	size_t _capacity;
+};
+
+#endif // FLAT_MAP_H
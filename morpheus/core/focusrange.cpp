@@ -480,7 +480,7 @@ void FocusRange::init_range(Granularity granularity, multimap< FocusRangeAxis, i
 				VINT filter_value(filter_enabled.x == 1 ? restrictions.find(FocusRangeAxis::X)->second : 0,
 								filter_enabled.y == 1 ? restrictions.find(FocusRangeAxis::Y)->second : 0,
 								filter_enabled.z == 1 ? restrictions.find(FocusRangeAxis::Z)->second : 0);
-				vector< const set <VINT, less_VINT >* > cell_nodes;
+				vector< const Cell::Nodes* > cell_nodes;
 				const vector<CPM::CELL_ID>& cell_range = range->cell_range;
 				if (range->iter_mode == FocusRangeDescriptor::IT_CellNodes) {
 					cell_nodes = range->cell_nodes;
@@ -490,11 +490,11 @@ void FocusRange::init_range(Granularity granularity, multimap< FocusRangeAxis, i
 						cell_nodes.push_back(&nodes);
 					}
 				}
-				vector< set <VINT, less_VINT > > new_cell_nodes;
+				vector< Cell::Nodes > new_cell_nodes;
 				vector< CPM::CELL_ID > new_cell_range;
 				
 				for (int i = 0; i<cell_nodes.size(); i++) {
-					set <VINT, less_VINT > new_nodes;
+					Cell::Nodes new_nodes;
 					for (auto node : *cell_nodes[i]) {
 						if (   (filter_enabled.x ? node.x == filter_value.x : true) 
 						    && (filter_enabled.y ? node.y == filter_value.y : true)
@@ -604,7 +604,13 @@ void FocusRange::init_range(Granularity granularity, multimap< FocusRangeAxis, i
 					int z_slice = restrictions.lower_bound(FocusRangeAxis::Z)->second;
 					for (auto cell_id = range->cell_range.begin(); cell_id!=range->cell_range.end(); ) {
 						const auto& cell_nodes = CPM::getCell(*cell_id).getNodes();
+#ifdef MORPHEUS_FLAT_NODES
+						// flat node containers are not ordered
+						auto z_range = minmax_element(cell_nodes.begin(), cell_nodes.end(), [](const VINT& a, const VINT& b) { return a.z < b.z; });
+						if (cell_nodes.empty() || z_range.first->z > z_slice || z_range.second->z < z_slice) {
+#else
 						if (cell_nodes.empty() || cell_nodes.begin()->z > z_slice || cell_nodes.rbegin()->z < z_slice) {
+#endif
 							// drop cell ...
 							 cell_id = range->cell_range.erase(cell_id);
 						}
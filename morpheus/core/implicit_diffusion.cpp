@@ -0,0 +1,354 @@
+#include "implicit_diffusion.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace ImplicitDiffusion {
+
+namespace {
+	/// Thomas algorithm on @p width interleaved systems, @p c is scratch space
+	void thomas(const double* a, const double* b, const double* upper, double* x, double* c, unsigned int n, unsigned int width) {
+		for (unsigned int w=0; w<width; w++) {
+			const double m = 1.0 / b[w];
+			c[w] = upper[w] * m;
+			x[w] = x[w] * m;
+		}
+		for (unsigned int i=1; i<n; i++) {
+			for (size_t k=i*width; k<(i+1)*width; k++) {
+				const double m = 1.0 / (b[k] - a[k] * c[k-width]);
+				c[k] = upper[k] * m;
+				x[k] = (x[k] - a[k] * x[k-width]) * m;
+			}
+		}
+		for (int i=n-2; i>=0; i--) {
+			for (size_t k=i*width; k<(i+1)*width; k++) {
+				x[k] -= c[k] * x[k+width];
+			}
+		}
+	}
+}
+
+void solveTridiagonal(std::vector<double>& lower, std::vector<double>& diag, std::vector<double>& upper, std::vector<double>& x, unsigned int width, std::vector<double>& work)
+{
+	assert(width > 0 && x.size() % width == 0);
+	assert(lower.size() == x.size() && diag.size() == x.size() && upper.size() == x.size());
+	const unsigned int n = x.size() / width;
+	if (n == 0) return;
+	if (n == 1) {
+		for (unsigned int w=0; w<width; w++)
+			x[w] /= diag[w] + lower[w] + upper[w];
+		return;
+	}
+
+	// lower[0] couples x[0] to x[n-1], upper[n-1] couples x[n-1] to x[0]
+	double* corner_lower = &lower[0];
+	double* corner_upper = &upper[(n-1) * width];
+	if (n == 2) {
+		// corners are just parallel couplings
+		for (unsigned int w=0; w<width; w++) {
+			upper[w] += corner_lower[w];
+			lower[width + w] += corner_upper[w];
+			corner_lower[w] = corner_upper[w] = 0;
+		}
+	}
+	bool cyclic = false;
+	for (unsigned int w=0; w<width; w++) {
+		if (corner_lower[w] != 0 || corner_upper[w] != 0)
+			cyclic = true;
+	}
+
+	work.resize(2 * x.size() + 3 * width);
+	double* c = &work[0];
+	if ( ! cyclic ) {
+		thomas(&lower[0], &diag[0], &upper[0], &x[0], c, n, width);
+		return;
+	}
+
+	// Sherman-Morrison, A = T + u v^T with u = (gamma,0,...,0,corner_upper), v = (1,0,...,0,corner_lower/gamma)
+	double* z = &work[x.size()];
+	double* cl = &work[2 * x.size()];
+	double* cu = cl + width;
+	double* gamma = cu + width;
+	std::fill(z, z + x.size(), 0.0);
+	for (unsigned int w=0; w<width; w++) {
+		cl[w] = corner_lower[w];
+		cu[w] = corner_upper[w];
+		corner_lower[w] = corner_upper[w] = 0;
+		gamma[w] = -diag[w];
+		diag[w] -= gamma[w];
+		diag[(n-1) * width + w] -= cu[w] * cl[w] / gamma[w];
+		z[w] = gamma[w];
+		z[(n-1) * width + w] = cu[w];
+	}
+	thomas(&lower[0], &diag[0], &upper[0], &x[0], c, n, width);
+	thomas(&lower[0], &diag[0], &upper[0], z, c, n, width);
+	for (unsigned int w=0; w<width; w++) {
+		const size_t last = (n-1) * width + w;
+		const double factor = (x[w] + cl[w] * x[last] / gamma[w]) / (1.0 + z[w] + cl[w] * z[last] / gamma[w]);
+		for (unsigned int i=0; i<n; i++) {
+			x[i * width + w] -= factor * z[i * width + w];
+		}
+	}
+}
+
+
+Stencil::Stencil(const VINT& size, unsigned int dimensions) : size(size), dimensions(dimensions)
+{
+	const size_t n = size_t(size.x) * size.y * size.z;
+	diag.resize(n, 0.0);
+	for (unsigned int k=0; k<2*dimensions; k++) {
+		coupling[k].resize(n, 0.0);
+	}
+}
+
+namespace {
+	/// out = b - A u  if @p b is given, else out = A u. Rows of the interior are free of wrap around and vectorize.
+	template <int DIMS>
+	void stencilProduct(const Stencil& A, const std::vector<double>& u, const std::vector<double>* b, std::vector<double>& out) {
+		const int sx = A.size.x, sy = A.size.y, sz = A.size.z;
+		const double* cmx = A.coupling[Boundary::mx].data(); const double* cpx = A.coupling[Boundary::px].data();
+		const double* cmy = A.coupling[Boundary::my].data(); const double* cpy = A.coupling[Boundary::py].data();
+		const double* cmz = A.coupling[Boundary::mz].data(); const double* cpz = A.coupling[Boundary::pz].data();
+		const double* diag = A.diag.data();
+		const double* in = u.data();
+		const double* rhs = b ? b->data() : nullptr;
+		double* res = out.data();
+#pragma omp parallel for
+		for (int row_id=0; row_id<sy*sz; row_id++) {
+			const int y = row_id % sy, z = row_id / sy;
+			const size_t row = size_t(row_id) * sx;
+			const double* ym = in + (size_t(z) * sy + (y>0 ? y-1 : sy-1)) * sx;
+			const double* yp = in + (size_t(z) * sy + (y+1<sy ? y+1 : 0)) * sx;
+			const double* zm = in + (size_t(z>0 ? z-1 : sz-1) * sy + y) * sx;
+			const double* zp = in + (size_t(z+1<sz ? z+1 : 0) * sy + y) * sx;
+			const double* c = in + row;
+			auto product = [&](int x, int xm, int xp) {
+				const size_t i = row + x;
+				double s = diag[i] * c[x] - cmx[i] * c[xm] - cpx[i] * c[xp];
+				if (DIMS > 1) s -= cmy[i] * ym[x] + cpy[i] * yp[x];
+				if (DIMS > 2) s -= cmz[i] * zm[x] + cpz[i] * zp[x];
+				res[i] = rhs ? rhs[i] - s : s;
+			};
+			product(0, sx-1, sx>1 ? 1 : 0);
+			for (int x=1; x<sx-1; x++) product(x, x-1, x+1);
+			if (sx > 1) product(sx-1, sx-2, 0);
+		}
+	}
+
+	void stencilProduct(const Stencil& A, const std::vector<double>& u, const std::vector<double>* b, std::vector<double>& out) {
+		switch (A.dimensions) {
+			case 1: stencilProduct<1>(A, u, b, out); break;
+			case 2: stencilProduct<2>(A, u, b, out); break;
+			default: stencilProduct<3>(A, u, b, out); break;
+		}
+	}
+
+	double dot(const std::vector<double>& a, const std::vector<double>& b) {
+		double s = 0;
+		const int n = a.size();
+#pragma omp parallel for reduction(+:s)
+		for (int i=0; i<n; i++) s += a[i] * b[i];
+		return s;
+	}
+
+	/// Position of coordinate @p x moved by @p step, wrapped around @p n
+	inline int wrap(int x, int step, int n) { x += step; return x < 0 ? x + n : (x >= n ? x - n : x); }
+}
+
+void Stencil::residual(const std::vector<double>& b, const std::vector<double>& x, std::vector<double>& r) const
+{
+	stencilProduct(*this, x, &b, r);
+}
+
+void Stencil::apply(const std::vector<double>& x, std::vector<double>& y) const
+{
+	stencilProduct(*this, x, nullptr, y);
+}
+
+Stencil Stencil::coarsen() const
+{
+	VINT coarse_size(1,1,1);
+	coarse_size.x = (size.x+1) / 2;
+	if (dimensions > 1) coarse_size.y = (size.y+1) / 2;
+	if (dimensions > 2) coarse_size.z = (size.z+1) / 2;
+	Stencil coarse(coarse_size, dimensions);
+	const int fine_size[3] = { size.x, size.y, size.z };
+
+#pragma omp parallel for
+	for (int cz=0; cz<coarse_size.z; cz++) {
+		for (int cy=0; cy<coarse_size.y; cy++) {
+			for (int cx=0; cx<coarse_size.x; cx++) {
+				const size_t I = (size_t(cz) * coarse_size.y + cy) * coarse_size.x + cx;
+				// sum the rows of all nodes in the aggregate, couplings within the aggregate fold into the diagonal
+				for (int z = (dimensions > 2 ? 2*cz : 0); z < std::min(dimensions > 2 ? 2*cz+2 : 1, size.z); z++) {
+					for (int y = (dimensions > 1 ? 2*cy : 0); y < std::min(dimensions > 1 ? 2*cy+2 : 1, size.y); y++) {
+						for (int x = 2*cx; x < std::min(2*cx+2, size.x); x++) {
+							const size_t i = (size_t(z) * size.y + y) * size.x + x;
+							const int pos[3] = { x, y, z };
+							coarse.diag[I] += diag[i];
+							for (unsigned int k=0; k<2*dimensions; k++) {
+								const double c = coupling[k][i];
+								if (c == 0) continue;
+								const unsigned int d = k/2;
+								const int neighbor = wrap(pos[d], (k%2) ? 1 : -1, fine_size[d]);
+								if (neighbor/2 == pos[d]/2)
+									coarse.diag[I] -= c;
+								else
+									coarse.coupling[k][I] += c;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	return coarse;
+}
+
+
+Multigrid::Multigrid(Stencil fine) : last_iterations(0)
+{
+	// Coarsen until the grid is tiny or cannot be reduced any further
+	const size_t min_nodes = 64;
+	const unsigned int max_levels = 20;
+	levels.emplace_back(std::move(fine));
+	while (levels.size() < max_levels && levels.back().A.nNodes() > min_nodes) {
+		const Stencil& A = levels.back().A;
+		if (A.size.x <= 1 && (A.dimensions < 2 || A.size.y <= 1) && (A.dimensions < 3 || A.size.z <= 1))
+			break;
+		levels.emplace_back(A.coarsen());
+	}
+	for (auto& level : levels) {
+		level.x.resize(level.A.nNodes(), 0.0);
+		level.b.resize(level.A.nNodes(), 0.0);
+		level.r.resize(level.A.nNodes(), 0.0);
+	}
+}
+
+void Multigrid::smooth(Level& level, unsigned int n_sweeps, bool zero_guess)
+{
+	// damped jacobi, symmetric such that the V-cycle remains a valid CG preconditioner
+	const double omega = 0.8;
+	const int n = level.A.nNodes();
+	const double* diag = level.A.diag.data();
+	unsigned int s = 0;
+	if (zero_guess && n_sweeps > 0) {
+#pragma omp parallel for
+		for (int i=0; i<n; i++) {
+			level.x[i] = omega * level.b[i] / diag[i];
+		}
+		s++;
+	}
+	for (; s<n_sweeps; s++) {
+		level.A.residual(level.b, level.x, level.r);
+#pragma omp parallel for
+		for (int i=0; i<n; i++) {
+			level.x[i] += omega * level.r[i] / diag[i];
+		}
+	}
+}
+
+void Multigrid::vcycle(unsigned int l)
+{
+	const unsigned int n_sweeps = 2;
+	const unsigned int n_coarse_sweeps = 20;
+	Level& fine = levels[l];
+	if (l+1 == levels.size()) {
+		smooth(fine, n_coarse_sweeps, true);
+		return;
+	}
+
+	smooth(fine, n_sweeps, true);
+	fine.A.residual(fine.b, fine.x, fine.r);
+
+	Level& coarse = levels[l+1];
+	const VINT fs = fine.A.size, cs = coarse.A.size;
+	const bool coarse_y = fine.A.dimensions > 1, coarse_z = fine.A.dimensions > 2;
+	std::fill(coarse.b.begin(), coarse.b.end(), 0.0);
+	// restriction, sum over the aggregates row by row
+#pragma omp parallel for
+	for (int c=0; c<cs.z*cs.y; c++) {
+		const int cz = c / cs.y, cy = c % cs.y;
+		const size_t coarse_row = size_t(c) * cs.x;
+		for (int z = (coarse_z ? 2*cz : 0); z < std::min(coarse_z ? 2*cz+2 : 1, fs.z); z++) {
+			for (int y = (coarse_y ? 2*cy : 0); y < std::min(coarse_y ? 2*cy+2 : 1, fs.y); y++) {
+				const size_t row = (size_t(z) * fs.y + y) * fs.x;
+				for (int x=0; x<fs.x; x++) {
+					coarse.b[coarse_row + x/2] += fine.r[row + x];
+				}
+			}
+		}
+	}
+
+	vcycle(l+1);
+
+	// piecewise constant prolongation
+#pragma omp parallel for
+	for (int z=0; z<fs.z; z++) {
+		for (int y=0; y<fs.y; y++) {
+			const size_t row = (size_t(z) * fs.y + y) * fs.x;
+			const size_t coarse_row = (size_t(coarse_z ? z/2 : 0) * cs.y + (coarse_y ? y/2 : 0)) * cs.x;
+			for (int x=0; x<fs.x; x++) {
+				fine.x[row + x] += coarse.x[coarse_row + x/2];
+			}
+		}
+	}
+
+	smooth(fine, n_sweeps, false);
+}
+
+bool Multigrid::solve(const std::vector<double>& b, std::vector<double>& x, double tolerance, unsigned int max_iterations)
+{
+	const Stencil& A = levels[0].A;
+	const size_t n = A.nNodes();
+	assert(b.size() == n && x.size() == n);
+	r.resize(n); z.resize(n); p.resize(n); q.resize(n);
+
+	const double b_norm = sqrt(dot(b,b));
+	if (b_norm == 0) {
+		std::fill(x.begin(), x.end(), 0.0);
+		last_iterations = 0;
+		return true;
+	}
+
+	auto precondition = [&]() {
+		levels[0].b.swap(r);
+		vcycle(0);
+		levels[0].b.swap(r);
+		z.swap(levels[0].x);
+	};
+
+	A.residual(b, x, r);
+	precondition();
+	p = z;
+	double rz = dot(r,z);
+
+	for (unsigned int it=0; it<=max_iterations; it++) {
+		if (sqrt(dot(r,r)) <= tolerance * b_norm) {
+			last_iterations = it;
+			return true;
+		}
+		if (it == max_iterations)
+			break;
+		A.apply(p, q);
+		const double step = rz / dot(p,q);
+		const int ni = n;
+#pragma omp parallel for
+		for (int i=0; i<ni; i++) {
+			x[i] += step * p[i];
+			r[i] -= step * q[i];
+		}
+		precondition();
+		const double rz_new = dot(r,z);
+		const double beta = rz_new / rz;
+		rz = rz_new;
+#pragma omp parallel for
+		for (int i=0; i<ni; i++) {
+			p[i] = z[i] + beta * p[i];
+		}
+	}
+	last_iterations = max_iterations;
+	return false;
+}
+
+}
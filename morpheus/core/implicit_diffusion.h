@@ -0,0 +1,97 @@
+//////
+//
+// This file is part of the modelling and simulation framework 'Morpheus',
+// and is made available under the terms of the BSD 3-clause license (see LICENSE
+// file that comes with the distribution or https://opensource.org/licenses/BSD-3-Clause).
+//
+// Authors:  Joern Starruss and Walter de Back
+// Copyright 2009-2016, Technische Universität Dresden, Germany
+//
+//////
+
+#ifndef IMPLICIT_DIFFUSION_H
+#define IMPLICIT_DIFFUSION_H
+
+#include <array>
+#include <vector>
+#include "domain.h"
+
+/** @brief Building blocks of the implicit diffusion solvers of the PDE_Layer.
+ *
+ *  Both solvers advance an implicit euler step (I - alpha L) u' = u on orthogonal lattices, which is
+ *  unconditionally stable. The discrete laplacian L is described per node by the Link to each of its
+ *  face neighbors, indexed by the Boundary::Codes of the direction.
+ */
+namespace ImplicitDiffusion {
+
+	/// Coupling of a node to its neighbor in one direction
+	enum class Link : unsigned char {
+		None,     ///< no flux
+		Coupled,  ///< flux to a free neighbor, which is solved for
+		Fixed     ///< flux to a neighbor of constant value, which enters the right hand side
+	};
+	typedef std::array<Link, Boundary::nCodes> Links;
+
+	/** @brief Solve @p width interleaved tridiagonal systems by the Thomas algorithm.
+	 *
+	 *  Row i of system w is stored at index i * width + w and reads lower[i] x[i-1] + diag[i] x[i] + upper[i] x[i+1] = x[i],
+	 *  i.e. @p x holds the right hand side on entry and the solution on return. Interleaving allows to solve the lines
+	 *  along y and z in contiguous x rows. The corner elements lower[0] and upper[n-1] couple to x[n-1] and x[0],
+	 *  respectively, which makes the system cyclic and is solved by the Sherman-Morrison formula.
+	 *  All arrays must be of equal size and are overwritten. The matrices must be diagonally dominant.
+	 */
+	void solveTridiagonal(std::vector<double>& lower, std::vector<double>& diag, std::vector<double>& upper, std::vector<double>& x, unsigned int width, std::vector<double>& work);
+
+	/** @brief Symmetric (2 * dimensions + 1)-point operator on a compact grid
+	 *
+	 *  (A x)[i] = diag[i] * x[i] - sum_k coupling[k][i] * x[neighbor k of i]
+	 *
+	 *  Neighbors always wrap around the grid, such that couplings at the grid boundary must vanish if not periodic.
+	 */
+	struct Stencil {
+		VINT size;
+		unsigned int dimensions;
+		std::vector<double> diag;
+		std::array<std::vector<double>, Boundary::nCodes> coupling;
+
+		Stencil(const VINT& size, unsigned int dimensions);
+		size_t nNodes() const { return diag.size(); }
+		/// r = b - A x
+		void residual(const std::vector<double>& b, const std::vector<double>& x, std::vector<double>& r) const;
+		/// y = A x
+		void apply(const std::vector<double>& x, std::vector<double>& y) const;
+		/// Galerkin coarse operator of aggregates of 2^dimensions nodes
+		Stencil coarsen() const;
+	};
+
+	/** @brief Multigrid preconditioned conjugate gradient solver for a Stencil
+	 *
+	 *  The grid hierarchy is built by piecewise constant aggregation with Galerkin coarse operators, which keeps
+	 *  domain masks and periodic boundaries consistent on all levels. A symmetric V-cycle with damped Jacobi
+	 *  smoothing serves as preconditioner for the conjugate gradient iteration.
+	 */
+	class Multigrid {
+	public:
+		explicit Multigrid(Stencil fine);
+		/// Solve A x = b, where @p x holds the initial guess. Returns false if the relative residual did not drop below @p tolerance within @p max_iterations.
+		bool solve(const std::vector<double>& b, std::vector<double>& x, double tolerance, unsigned int max_iterations);
+		unsigned int nLevels() const { return levels.size(); }
+		/// Number of iterations of the last solve
+		unsigned int iterations() const { return last_iterations; }
+	private:
+		struct Level {
+			Stencil A;
+			std::vector<double> x, b, r;
+			Level(Stencil A) : A(std::move(A)) {};
+		};
+		std::vector<Level> levels;
+		std::vector<double> r, z, p, q;
+		unsigned int last_iterations;
+		/// Apply the V-cycle to levels[l].b, result is stored in levels[l].x
+		void vcycle(unsigned int l);
+		/// Jacobi sweeps on levels.x, which is assumed zero if @p zero_guess
+		void smooth(Level& level, unsigned int n_sweeps, bool zero_guess);
+	};
+}
+
+#endif // IMPLICIT_DIFFUSION_H
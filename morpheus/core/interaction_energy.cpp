@@ -168,6 +168,14 @@ void InteractionEnergy::init(const Scope* scope)
 		ia_neighborhood_offsets.push_back(layer->get_data_index(neighbor) - origin_offset);
 	}
 	
+	const auto& union_neighbors = CPM::getNeighborhoodUnion()->getStencil();
+	for (auto neighbor : ia_neighborhood) {
+		auto it = find(union_neighbors.begin(), union_neighbors.end(), neighbor);
+		if (it == union_neighbors.end())
+			throw string("InteractionEnergy: Interaction neighbor ") + to_str(neighbor) + " is not part of the update neighborhood union.";
+		ia_union_indices.push_back(it - union_neighbors.begin());
+	}
+	
 	auto celltypes = CPM::getCellTypes();
 	
 	for (auto& interaction : ia_energies2) {
@@ -340,14 +348,14 @@ double InteractionEnergy::delta(const CPM::Update& update) const {
 #endif
 	} else {
 		// no collapsed neigbors ...
-		int focus_offset = layer->get_data_index(update.focus().pos());
-#ifdef __GNUC__
-		for (uint k=0; k<ia_neighborhood_row_offsets.size(); ++k ) {
-			__builtin_prefetch(&layer->data[ focus_offset + ia_neighborhood_row_offsets[k]],0,1);
-		}
-#endif
 #ifdef HAVE_SUPERCELLS
 		if (interaction_details & IA_SUPERCELLS) {
+			int focus_offset = layer->get_data_index(update.focus().pos());
+#ifdef __GNUC__
+			for (uint k=0; k<ia_neighborhood_row_offsets.size(); ++k ) {
+				__builtin_prefetch(&layer->data[ focus_offset + ia_neighborhood_row_offsets[k]],0,1);
+			}
+#endif
 			if (interaction_details & IA_PLUGINS) {
 				for (uint i=0; i<ia_neighborhood_offsets.size(); i++) {
 					const CPM::STATE& neighbor_state = layer->data[ focus_offset + ia_neighborhood_offsets[i] ];
@@ -396,13 +404,15 @@ double InteractionEnergy::delta(const CPM::Update& update) const {
 #endif // HAVE_SUPERCELLS
 			// no supercells
 			// no collapsed neigbors ...
+			// Neighbor states are taken from the update's neighborhood union, which is gathered once per update
+			const CPM::CELL_ID* union_states = update.neighborhoodUnion()->getStates();
 			if (interaction_details & IA_PLUGINS) {
 				CPM::STATE neighbor_state;
 				neighbor_state.pos = update.focus().pos();
 				
 				CPM::setInteractionSurface(true);
 				for (uint i=0; i<ia_neighborhood_offsets.size(); i++) {
-					SymbolFocus neighbor_focus(layer->data[ focus_offset + ia_neighborhood_offsets[i]].cell_id, update.focus().pos() + ia_neighborhood[i]);
+					SymbolFocus neighbor_focus(union_states[ ia_union_indices[i] ], update.focus().pos() + ia_neighborhood[i]);
 					
 					if (update.focus().cellID() != neighbor_focus.cellID()) {
 						double interaction_remove = getBaseInteraction(update.focus(), neighbor_focus);
@@ -425,7 +435,7 @@ double InteractionEnergy::delta(const CPM::Update& update) const {
 			}
 			else {
 				for (uint i=0; i<ia_neighborhood_offsets.size(); i++) {
-					SymbolFocus neighbor_focus(layer->data[ focus_offset + ia_neighborhood_offsets[i]].cell_id, update.focus().pos() + ia_neighborhood[i]);
+					SymbolFocus neighbor_focus(union_states[ ia_union_indices[i] ], update.focus().pos() + ia_neighborhood[i]);
 					if ( update.focus().cellID() != neighbor_focus.cellID() ) {
 						dH -= getBaseInteraction(update.focus(), neighbor_focus);
 					}
@@ -58,6 +58,7 @@ class InteractionEnergy : public Plugin {
 		double boundaryLenghScaling;
 		vector<VINT> ia_neighborhood;
 		vector<int> ia_neighborhood_offsets;
+		vector<uint> ia_union_indices;
 		vector<int> ia_neighborhood_row_offsets;
 		XMLNode ia_XMLNode;
 		bool negate_interactions;
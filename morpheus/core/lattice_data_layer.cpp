@@ -403,6 +403,20 @@ template <class T> valarray<T> Lattice_Data_Layer<T>::getData() const {
 	return data[gslice(get_data_index(VINT(0,0,0)),sizes,strides)];
 }
 
+template <class T> void Lattice_Data_Layer<T>::setData(const valarray<T>& values) {
+	assert(values.size() == size_t(l_size.x * l_size.y * l_size.z));
+	valarray<size_t> sizes(3);
+	sizes[0] = l_size.z;
+	sizes[1] = l_size.y;
+	sizes[2] = l_size.x;
+	valarray<size_t> strides(3);
+	strides[0] = shadow_size.x * shadow_size.y;
+	strides[1] = shadow_size.x;
+	strides[2] = 1;
+	data[gslice(get_data_index(VINT(0,0,0)),sizes,strides)] = values;
+	reset_boundaries();
+}
+
 template <class T> 
 vector<VINT> Lattice_Data_Layer<T>::optimizeNeighborhood(const vector<VINT>& a) const {
 	vector<VINT> t(a);
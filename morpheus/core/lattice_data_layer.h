@@ -73,6 +73,8 @@ public:
 	bool writable_resolve(VINT& a, Boundary::Type& b) const;
 	DEPRECATED T& get_writable(VINT a);
 	valarray<T> getData() const;
+	/// Overwrite the lattice data with @p values in the order of getData()
+	void setData(const valarray<T>& values);
 	Boundary::Type getBoundaryType(Boundary::Codes code) const;
 	void set_boundary_value(Boundary::Codes code, value_type a) { boundary_values[code] = make_shared<DefaultValueReader>(a); };
 	void set_domain_value(value_type a) { domain_value = make_shared<DefaultValueReader>(a); }
@@ -133,6 +135,7 @@ protected:
 	
 	friend class Domain;
 	friend class LatticeStencil;
+	friend class UnionLatticeStencil;
 	friend class StatisticalLatticeStencil;
 	friend class InteractionEnergy;  // Neighborhood per node -- not using the stencil implementation
 	friend class MembraneMapper;
@@ -110,7 +110,7 @@ public:
 			membrane_pde->data = static_pointer_cast<MembraneProperty>(other)->membrane_pde->data;
 		}
 		else if (dynamic_pointer_cast<Property<double,double>>(other)) {
-			membrane_pde->data = static_pointer_cast<Property<double,double>>(other)->value;
+			membrane_pde->data = static_pointer_cast<Property<double,double>>(other)->value();
 		}
 		else 
 			throw string("Failed to assign non-matching Property to MembraneProperty ");
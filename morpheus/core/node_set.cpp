@@ -0,0 +1,59 @@
+#include "node_set.h"
+
+void FlatNodeSet::reserve(size_t n)
+{
+	size_t n_slots = 16;
+	while (n_slots < 2 * n) n_slots *= 2;
+	if (n_slots > slots.size())
+		rehash(n_slots);
+	nodes.reserve(n);
+}
+
+void FlatNodeSet::rehash(size_t n_slots)
+{
+	slots.assign(n_slots, 0);
+	mask = n_slots - 1;
+	shift = 64;
+	while (n_slots > 1) { n_slots >>= 1; shift--; }
+	for (size_t i=0; i<nodes.size(); i++) {
+		size_t s = home(nodes[i]);
+		while (slots[s]) s = (s+1) & mask;
+		slots[s] = i+1;
+	}
+}
+
+size_t FlatNodeSet::erase(const VINT& node)
+{
+	size_t s = findSlot(node);
+	if (s == npos) return 0;
+	size_t idx = slots[s] - 1;
+
+	// Backward shift deletion, move entries of the probe sequence into the hole unless that passes their home slot
+	size_t hole = s;
+	size_t next = (s+1) & mask;
+	while (slots[next]) {
+		size_t h = home(nodes[slots[next]-1]);
+		if ( ((next - h) & mask) >= ((next - hole) & mask) ) {
+			slots[hole] = slots[next];
+			hole = next;
+		}
+		next = (next+1) & mask;
+	}
+	slots[hole] = 0;
+
+	// Move the last node into the erased place
+	size_t last = nodes.size() - 1;
+	if (idx != last) {
+		nodes[idx] = nodes[last];
+		size_t t = home(nodes[idx]);
+		while (slots[t] != last+1) t = (t+1) & mask;
+		slots[t] = idx+1;
+	}
+	nodes.pop_back();
+
+	if (nodes.empty())
+		clear();
+	else if (slots.size() > 16 && 8 * nodes.size() < slots.size())
+		rehash(slots.size() / 2);
+	return 1;
+}
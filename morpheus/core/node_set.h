@@ -0,0 +1,94 @@
+//////
+//
+// This file is part of the modelling and simulation framework 'Morpheus',
+// and is made available under the terms of the BSD 3-clause license (see LICENSE
+// file that comes with the distribution or https://opensource.org/licenses/BSD-3-Clause).
+//
+// Authors:  Joern Starruss and Walter de Back
+// Copyright 2009-2016, Technische Universität Dresden, Germany
+//
+//////
+
+#ifndef NODE_SET_H
+#define NODE_SET_H
+
+#include "vec.h"
+
+/** @brief Flat hash set of lattice nodes
+ *
+ *  Drop-in replacement for set<VINT,less_VINT> as node container of cells (see CPMShape::Nodes).
+ *  The nodes are kept in one contiguous vector, that is indexed by an open addressing hash table with linear probing.
+ *  Erasing a node moves the last node into its place, thus iteration order is not sorted, but deterministic.
+ *  Iterators are invalidated by any modification of the set.
+ */
+class FlatNodeSet {
+public:
+	typedef VINT key_type;
+	typedef VINT value_type;
+	typedef size_t size_type;
+	typedef vector<VINT>::const_iterator const_iterator;
+	typedef const_iterator iterator;
+
+	FlatNodeSet() : shift(64), mask(0) {};
+	template <class InputIt>
+	FlatNodeSet(InputIt first, InputIt last) : FlatNodeSet() { insert(first, last); }
+
+	const_iterator begin() const { return nodes.begin(); }
+	const_iterator end() const { return nodes.end(); }
+	const_iterator cbegin() const { return nodes.begin(); }
+	const_iterator cend() const { return nodes.end(); }
+	size_t size() const { return nodes.size(); }
+	bool empty() const { return nodes.empty(); }
+	void clear() { nodes.clear(); slots.clear(); shift = 64; mask = 0; }
+	void reserve(size_t n);
+
+	pair<const_iterator, bool> insert(const VINT& node) {
+		if (2 * (nodes.size() + 1) > slots.size())
+			rehash(max(size_t(16), 2 * slots.size()));
+		size_t s = home(node);
+		while (slots[s]) {
+			if (nodes[slots[s]-1] == node)
+				return make_pair(nodes.begin() + (slots[s]-1), false);
+			s = (s+1) & mask;
+		}
+		nodes.push_back(node);
+		slots[s] = nodes.size();
+		return make_pair(nodes.end() - 1, true);
+	}
+	/// The hint is ignored
+	const_iterator insert(const_iterator, const VINT& node) { return insert(node).first; }
+	template <class InputIt>
+	void insert(InputIt first, InputIt last) { for (; first != last; ++first) insert(*first); }
+
+	size_t erase(const VINT& node);
+	/// Returns an iterator to the node moved into the place of the erased one
+	const_iterator erase(const_iterator pos) { auto i = pos - nodes.begin(); erase(VINT(*pos)); return nodes.begin() + i; }
+
+	const_iterator find(const VINT& node) const { size_t s = findSlot(node); return s == npos ? nodes.end() : nodes.begin() + (slots[s]-1); }
+	size_t count(const VINT& node) const { return findSlot(node) != npos; }
+
+private:
+	static const size_t npos = size_t(-1);
+	/// Home slot of a node. The key is the linear index of the node in a virtual lattice of 2^21 x 2^21 x 2^22 nodes, spread by Fibonacci hashing.
+	size_t home(const VINT& node) const {
+		uint64_t key = uint64_t(uint32_t(node.x)) ^ (uint64_t(uint32_t(node.y)) << 21) ^ (uint64_t(uint32_t(node.z)) << 42);
+		return (key * 0x9E3779B97F4A7C15ull) >> shift;
+	}
+	size_t findSlot(const VINT& node) const {
+		if (nodes.empty()) return npos;
+		size_t s = home(node);
+		while (slots[s]) {
+			if (nodes[slots[s]-1] == node) return s;
+			s = (s+1) & mask;
+		}
+		return npos;
+	}
+	void rehash(size_t n_slots);
+
+	vector<VINT> nodes;
+	vector<uint32_t> slots; ///< 1-based index into nodes, 0 marks an empty slot
+	uint shift;
+	size_t mask;
+};
+
+#endif // NODE_SET_H
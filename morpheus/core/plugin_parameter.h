@@ -324,6 +324,8 @@ public:
 	const SymbolBase::Flags& flags() const { RequirementPolicy::assertDefined(); return evaluator->flags(); }
 	Granularity granularity() const { RequirementPolicy::assertDefined(); return evaluator->getGranularity();}
 	bool isInteger() const { RequirementPolicy::assertDefined(); return evaluator->isInteger(); }
+	/// Expression is constant in space and time and does not depend on local variables
+	bool isConst() const { RequirementPolicy::assertDefined(); return evaluator->isConst(); }
 	
 	set<SymbolDependency> getDependSymbols() const { 
 		if (RequirementPolicy::isMissing())
@@ -0,0 +1,260 @@
+#include "profiler.h"
+#include "rss_stat.h"
+#include <mutex>
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace pt = boost::property_tree;
+
+ProfileCounter::ProfileCounter(const string& category, const string& name) : slots(max(1, omp_get_max_threads())), _category(category), _name(name) {}
+
+uint64_t ProfileCounter::calls() const
+{
+	uint64_t n = 0;
+	for (const auto& s : slots) n += s.calls;
+	return n;
+}
+
+uint64_t ProfileCounter::time() const
+{
+	uint64_t t = 0;
+	for (const auto& s : slots) t += s.time;
+	return t;
+}
+
+bool Profiler::is_enabled = false;
+
+namespace {
+
+std::mutex counters_mutex;
+map< pair<string,string>, shared_ptr<ProfileCounter> > counters;
+/// Calls and time of the counters at the last sample
+map< ProfileCounter*, pair<uint64_t,uint64_t> > counters_sampled;
+
+struct MCSStats { uint64_t steps = 0, attempts = 0, vetoed = 0, accepted = 0; };
+MCSStats mcs_total, mcs_sampled;
+
+/// Hardware counter with one perf event per thread of the OpenMP team
+struct HardwareCounter { string name; vector<int> fds; uint64_t total; uint64_t sampled; };
+vector<HardwareCounter> hardware_counters;
+
+pt::ptree samples;
+double last_sample_walltime = 0;
+
+void openHardwareCounters()
+{
+#ifdef __linux__
+	vector< pair<string,uint64_t> > events = {
+		{ "cycles", PERF_COUNT_HW_CPU_CYCLES },
+		{ "instructions", PERF_COUNT_HW_INSTRUCTIONS },
+		{ "cache-references", PERF_COUNT_HW_CACHE_REFERENCES },
+		{ "cache-misses", PERF_COUNT_HW_CACHE_MISSES },
+		{ "branch-misses", PERF_COUNT_HW_BRANCH_MISSES }
+	};
+	for (const auto& event : events) {
+		hardware_counters.push_back({event.first, {}, 0, 0});
+	}
+	// Counts of inherited events only reach the parent when a thread exits, thus every thread
+	// of the OpenMP team opens its own events. Threads created later on are not counted.
+	int n_threads = max(1, omp_get_max_threads());
+	vector< vector<int> > thread_fds(n_threads, vector<int>(events.size(), -1));
+	vector<int> errors(events.size(), 0);
+#pragma omp parallel num_threads(n_threads)
+	{
+		auto& fds = thread_fds[omp_get_thread_index()];
+		for (uint i=0; i<events.size(); i++) {
+			perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.size = sizeof(attr);
+			attr.config = events[i].second;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+			if (fds[i] < 0) {
+#pragma omp critical
+				errors[i] = errno;
+			}
+		}
+	}
+	for (uint i=0; i<events.size(); i++) {
+		for (const auto& fds : thread_fds) {
+			if (fds[i] >= 0) hardware_counters[i].fds.push_back(fds[i]);
+		}
+		// A counter missing on some threads would be incomplete
+		if (errors[i]) {
+			cout << "Profiler: Hardware counter " << events[i].first << " is not available (" << strerror(errors[i]) << ")" << endl;
+			for (int fd : hardware_counters[i].fds) close(fd);
+			hardware_counters[i].fds.clear();
+		}
+	}
+	hardware_counters.erase(remove_if(hardware_counters.begin(), hardware_counters.end(), [](const HardwareCounter& hc) { return hc.fds.empty(); }), hardware_counters.end());
+#else
+	cout << "Profiler: Hardware counters are only available on Linux" << endl;
+#endif
+}
+
+void readHardwareCounters()
+{
+#ifdef __linux__
+	for (auto& hc : hardware_counters) {
+		uint64_t total = 0;
+		for (int fd : hc.fds) {
+			uint64_t value;
+			if (read(fd, &value, sizeof(value)) == sizeof(value))
+				total += value;
+		}
+		hc.total = total;
+	}
+#endif
+}
+
+void closeHardwareCounters()
+{
+#ifdef __linux__
+	for (const auto& hc : hardware_counters) {
+		for (int fd : hc.fds) close(fd);
+	}
+#endif
+	hardware_counters.clear();
+}
+
+pt::ptree counterEntry(const ProfileCounter& counter, uint64_t calls, uint64_t time)
+{
+	pt::ptree entry;
+	entry.put("category", counter.category());
+	entry.put("name", counter.name());
+	entry.put("calls", calls);
+	entry.put("time", time * 1e-9);
+	return entry;
+}
+
+}
+
+void Profiler::enable(bool hardware)
+{
+	is_enabled = true;
+	last_sample_walltime = get_wall_time();
+	if (hardware)
+		openHardwareCounters();
+}
+
+shared_ptr<ProfileCounter> Profiler::counter(const string& category, const string& name)
+{
+	if (!is_enabled) return nullptr;
+	std::lock_guard<std::mutex> lock(counters_mutex);
+	auto& c = counters[make_pair(category, name)];
+	if (!c)
+		c = make_shared<ProfileCounter>(category, name);
+	return c;
+}
+
+void Profiler::recordMCS(uint64_t attempts, uint64_t vetoed, uint64_t accepted)
+{
+	mcs_total.steps++;
+	mcs_total.attempts += attempts;
+	mcs_total.vetoed += vetoed;
+	mcs_total.accepted += accepted;
+}
+
+void Profiler::sample(double time)
+{
+	if (!is_enabled) return;
+	pt::ptree sample;
+	sample.put("time", time);
+	double walltime = get_wall_time();
+	sample.put("runtime", walltime - last_sample_walltime);
+	last_sample_walltime = walltime;
+
+	uint64_t steps = mcs_total.steps - mcs_sampled.steps;
+	if (steps > 0) {
+		pt::ptree cpm;
+		cpm.put("mcs", steps);
+		// Averages per Monte Carlo step
+		cpm.put("attempts", double(mcs_total.attempts - mcs_sampled.attempts) / steps);
+		cpm.put("vetoed", double(mcs_total.vetoed - mcs_sampled.vetoed) / steps);
+		cpm.put("accepted", double(mcs_total.accepted - mcs_sampled.accepted) / steps);
+		cpm.put("rejected", double((mcs_total.attempts - mcs_total.accepted) - (mcs_sampled.attempts - mcs_sampled.accepted)) / steps);
+		sample.add_child("cpm", cpm);
+	}
+	mcs_sampled = mcs_total;
+
+	if (!hardware_counters.empty()) {
+		readHardwareCounters();
+		pt::ptree hardware;
+		for (auto& hc : hardware_counters) {
+			hardware.put(hc.name, hc.total - hc.sampled);
+			hc.sampled = hc.total;
+		}
+		sample.add_child("hardware", hardware);
+	}
+
+	pt::ptree sampled_counters;
+	std::lock_guard<std::mutex> lock(counters_mutex);
+	for (const auto& c : counters) {
+		auto& last = counters_sampled[c.second.get()];
+		uint64_t calls = c.second->calls(), time = c.second->time();
+		if (calls > last.first)
+			sampled_counters.push_back(make_pair("", counterEntry(*c.second, calls - last.first, time - last.second)));
+		last = make_pair(calls, time);
+	}
+	if (!sampled_counters.empty())
+		sample.add_child("counters", sampled_counters);
+
+	samples.push_back(make_pair("", sample));
+}
+
+void Profiler::write(pt::ptree& perf_json)
+{
+	if (!is_enabled) return;
+	pt::ptree profile;
+
+	pt::ptree totals;
+	if (mcs_total.steps > 0) {
+		pt::ptree cpm;
+		cpm.put("mcs", mcs_total.steps);
+		cpm.put("attempts", mcs_total.attempts);
+		cpm.put("vetoed", mcs_total.vetoed);
+		cpm.put("accepted", mcs_total.accepted);
+		cpm.put("rejected", mcs_total.attempts - mcs_total.accepted);
+		totals.add_child("cpm", cpm);
+	}
+
+	if (!hardware_counters.empty()) {
+		readHardwareCounters();
+		pt::ptree hardware;
+		for (const auto& hc : hardware_counters) {
+			hardware.put(hc.name, hc.total);
+		}
+		totals.add_child("hardware", hardware);
+		closeHardwareCounters();
+	}
+
+	// Most expensive counters first
+	vector< shared_ptr<ProfileCounter> > sorted;
+	for (const auto& c : counters) {
+		if (c.second->calls() > 0) sorted.push_back(c.second);
+	}
+	sort(sorted.begin(), sorted.end(), [](const shared_ptr<ProfileCounter>& a, const shared_ptr<ProfileCounter>& b) { return a->time() > b->time(); });
+	pt::ptree total_counters;
+	for (const auto& c : sorted) {
+		total_counters.push_back(make_pair("", counterEntry(*c, c->calls(), c->time())));
+	}
+	totals.add_child("counters", total_counters);
+
+	profile.add_child("totals", totals);
+	profile.add_child("samples", samples);
+	perf_json.add_child("profile", profile);
+
+	// Reset for another simulation run
+	counters.clear();
+	counters_sampled.clear();
+	mcs_total = mcs_sampled = MCSStats();
+	samples.clear();
+}
@@ -0,0 +1,84 @@
+//////
+//
+// This file is part of the modelling and simulation framework 'Morpheus',
+// and is made available under the terms of the BSD 3-clause license (see LICENSE
+// file that comes with the distribution or https://opensource.org/licenses/BSD-3-Clause).
+//
+// Authors:  Joern Starruss and Walter de Back
+// Copyright 2009-2016, Technische Universität Dresden, Germany
+//
+//////
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "config.h"
+#include <chrono>
+#include <boost/property_tree/ptree.hpp>
+
+/** @brief Call counter and accumulated run time of an instrumented hot path
+ *
+ *  Threads accumulate into separate slots, indexed by omp_get_thread_index().
+ */
+class ProfileCounter {
+public:
+	ProfileCounter(const string& category, const string& name);
+	/// Count a call
+	void count() { slots[omp_get_thread_index()].calls++; }
+	/// Count a call that took @p ns nanoseconds
+	void add(uint64_t ns) { Slot& s = slots[omp_get_thread_index()]; s.calls++; s.time += ns; }
+
+	const string& category() const { return _category; }
+	const string& name() const { return _name; }
+	uint64_t calls() const;
+	/// Accumulated run time in nanoseconds
+	uint64_t time() const;
+
+private:
+	/// Padded to a cache line to prevent false sharing
+	struct Slot { uint64_t calls = 0; uint64_t time = 0; uint64_t padding[6]; };
+	vector<Slot> slots;
+	string _category, _name;
+};
+
+/// Adds the life time of the scope to a ProfileCounter, no-op for a null counter
+class ProfileTimer {
+public:
+	ProfileTimer(ProfileCounter* counter) : counter(counter) { if (counter) start = std::chrono::steady_clock::now(); }
+	~ProfileTimer() { if (counter) counter->add( std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() ); }
+private:
+	ProfileCounter* counter;
+	std::chrono::steady_clock::time_point start;
+};
+
+/** @brief Hot-path profiler, enabled with --perf-stats
+ *
+ *  Instrumented code obtains its ProfileCounter once during initialisation, and only if the profiler is enabled.
+ *  Thus, a disabled profiler costs a null pointer test per instrumented call.
+ *
+ *  The counters, the CPM copy attempt statistics and, optionally, hardware counters (Linux perf events)
+ *  are sampled into a time series that is written to performance.json.
+ *  Hardware counters are opened per thread of the OpenMP team when the profiler is enabled and closed once written.
+ */
+class Profiler {
+public:
+	/// Enable the profiler, must be called before the model is initialised
+	static void enable(bool hardware_counters);
+	static bool enabled() { return is_enabled; }
+
+	/// Get the counter for @p name in @p category, returns null if the profiler is disabled
+	static shared_ptr<ProfileCounter> counter(const string& category, const string& name);
+
+	/// Record the copy attempts of a Monte Carlo step, and how many of them were vetoed by update checkers or accepted.
+	static void recordMCS(uint64_t attempts, uint64_t vetoed, uint64_t accepted);
+
+	/// Add a sample of all quantities accumulated since the last sample
+	static void sample(double time);
+	/// Write the time series and the totals as child 'profile' of @p perf_json and reset the profiler
+	static void write(boost::property_tree::ptree& perf_json);
+
+private:
+	static bool is_enabled;
+};
+
+#endif // PROFILER_H
@@ -202,9 +202,9 @@ public:
 			else
 				initializing = true;
 			if (initializer)
-				this->value = initializer->get(f);
+				this->value() = initializer->get(f);
 			else
-				this->value = parent->getInitValue(f);
+				this->value() = parent->getInitValue(f);
 			initializing = false;
 			initialized = true;
 		}
@@ -240,7 +240,7 @@ class ConstantSymbol : public PrimitiveConstantSymbol<T> {
 	public:
 		ConstantSymbol( Container<T>* parent ) : PrimitiveConstantSymbol<T>(parent->getSymbol(), "", T()), parent(parent) { };
 		std::string linkType() const override { return "ConstantLink"; }
-		void init() override { this->value = parent->getInitValue(SymbolFocus::global); }
+		void init() override { this->value = parent->getInitValue(SymbolFocus::global); this->touch(); }
 		const string& description() const override { return parent->getDescription(); }
 		const std::string XMLPath() const override { return getXMLPath(parent->saveToXML()); };
 		
@@ -262,7 +262,7 @@ class VariableSymbol : public PrimitiveVariableSymbol<T> {
 	public:
 		VariableSymbol(Container<T>* parent ) : PrimitiveVariableSymbol<T>(parent->getSymbol(), "", T()), parent(parent) { };
 		std::string linkType() const override { return "VariableLink"; }
-		void init() override { this->value = parent->getInitValue(SymbolFocus::global); }
+		void init() override { this->value = parent->getInitValue(SymbolFocus::global); this->touch(); }
 		const string& description() const override { return parent->getDescription(); }
 		const std::string XMLPath() const override { return getXMLPath(parent->saveToXML()); };
 		
@@ -285,7 +285,7 @@ class PropertySymbol : public PrimitivePropertySymbol<T> {
 		std::string linkType() const override { return "CellPropertyLink"; }
 		const string& description() const override { return parent->getDescription();}
 		const std::string XMLPath() const override { return getXMLPath(parent->saveToXML()); };
-		typename TypeInfo<T>::SReturn get(const SymbolFocus& f) const override { return getCellProperty(f)->value; }
+		typename TypeInfo<T>::SReturn get(const SymbolFocus& f) const override { return this->column->values[this->slot(f)]; }
 		typename TypeInfo<T>::SReturn safe_get(const SymbolFocus& f) const override {
 			if (!this->flags().initialized) {
 				this->safe_init();
@@ -294,7 +294,7 @@ class PropertySymbol : public PrimitivePropertySymbol<T> {
 			auto p=getCellProperty(f);
 			if (!p->initialized) p->init(f);
 				
-			return p->value;
+			return p->value();
 		}
 		
 		void setInitializer(shared_ptr<ExpressionEvaluator<T>> initializer, SymbolFocus f) const {
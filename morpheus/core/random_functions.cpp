@@ -7,30 +7,30 @@ typedef std::normal_distribution<double> RNG_GaussDist;
 typedef std::gamma_distribution<double> RNG_GammaDist;
 
 bool getRandomBool() {
-	return random_engines[ omp_get_thread_num() ]()<random_engines[ omp_get_thread_num() ].max()/2;
+	return random_engines[ omp_get_thread_index() ]()<random_engines[ omp_get_thread_index() ].max()/2;
 }
 
 double getRandom01() {
 	static uniform_real_distribution <double> rnd(0.0,1.0);
-	return rnd(random_engines[omp_get_thread_num()]);
+	return rnd(random_engines[omp_get_thread_index()]);
 }
 
 // random gaussian distribution of stddev s
 double getRandomGauss(double s) {
 	RNG_GaussDist rnd( 0.0, s);
-	return rnd(random_engines[omp_get_thread_num()]);
+	return rnd(random_engines[omp_get_thread_index()]);
 }
 
 double getRandomGamma(double shape, double scale) {
 
     RNG_GammaDist rnd( shape );
-    return scale*rnd(random_engines[omp_get_thread_num()]);
+    return scale*rnd(random_engines[omp_get_thread_index()]);
 
 }
 
 uint getRandomUint(uint max_val) {
 	uniform_int_distribution<uint> rnd(0,max_val);
-    return rnd(random_engines[omp_get_thread_num()]);
+    return rnd(random_engines[omp_get_thread_index()]);
 }
 
 void setRandomSeed(uint random_seed)
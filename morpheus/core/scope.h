@@ -330,6 +330,8 @@ public:
 	const SymbolBase::Flags & flags() const override {
 		return v_sym->flags();
 	};
+	/// Components share the flags and thus also the change stamp of the vector symbol
+	uint64_t stamp() const override { return v_sym->stamp(); }
 	const string& description() const override { return v_sym->description(); }
 	string linkType() const override { return "VectorComponentLink"; }
 	std::set<SymbolDependency> dependencies() const override { return { v_sym }; }
@@ -8,6 +8,9 @@
 #include "simulation_p.h"
 #include "cpm_p.h"
 #include "rss_stat.h"
+#include "async_output.h"
+#include "checkpoint.h"
+#include "profiler.h"
 #include <boost/program_options.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
@@ -345,7 +348,10 @@ bool init(int argc, char *argv[]) {
 		("no-gnuplot","Disable gnuplot support.")
 		("file,f", po::value<std::string>(),"MorpheuML model to simulate.")
 		("set,set-symbol,s", po::value<std::vector<std::string>>(), "Override initial value of global symbol. Use assignment syntax [symbol=value].")
-		("perf-stats", "Generate performance stats in json format.")
+		("perf-stats", "Generate performance stats in json format, including a profile of the CPM and expression hot paths.")
+		("perf-counters", "Also record hardware counters (Linux perf events) with --perf-stats.")
+		("task-graph", "Run independent plugins of the same scheduling phase concurrently.")
+		("interpret-expressions", "Evaluate expressions with the plain bytecode interpreter instead of compiled register tapes.")
 		("outdir", po::value<std::string>(), "override output directory.")
 		("model-graph", po::value<std::string>()->implicit_value("dot"), "Generate the model graph in the given format [dot,svg,pdf,png].")
 		("help,h", "show this help page.");
@@ -436,6 +442,10 @@ bool init(int argc, char *argv[]) {
 	}
 	
 	generate_performance_stats = cmd_line.count("perf-stats");
+	if (generate_performance_stats)
+		Profiler::enable(cmd_line.count("perf-counters"));
+	mu::ParserBase::EnableTape( ! cmd_line.count("interpret-expressions") );
+	TimeScheduler::setTaskGraph( cmd_line.count("task-graph") );
 
 	
 	// Attach global overrides to the global scope
@@ -470,6 +480,11 @@ bool init(int argc, char *argv[]) {
 // 	}
 // 	cout << endl;
  
+	// Data files referenced by the model, e.g. binary checkpoint data, are located relative to the model
+	auto dir_sep = filename.find_last_of('/');
+	if (dir_sep != string::npos)
+		input_directory = filename.substr(0, max(dir_sep, size_t(1)));
+	
 	try {
 		init(readFile(filename), overrides);
 	}
@@ -530,6 +545,8 @@ bool init(string model, map<string,string> overrides) {
 void finalize() {
 	TimeScheduler::finish();
 	wipe();
+	// Wait for the output written in background
+	AsyncOutputFile::sync();
 }
 
 void setRandomSeeds( const XMLNode xNode ){
@@ -706,15 +723,25 @@ void loadFromXML(const XMLNode xNode) {
 
 
 void saveToXML() {
+	XMLNode xTimeNode = TimeScheduler::saveToXML();
+	string format = "xml";
+	getXMLAttribute(xTimeNode, "SaveInterval/format", format);
+	const bool binary = (format == "binary");
+
 	ostringstream filename("");
-	filename << fileTitle << setfill('0') << setw(6) << getTimeName() << ".xml.gz";
+	filename << fileTitle << setfill('0') << setw(6) << getTimeName();
+	// Bulk data of binary checkpoints is written to a separate file while the snapshot is assembled
+	unique_ptr<Checkpoint::Writer> binary_writer;
+	if (binary)
+		binary_writer = unique_ptr<Checkpoint::Writer>(new Checkpoint::Writer(filename.str() + ".bin"));
+	filename << ".xml.gz";
 	cout << "Saving " << filename.str()<< endl;
 
 	xMorphModel = XMLNode::createXMLTopNode("MorpheusModel");
 	if (!morpheus_file_version.empty())
 		xMorphModel.addAttribute("version",morpheus_file_version.c_str());
 
-	XMLNode xTimeNode = xMorphModel.addChild( TimeScheduler::saveToXML() );
+	xMorphModel.addChild( xTimeNode );
 
 	xMorphModel.addChild(xDescription);
 
@@ -751,11 +778,14 @@ void saveToXML() {
 
 	// cell populations
 	xMorphModel.addChild(CPM::saveCellPopulations());
+	if (binary_writer)
+		binary_writer->close();
 
 	int xml_size;
 	XMLSTR xml_data=xMorphModel.createXMLString(1,&xml_size);
 
-	gzFile zfile = gzopen(filename.str().c_str(), "w9");
+	// Binary checkpoints favour speed over size
+	gzFile zfile = gzopen(filename.str().c_str(), binary ? "w1" : "w9");
 	if (Z_NULL == zfile) {
 		cerr<<"Cannot open file " << filename.str()  << endl;
 		exit(-1);
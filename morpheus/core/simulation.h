@@ -115,6 +115,7 @@ namespace SIM {
 	public:
 		TimeSymbol(string symbol) : SymbolAccessorBase<double>(symbol) {
 			flags().space_const = true;
+			flags().stamped = true;
 		}
 		double get(const SymbolFocus&) const override ;
 		const string& description() const override { static const string descr = "Time" ; return descr; }
@@ -75,6 +75,8 @@ public:
 	virtual const std::string& type() const =0;  ///  Type name derived from TypeInfo<T>::name
 	virtual std::string linkType() const =0;  /// Descriptive name identifying the container type providing the symbol
 	virtual const Flags& flags() const =0;  /// Meta information on the symbol
+	/// Change stamp, advanced whenever the value of a stamped symbol is modified (see Flags::stamped)
+	virtual uint64_t stamp() const { return _stamp; }
 
 	struct Flags {
 		Granularity granularity;
@@ -88,6 +90,7 @@ public:
 		bool function;
 		bool initialized;
 		bool initializing;
+		bool stamped;  ///< value only changes along with the stamp() or the simulation time
 		Flags() :
 		  granularity(Granularity::Global),
 		  time_const(false),
@@ -99,7 +102,8 @@ public:
 		  integer(false), 
 		  function(false),
 		  initialized(false),
-		  initializing(false) {};
+		  initializing(false),
+		  stamped(false) {};
 	};
 	
 	virtual ~SymbolBase() {};
@@ -125,6 +129,11 @@ protected:
 	friend class Scope;
 	// provide an interface to create on demand a typed CompositeSymbol via interface
 	virtual shared_ptr<CompositeSymbol_I> makeComposite() const =0;
+	/// Advance the change stamp, to be called by stamped symbols upon each modification of their value
+	void touch() const { ++_stamp; }
+	
+private:
+	mutable uint64_t _stamp = 0;
 };
 
 
@@ -222,6 +231,7 @@ public:
 		descr(description), value(value) {
 			this->flags().time_const = true;
 			this->flags().space_const = true;
+			this->flags().stamped = true;
 		};
 	/// Simplified interface for space-independent Symbols
 	typename TypeInfo<T>::SReturn get() const { return value; };
@@ -266,16 +276,16 @@ template <class T>
 class PrimitiveVariableSymbol : public SymbolRWAccessorBase<T> {
 public:
 	PrimitiveVariableSymbol(const string& name, const string& description, const T& value) : SymbolRWAccessorBase<T>(name),
-		descr(description), value(value) {};
+		descr(description), value(value) { this->flags().stamped = true; };
 	/// Simplified interface for space-independent Symbols
 	typename TypeInfo<T>::SReturn get() const { return value; };
 	typename TypeInfo<T>::SReturn get(const SymbolFocus&) const override { return value; };
 	/// Simplified interface for space-independent Symbols
-	void set(typename TypeInfo<T>::Parameter val) const { value = val; };
-	void set(const SymbolFocus&, typename TypeInfo<T>::Parameter val) const override { value = val; };
+	void set(typename TypeInfo<T>::Parameter val) const { value = val; this->touch(); };
+	void set(const SymbolFocus&, typename TypeInfo<T>::Parameter val) const override { value = val; this->touch(); };
 	void setBuffer(const SymbolFocus& f, typename TypeInfo<T>::Parameter value) const override { buffer = value; }
-	void applyBuffer() const override { value = buffer; };
-	void applyBuffer(const SymbolFocus& f) const override { value = buffer; };
+	void applyBuffer() const override { value = buffer; this->touch(); };
+	void applyBuffer(const SymbolFocus& f) const override { value = buffer; this->touch(); };
 	const string& description() const override { return descr; }
 	std::string linkType() const override { return "PrimitiveVariable"; }
 	
@@ -25,6 +25,7 @@ template<>
 void SystemFunc<VDOUBLE>::initFunction() {}
 
 const string SystemSolver::noise_scaling_symbol = "_noise_scaling";
+const uint SystemSolver::batch_size = 128;
 
 System::System(SystemType type, SystemContext context_req) : context_requirement(context_req), system_type(type) {}
 
@@ -279,7 +280,8 @@ void System::init() {
 	}
 		
 	solvers.push_back(make_shared<SystemSolver>(local_scope, evals, vec_evals, solver_spec));
-
+	// Reserve the slots of all threads, such that threadSolver() never resizes concurrently
+	solvers.resize(max(1, omp_get_max_threads()));
 }
 
 bool System::adaptive() const { return solver_spec.method == SystemSolver::Method::AdaptiveCK || solver_spec.method == SystemSolver::Method::AdaptiveDP || solver_spec.method == SystemSolver::Method::AdaptiveBS;};
@@ -311,9 +313,9 @@ void System::applyBuffer(const SymbolFocus& f, const vector<double>& buffer)
 	}
 }
 
-void System::computeToTarget(const SymbolFocus& f, bool use_buffer, vector<double>* buffer)
+SystemSolver* System::threadSolver()
 {
-	auto solv_num = omp_get_thread_num();
+	auto solv_num = omp_get_thread_index();
 
 	if (solv_num>=solvers.size() || ! solvers[solv_num]) {
 		mutex.lock();
@@ -323,7 +325,7 @@ void System::computeToTarget(const SymbolFocus& f, bool use_buffer, vector<doubl
 		try {
 			// Create and place the solver
 			if (! solvers[solv_num]) {
-				if (!solvers[0]) return;
+				if (!solvers[0]) { mutex.unlock(); return nullptr; }
 				solvers[solv_num] = make_shared<SystemSolver>(*solvers[0]);
 			}
 		}
@@ -331,7 +333,14 @@ void System::computeToTarget(const SymbolFocus& f, bool use_buffer, vector<doubl
 		catch (...){ cerr << "Could not clone solver!\n"<< endl; exit(-1); }
 		mutex.unlock();
 	}
-	solvers[solv_num]->solve(f, use_buffer, buffer);
+	return solvers[solv_num].get();
+}
+
+void System::computeToTarget(const SymbolFocus& f, bool use_buffer, vector<double>* buffer)
+{
+	auto solver = threadSolver();
+	if (solver)
+		solver->solve(f, use_buffer, buffer);
 }
 
 void System::compute(const SymbolFocus& f)
@@ -342,7 +351,21 @@ void System::compute(const SymbolFocus& f)
 void System::computeContextToBuffer()
 {
 	FocusRange range(target_granularity, target_scope);
-	if (range.size() > 50) {
+	if (!solvers.empty() && solvers[0] && solvers[0]->batchable()) {
+		// Integrate the foci in batches of SystemSolver::batch_size
+		const int n_batches = (range.size() + SystemSolver::batch_size - 1) / SystemSolver::batch_size;
+		ExceptionCatcher expression_catcher;
+#pragma omp parallel for schedule(dynamic) if (n_batches > 1)
+		for (int b=0; b<n_batches; b++) {
+			expression_catcher.Run([&]{
+				auto first = range.begin() + b * SystemSolver::batch_size;
+				auto last = (b+1 == n_batches) ? range.end() : first + SystemSolver::batch_size;
+				threadSolver()->solveBatch(first, last, true);
+			});
+		}
+		expression_catcher.Rethrow();
+	}
+	else if (range.size() > 50) {
 		ExceptionCatcher expression_catcher;
 #pragma omp parallel for schedule(static)
 		for (auto focus = range.begin(); focus<range.end(); ++focus) {
@@ -372,8 +395,9 @@ void System::applyContextBuffer()
 void System::setTimeStep ( double ht )
 {
 	solver_spec.time_step = ht * solver_spec.time_scaling;
-	for (uint i=0; i<solvers.size(); i++) 
-		solvers[i]->setTimeStep(solver_spec.time_step);
+	for (uint i=0; i<solvers.size(); i++) {
+		if (solvers[i]) solvers[i]->setTimeStep(solver_spec.time_step);
+	}
 }
 
 set< SymbolDependency > System::getDependSymbols()
@@ -650,6 +674,22 @@ SystemSolver::SystemSolver(Scope* scope, const std::vector< shared_ptr<SystemFun
 		else
 			var_initializers.push_back(init.dfun);
 	}
+	
+	// The batched solver binds all parser variables to batch columns. Vector expressions, local Functions,
+	// equation hooks and functions requiring a SymbolFocus cannot be evaluated that way.
+	batch_capable = vec_evals.empty() && functions.empty() && equations.empty();
+	for (const auto& eval : evals) {
+		const auto& fun_defs = eval->evaluator->parser->GetFunDef();
+		for (const auto& fun : eval->evaluator->parser->GetUsedFun()) {
+			auto defs = fun_defs.equal_range(fun);
+			if (defs.first == defs.second)
+				batch_capable = false;
+			for (auto def = defs.first; def != defs.second; ++def) {
+				if (def->second.GetCode() == mu::cmFUNC_VAR)
+					batch_capable = false;
+			}
+		}
+	}
 };
 
 SystemSolver::SystemSolver(const SystemSolver& other)
@@ -658,6 +698,7 @@ SystemSolver::SystemSolver(const SystemSolver& other)
 	local_time_idx = other.local_time_idx;
 	noise_scaling_idx = other.noise_scaling_idx;
 	spec = other.spec;
+	batch_capable = other.batch_capable;
 	
 	// Copy the functionals and wire them to the local cache
 	for (uint i=0; i<other.evals.size(); i++) {
@@ -1407,6 +1448,446 @@ void SystemSolver::RungeKutta_45DormandPrince(const SymbolFocus& f, double ht) {
 	cache->setLocal(local_time_idx, starttime);
 }
 
+namespace {
+
+/** Butcher tableau of an explicit Runge-Kutta scheme with an optional embedded lower order solution for error estimation
+ * 
+ *  Also records the operation order of the respective per-focus solver, such that batched results are bitwise identical:
+ *  the first @p expanded_stages stage interpolations are written as k0 + a_1*ht*k_1 + a_2*ht*k_2 ..., later ones as
+ *  k0 + ht*(a_1*k_1 + a_2*k_2 ...), and with @p incremental_time the stage time is advanced by (c_s - c_(s-1))*ht.
+ */
+struct ButcherTableau {
+	vector<double> c;
+	vector< vector<double> > a;
+	vector<double> b;
+	vector<double> b_err;
+	uint expanded_stages;
+	bool incremental_time;
+	ButcherTableau(vector<double> c, vector< vector<double> > a, vector<double> b, vector<double> b_low, uint expanded_stages, bool incremental_time) :
+		c(c), a(a), b(b), expanded_stages(expanded_stages), incremental_time(incremental_time) {
+		for (uint i=0; i<b_low.size(); i++) b_err.push_back(b[i] - b_low[i]);
+	}
+	/// Time of stage @p s of a step of size @p ht starting at @p t0
+	double stageTime(double t0, uint s, double ht) const {
+		if (!incremental_time)
+			return t0 + c[s] * ht;
+		double t = t0;
+		for (uint i=1; i<=s; i++) t += (c[i] - c[i-1]) * ht;
+		return t;
+	}
+};
+
+/// Tableaus of the schemes implemented by the per-focus solvers
+const ButcherTableau& butcherTableau(SystemSolver::Method method) {
+	static const ButcherTableau euler( {0}, {{}}, {1}, {}, 0, false );
+	static const ButcherTableau heun( {0, 2.0/3}, {{}, {2.0/3}}, {0.25, 0.75}, {}, 1, true );
+	static const ButcherTableau rk4( {0, 1.0/3, 2.0/3, 1},
+		{{}, {1.0/3}, {-1.0/3, 1.0}, {1.0, -1.0, 1.0}},
+		{1.0/8, 3.0/8, 3.0/8, 1.0/8}, {}, 1, true );
+	static const ButcherTableau bogacki_shampine( {0, 0.5, 0.75, 1},
+		{{}, {0.5}, {0, 0.75}, {2.0/9, 1.0/3, 4.0/9}},
+		{2.0/9, 1.0/3, 4.0/9, 0},
+		{7.0/24, 1.0/4, 1.0/3, 1.0/8}, 2, false );
+	static const ButcherTableau cash_karp( {0, 0.2, 0.3, 0.6, 1.0, 7.0/8},
+		{{}, {0.2}, {3.0/40, 9.0/40}, {0.3, -0.9, 1.2}, {-11.0/54, 2.5, -70.0/27, 35.0/27},
+		 {1631.0/55296, 175.0/512, 575.0/13824, 44275.0/110592, 253.0/4096}},
+		{37.0/378, 0, 250.0/621, 125.0/594, 0, 512.0/1771},
+		{2825.0/27648, 0, 18575.0/48384, 13525.0/55296, 277.0/14336, 1.0/4}, 2, false );
+	static const ButcherTableau dormand_prince( {0, 0.2, 0.3, 0.8, 8.0/9, 1, 1},
+		{{}, {0.2}, {3.0/40, 9.0/40}, {44.0/45, -56.0/15, 32.0/9}, {19372.0/6561, -25360.0/2187, 64448.0/6561, -212.0/729},
+		 {9017.0/3168, -355.0/33, 46732.0/5247, 49.0/176, -5103.0/18656},
+		 {35.0/384, 0, 500.0/1113, 125.0/192, -2187.0/6784, 11.0/84}},
+		{35.0/384, 0, 500.0/1113, 125.0/192, -2187.0/6784, 11.0/84, 0},
+		{5179.0/57600, 0, 7571.0/16695, 393.0/640, -92097.0/339200, 187.0/2100, 1.0/40}, 1, false );
+	
+	switch (method) {
+		case SystemSolver::Method::Euler : return euler;
+		case SystemSolver::Method::Heun : return heun;
+		case SystemSolver::Method::Runge_Kutta4 : return rk4;
+		case SystemSolver::Method::AdaptiveBS : return bogacki_shampine;
+		case SystemSolver::Method::AdaptiveCK : return cash_karp;
+		case SystemSolver::Method::AdaptiveDP : return dormand_prince;
+		default:
+			throw MorpheusException("No Butcher tableau for the solver method.");
+	}
+}
+
+}
+
+void SystemSolver::createBatch()
+{
+	batch = make_unique<Batch>();
+	batch->capacity = batch_size;
+	batch->size = 0;
+	batch->active = 0;
+	batch->n_locals = 0;
+	for (const auto& local : cache->getLocalsTable())
+		batch->n_locals += local.type == EvaluatorCache::LocalSymbolDesc::VECTOR ? 3 : 1;
+	
+	uint n_stages = 0;
+	if (spec.method != Method::Discrete && spec.method != Method::Noop)
+		n_stages = butcherTableau(spec.method).c.size();
+	
+	auto createFunc = [&](const shared_ptr<SystemFunc<double>>& fun, uint n_k) {
+		BatchFunc f;
+		f.fun = fun;
+		f.property = dynamic_cast<const PrimitivePropertySymbol<double>*>(fun->global_symbol.get());
+		f.parser = make_unique<mu::Parser>(*fun->evaluator->parser);
+		f.k.resize(n_k, vector<double>(batch->capacity));
+		return f;
+	};
+	for (const auto& ode : odes) {
+		batch->odes.push_back(createFunc(ode, n_stages));
+		batch->odes.back().k0.resize(batch->capacity);
+		batch->odes.back().dy.resize(batch->capacity);
+		batch->odes.back().err.resize(batch->capacity);
+	}
+	for (const auto& rule : rules)
+		batch->rules.push_back(createFunc(rule, 1));
+	for (const auto& ini : var_initializers)
+		batch->var_initializers.push_back(createFunc(ini, 0));
+	
+	// Map the parser variables to columns, locals keep their cache position and externals are appended.
+	map<const double*, uint> external_columns;
+	vector<pair<BatchFunc*, map<string,uint>>> bindings;
+	for (auto funcs : { &batch->odes, &batch->rules, &batch->var_initializers }) {
+		for (auto& f : *funcs) {
+			map<string,uint> columns;
+			auto used_vars = f.parser->GetUsedVar();
+			for (const auto& var : used_vars) {
+				int local_idx = cache->getLocalIdx(var.first);
+				if (local_idx >= 0) {
+					columns[var.first] = local_idx;
+				}
+				else {
+					auto ext = external_columns.find(var.second);
+					if (ext == external_columns.end()) {
+						ext = external_columns.insert( {var.second, batch->n_locals + batch->external_sources.size()} ).first;
+						batch->external_sources.push_back(var.second);
+					}
+					columns[var.first] = ext->second;
+				}
+			}
+			bindings.push_back({&f, columns});
+		}
+	}
+	
+	batch->data.resize( (batch->n_locals + batch->external_sources.size()) * batch->capacity, 0.0);
+	for (auto& binding : bindings) {
+		for (const auto& column : binding.second)
+			binding.first->parser->DefineVar(column.first, batch->column(column.second));
+	}
+	
+	batch->foci.resize(batch->capacity);
+	batch->lane_focus.resize(batch->capacity);
+	batch->t0.resize(batch->capacity);
+	batch->ht.resize(batch->capacity);
+	batch->total_ht.resize(batch->capacity);
+	batch->failed.resize(batch->capacity);
+}
+
+void SystemSolver::solveBatch(FocusRangeIterator begin, FocusRangeIterator end, bool use_buffer)
+{
+	assert(batch_capable);
+	if (!batch) createBatch();
+	assert(end - begin <= int(batch->capacity));
+	
+	fetchBatch(begin, end);
+	switch (spec.method) {
+		case Method::Noop: break;
+		case Method::Euler:
+		case Method::Heun:
+		case Method::Runge_Kutta4:
+			BatchFixedStep(spec.time_step); break;
+		case Method::Discrete : BatchDiscrete(); break;
+		case Method::AdaptiveCK :
+		case Method::AdaptiveDP :
+		case Method::AdaptiveBS :
+			BatchAdaptive(spec.time_step); break;
+		default:
+			throw MorpheusException("Solver method not implemented in solveBatch().");
+	}
+	writeBatch(use_buffer);
+}
+
+void SystemSolver::fetchBatch(FocusRangeIterator begin, FocusRangeIterator end)
+{
+	batch->size = end - begin;
+	batch->active = batch->size;
+	
+	cache->setLocal(local_time_idx, SIM::getTime() * spec.time_scaling);
+	uint lane = 0;
+	for (auto focus = begin; focus != end; ++focus, ++lane) {
+		const SymbolFocus& f = *focus;
+		auto value = [&f](const BatchFunc& e) {
+			if (e.property && f.cell().getCellType() == e.property->cellType())
+				return e.property->values()[f.cell().getPropertySlot()];
+			return e.fun->global_symbol->get(f);
+		};
+		cache->fetch(f);
+		for (const auto& e : batch->odes)
+			cache->setLocal(e.fun->cache_idx, value(e));
+		for (const auto& e : batch->rules)
+			cache->setLocal(e.fun->cache_idx, value(e));
+		
+		for (uint c=0; c<batch->n_locals; c++)
+			batch->column(c)[lane] = cache->getLocalD(c);
+		for (uint i=0; i<batch->external_sources.size(); i++)
+			batch->column(batch->n_locals + i)[lane] = *batch->external_sources[i];
+		
+		batch->foci[lane] = f;
+		batch->lane_focus[lane] = lane;
+	}
+	updateBatchLocalVars();
+}
+
+void SystemSolver::writeBatch(bool use_buffer)
+{
+	for (uint lane=0; lane<batch->size; lane++) {
+		const SymbolFocus& f = batch->foci[batch->lane_focus[lane]];
+		for (auto funcs : { &batch->odes, &batch->rules }) {
+			for (const auto& e : *funcs) {
+				if (use_buffer)
+					e.fun->global_symbol->setBuffer(f, batch->column(e.fun->cache_idx)[lane]);
+				else
+					e.fun->global_symbol->set(f, batch->column(e.fun->cache_idx)[lane]);
+			}
+		}
+	}
+}
+
+void SystemSolver::updateBatchLocalVars()
+{
+	for (auto& ini : batch->var_initializers) {
+		evaluateBatch(ini, batch->column(ini.fun->cache_idx));
+	}
+}
+
+void SystemSolver::evaluateBatch(BatchFunc& e, double* result)
+{
+	if (batch->active)
+		e.parser->Eval(result, batch->active);
+}
+
+void SystemSolver::checkBatchResult(const double* values, const BatchFunc& e) const
+{
+	for (uint lane=0; lane<batch->active; lane++) {
+		if ( std::isnan( values[lane] ) || std::isinf( values[lane] ) ) {
+			stringstream s;
+			s << "SystemSolver returned " << (std::isnan( values[lane] ) ? "NaN" : "Inf") << " for expression '" << e.fun->expression << "'." << endl;
+			auto symbols = e.parser->GetUsedVar();
+			for (auto ii : symbols) s << ii.first << "=" << ii.second[lane] << "; ";
+			s << endl;
+			if (std::isinf( values[lane] ))
+				throw ExpressionException(s.str(), ExpressionException::ErrorType::INF);
+			else
+				throw ExpressionException(s.str(), ExpressionException::ErrorType::NaN);
+		}
+	}
+}
+
+void SystemSolver::swapBatchLanes(uint a, uint b)
+{
+	const uint n_columns = batch->data.size() / batch->capacity;
+	for (uint c=0; c<n_columns; c++)
+		std::swap(batch->column(c)[a], batch->column(c)[b]);
+	for (auto& e : batch->odes) {
+		std::swap(e.k0[a], e.k0[b]);
+		std::swap(e.dy[a], e.dy[b]);
+		std::swap(e.err[a], e.err[b]);
+	}
+	std::swap(batch->t0[a], batch->t0[b]);
+	std::swap(batch->ht[a], batch->ht[b]);
+	std::swap(batch->total_ht[a], batch->total_ht[b]);
+	std::swap(batch->failed[a], batch->failed[b]);
+	std::swap(batch->lane_focus[a], batch->lane_focus[b]);
+}
+
+void SystemSolver::BatchRungeKuttaStep(bool check)
+{
+	const ButcherTableau& tableau = butcherTableau(spec.method);
+	const uint n_lanes = batch->active;
+	const uint n_stages = tableau.c.size();
+	double* time = batch->column(local_time_idx);
+	const double* ht = &batch->ht[0];
+	
+	for (uint l=0; l<n_lanes; l++) {
+		batch->t0[l] = time[l];
+		batch->failed[l] = false;
+	}
+	for (auto& e : batch->odes) {
+		const double* y = batch->column(e.fun->cache_idx);
+		std::copy(y, y+n_lanes, e.k0.begin());
+	}
+	
+	for (uint s=0; s<n_stages; s++) {
+		if (s>0) {
+			// Stage interpolation
+			const auto& a = tableau.a[s];
+			for (auto& e : batch->odes) {
+				double* y = batch->column(e.fun->cache_idx);
+				if (s <= tableau.expanded_stages) {
+					for (uint l=0; l<n_lanes; l++) {
+						double y_l = e.k0[l];
+						for (uint j=0; j<s; j++) y_l += a[j] * ht[l] * e.k[j][l];
+						y[l] = y_l;
+					}
+				}
+				else {
+					for (uint l=0; l<n_lanes; l++) {
+						double sum = 0;
+						for (uint j=0; j<s; j++) sum += a[j] * e.k[j][l];
+						y[l] = e.k0[l] + ht[l] * sum;
+					}
+				}
+			}
+			for (uint l=0; l<n_lanes; l++)
+				time[l] = tableau.stageTime(batch->t0[l], s, ht[l]);
+			updateBatchLocalVars();
+		}
+		for (auto& e : batch->odes) {
+			double* k = &e.k[s][0];
+			evaluateBatch(e, k);
+			if (check) {
+				checkBatchResult(k, e);
+			}
+			else {
+				for (uint l=0; l<n_lanes; l++)
+					if ( std::isnan(k[l]) || std::isinf(k[l]) ) batch->failed[l] = true;
+			}
+		}
+	}
+	
+	// Estimate dy and err and reset the state
+	for (auto& e : batch->odes) {
+		double* y = batch->column(e.fun->cache_idx);
+		double* rate = batch->column(e.fun->rate_cache_idx);
+		for (uint l=0; l<n_lanes; l++) {
+			double dy = 0;
+			for (uint s=0; s<n_stages; s++) dy += tableau.b[s] * e.k[s][l];
+			e.dy[l] = dy;
+			rate[l] = dy;
+			y[l] = e.k0[l];
+		}
+		if (!tableau.b_err.empty()) {
+			for (uint l=0; l<n_lanes; l++) {
+				double err = 0;
+				for (uint s=0; s<n_stages; s++) err += tableau.b_err[s] * e.k[s][l];
+				e.err[l] = abs(ht[l] * err);
+			}
+		}
+	}
+	for (uint l=0; l<n_lanes; l++)
+		time[l] = batch->t0[l];
+}
+
+void SystemSolver::BatchFixedStep(double ht)
+{
+	const ButcherTableau& tableau = butcherTableau(spec.method);
+	std::fill(batch->ht.begin(), batch->ht.begin() + batch->size, ht);
+	if (spec.method == Method::Euler || spec.method == Method::Heun) {
+		double* noise_scaling = batch->column(noise_scaling_idx);
+		std::fill(noise_scaling, noise_scaling + batch->size, sqrt(1.0/ht));
+	}
+	
+	BatchRungeKuttaStep(true);
+	
+	for (auto& e : batch->odes) {
+		double* y = batch->column(e.fun->cache_idx);
+		for (uint l=0; l<batch->size; l++)
+			y[l] = e.k0[l] + ht * e.dy[l];
+	}
+	// Rules see the time of the last stage, while the Euler step advances to the end of the interval, as in the per-focus solvers
+	double* time = batch->column(local_time_idx);
+	for (uint l=0; l<batch->size; l++)
+		time[l] = spec.method == Method::Euler ? batch->t0[l] + ht : tableau.stageTime(batch->t0[l], tableau.c.size()-1, ht);
+	
+	BatchDiscrete();
+}
+
+void SystemSolver::BatchAdaptive(double ht)
+{
+	const double tiny = 1e-15;
+	const double safety = 0.9;
+	const double epsilon = spec.epsilon;
+	const double min_ht = 1e-30;
+	double* time = batch->column(local_time_idx);
+	
+	std::fill(batch->ht.begin(), batch->ht.begin() + batch->size, ht);
+	std::fill(batch->total_ht.begin(), batch->total_ht.begin() + batch->size, 0.0);
+	const double starttime = batch->size ? time[0] : 0;
+	
+	// Each lane follows its own step size control, lanes that reached the end of the interval are moved behind the active ones
+	while (batch->active > 0) {
+		BatchRungeKuttaStep(false);
+		
+		uint l = 0;
+		while (l < batch->active) {
+			double& local_ht = batch->ht[l];
+			if (batch->failed[l]) {
+				if (local_ht > min_ht) {
+					// Retry with a smaller step, the state has already been reset
+					local_ht *= 0.1;
+					l++;
+					continue;
+				}
+				throw string("Unable to integrate system. Minimal time step") + to_string(min_ht) + "reached.";
+			}
+			
+			double max_err = 0;
+			for (const auto& e : batch->odes)
+				max_err = max(max_err, abs(e.err[l]/(e.k0[l] + local_ht*e.dy[l] + tiny)));
+			max_err /= epsilon;
+			if (max_err > 1.0) {
+				if (local_ht <= min_ht) {
+					throw string("Unable to integrate system. Minimal time step") + to_string(min_ht) + "reached.";
+				}
+				double new_ht = safety * local_ht * pow(max_err, -0.25);
+				local_ht = max(0.1*local_ht, new_ht); // cap at 1/10 of the current time step.
+				l++;
+				continue;
+			}
+			
+			// Apply the step
+			for (auto& e : batch->odes)
+				batch->column(e.fun->cache_idx)[l] = e.k0[l] + local_ht * e.dy[l];
+			batch->total_ht[l] += local_ht;
+			time[l] = starttime + batch->total_ht[l];
+			
+			if (batch->total_ht[l] >= ht) {
+				batch->active--;
+				swapBatchLanes(l, batch->active);
+				continue;
+			}
+			
+			if (max_err < 0.75) {
+				local_ht = safety * local_ht * pow(max_err, -0.20);
+			}
+			// Adjust next step
+			local_ht = min(local_ht, ht - batch->total_ht[l]);
+			l++;
+		}
+	}
+	
+	batch->active = batch->size;
+	BatchDiscrete(); // Execute rule based paradigms with the fixed external time step.
+}
+
+void SystemSolver::BatchDiscrete()
+{
+	if (batch->rules.empty())
+		return;
+	
+	for (auto& e : batch->rules) {
+		evaluateBatch(e, &e.k[0][0]);
+		checkBatchResult(&e.k[0][0], e);
+	}
+	// Assign locals
+	for (auto& e : batch->rules) {
+		std::copy(e.k[0].begin(), e.k[0].begin() + batch->active, batch->column(e.fun->cache_idx));
+	}
+}
+
 void DiscreteSystem::init(const Scope* scope)
 {
 	InstantaneousProcessPlugin::init(scope);
@@ -24,6 +24,8 @@
 // performance timer
 #include <sys/time.h>
 
+template <class T> class PrimitivePropertySymbol;
+
 /** Systemm Types
  *  - time continuous --> ode / pde  
  *    --> time intervals have to correspond to the connected systems.
@@ -150,6 +152,16 @@ class SystemSolver{
 		SystemSolver(const SystemSolver& p);
 		const SystemSolver& operator=(const SystemSolver& p)= delete;
 		void solve(const SymbolFocus& f, bool use_buffer, vector<double>* ext_buffer=nullptr);
+		/** Solve the system for all foci in [@p begin, @p end) at once.
+		 * 
+		 *  The state of the foci is kept in structure-of-arrays layout and each expression is evaluated
+		 *  over the whole batch using muParser's bulk mode. Requires batchable() and at most batch_size foci.
+		 */
+		void solveBatch(FocusRangeIterator begin, FocusRangeIterator end, bool use_buffer);
+		/// Whether the system can be solved by solveBatch(), i.e. it is scalar and free of functions that require a focus.
+		bool batchable() const { return batch_capable; }
+		/// Maximum number of foci per batch
+		static const uint batch_size;
 // 		valarray<double> cache;
 		void setTimeStep(double ht);
 		set<Symbol> getExternalDependencies() { return cache->getExternalSymbols(); };
@@ -177,6 +189,44 @@ class SystemSolver{
 		void check_result(double value , const SystemFunc<double>& e) const;
 		void check_result(const VDOUBLE& value , const SystemFunc<VDOUBLE>& e) const;
 		
+		/// Batched expression evaluation unit, bound to the columns of the Batch
+		struct BatchFunc {
+			shared_ptr<SystemFunc<double>> fun;
+			/// Cell property written by the function, fetched directly from its column
+			const PrimitivePropertySymbol<double>* property = nullptr;
+			unique_ptr<mu::Parser> parser;
+			vector< vector<double> > k;
+			vector<double> k0, dy, err;
+		};
+		/// Structure-of-arrays state of a batch, one column per cache local and per external symbol used
+		struct Batch {
+			uint capacity, size, active;
+			uint n_locals;
+			vector<double> data;
+			vector<const double*> external_sources;
+			vector<SymbolFocus> foci;
+			vector<uint> lane_focus;
+			vector<BatchFunc> odes, rules, var_initializers;
+			vector<double> t0, ht, total_ht;
+			vector<char> failed;
+			double* column(uint c) { return &data[c * capacity]; }
+		};
+		bool batch_capable;
+		unique_ptr<Batch> batch;
+		
+		void createBatch();
+		void fetchBatch(FocusRangeIterator begin, FocusRangeIterator end);
+		void writeBatch(bool use_buffer);
+		void updateBatchLocalVars();
+		void evaluateBatch(BatchFunc& e, double* result);
+		void checkBatchResult(const double* values, const BatchFunc& e) const;
+		void swapBatchLanes(uint a, uint b);
+		/// Explicit Runge-Kutta step of the active lanes with their time step batch->ht. Leaves the state unchanged and provides dy and err.
+		void BatchRungeKuttaStep(bool check);
+		void BatchFixedStep(double ht);
+		void BatchAdaptive(double ht);
+		void BatchDiscrete();
+		
 		void RungeKutta(const SymbolFocus& f, double ht);
 		void RungeKutta_adaptive(const SymbolFocus& f, double ht);
 		void RungeKutta_23BogackiShampine(const SymbolFocus& f, double ht);
@@ -253,6 +303,8 @@ protected:
 	shared_ptr<EvaluatorCache> cache;
 	vector< shared_ptr<SystemSolver> > solvers;
 	vector<ReporterPlugin*> sub_step_hooks;
+	/// The solver instance of the calling thread
+	SystemSolver* threadSolver();
 	
 };
 
@@ -0,0 +1,123 @@
+#include "test_operators.h"
+#include "core/edge_tracker.h"
+#include "core/random_functions.h"
+#include "core/rss_stat.h"
+
+/** Micro-benchmark of the edge trackers on a large cubic lattice
+ * 
+ *  The lattice is filled with cubic cells of edge length 8. Each cycle picks an update from the
+ *  tracker, applies it to the layer and notifies the tracker, i.e. the full tracker workload of an
+ *  accepted CPM update. Reports update throughput and the resident memory occupied by the tracker.
+ */
+
+namespace {
+
+const int lattice_size = 96;
+const int cell_size = 8;
+const uint n_updates = 1000000;
+
+struct BenchSetup {
+	shared_ptr<Lattice> lattice;
+	shared_ptr<CPM::LAYER> layer;
+	vector<VINT> update_neighbors;
+	vector<VINT> surface_neighbors;
+};
+
+BenchSetup createSetup() {
+	BenchSetup setup;
+	LatticeDesc desc;
+	desc.structure = Lattice::cubic;
+	desc.size = VINT(lattice_size, lattice_size, lattice_size);
+	desc.boundaries[Boundary::mx] = Boundary::periodic;
+	desc.boundaries[Boundary::my] = Boundary::periodic;
+	desc.boundaries[Boundary::mz] = Boundary::periodic;
+	setup.lattice = Lattice::createLattice(desc);
+	
+	CPM::STATE empty;
+	empty.cell_id = 0;
+	empty.super_cell_id = 0;
+	empty.pos = VINT(0,0,0);
+	setup.layer = make_shared<CPM::LAYER>(setup.lattice, 3, empty, "cpm");
+	
+	const int n_cells = lattice_size / cell_size;
+	VINT pos;
+	for (pos.z=0; pos.z<lattice_size; pos.z++) {
+		for (pos.y=0; pos.y<lattice_size; pos.y++) {
+			for (pos.x=0; pos.x<lattice_size; pos.x++) {
+				CPM::STATE state = empty;
+				state.cell_id = 1 + pos.x/cell_size + n_cells * (pos.y/cell_size + n_cells * (pos.z/cell_size));
+				state.pos = pos;
+				setup.layer->set(pos, state);
+			}
+		}
+	}
+	setup.update_neighbors = setup.lattice->getNeighborhoodByOrder(2).neighbors();
+	setup.surface_neighbors = setup.lattice->getNeighborhoodByOrder(1).neighbors();
+	return setup;
+}
+
+/// Edges in a canonical order, with the nodes of each edge ordered
+vector< pair<VINT,VINT> > sortedEdges(vector< pair<VINT,VINT> > edges) {
+	less_VINT less;
+	for (auto& edge : edges) {
+		if (less(edge.second, edge.first))
+			swap(edge.first, edge.second);
+	}
+	sort(edges.begin(), edges.end(), [&less](const pair<VINT,VINT>& a, const pair<VINT,VINT>& b) {
+		return less(a.first, b.first) || (a.first == b.first && less(a.second, b.second));
+	});
+	return edges;
+}
+
+template <class Tracker>
+void runTrackerBenchmark(const string& name) {
+	setRandomSeed(42);
+	BenchSetup setup = createSetup();
+	LatticeStencil stencil(setup.layer, setup.update_neighbors);
+	
+	size_t rss_before = getCurrentRSS();
+	double init_start = get_wall_time();
+	Tracker tracker(setup.layer, setup.update_neighbors, setup.surface_neighbors);
+	double init_time = get_wall_time() - init_start;
+	size_t rss_tracker = getCurrentRSS() - rss_before;
+	uint initial_updates = tracker.updates_per_mcs();
+	
+	double start = get_wall_time();
+	for (uint i=0; i<n_updates; i++) {
+		VINT origin, direction;
+		tracker.get_update(origin, direction);
+		VINT focus = origin + direction;
+		setup.lattice->resolve(focus);
+		CPM::STATE state = setup.layer->get(origin);
+		state.pos = focus;
+		setup.layer->set(focus, state);
+		stencil.setPosition(focus);
+		tracker.update_notifier(focus, stencil);
+	}
+	double run_time = get_wall_time() - start;
+	size_t rss_run = getCurrentRSS() - rss_before;
+	
+	cout << "[ BENCH    ] " << name << " on " << lattice_size << "^3 cubic lattice" << endl;
+	cout << "[ BENCH    ]   init " << init_time << " s, " << initial_updates << " updates per MCS" << endl;
+	cout << "[ BENCH    ]   " << n_updates / run_time << " updates/s" << endl;
+	cout << "[ BENCH    ]   RSS after init " << rss_tracker / (1024*1024) << " MiB, after updates " << rss_run / (1024*1024) << " MiB" << endl;
+	
+	// The tracked edges must match a tracker rebuilt from the current configuration
+	uint tracked_updates = tracker.updates_per_mcs();
+	auto tracked_edges = sortedEdges(tracker.getEdges());
+	tracker.reset();
+	EXPECT_EQ(tracked_updates, tracker.updates_per_mcs());
+	auto rebuilt_edges = sortedEdges(tracker.getEdges());
+	ASSERT_EQ(tracked_edges.size(), rebuilt_edges.size());
+	EXPECT_TRUE(tracked_edges == rebuilt_edges);
+}
+
+}
+
+TEST (EDGE_TRACKER, EdgeListTracker) {
+	runTrackerBenchmark<EdgeListTracker>("EdgeListTracker");
+}
+
+TEST (EDGE_TRACKER, CompactEdgeTracker) {
+	runTrackerBenchmark<CompactEdgeTracker>("CompactEdgeTracker");
+}
@@ -0,0 +1,146 @@
+#include "test_operators.h"
+#include "core/field_kernels.h"
+#include "core/random_functions.h"
+#include "core/rss_stat.h"
+
+/** Micro-benchmark of the forward Euler diffusion kernels
+ *
+ *  Runs the cubic and the generalized kernel on a 128^3 grid with a shadow width of one for all
+ *  instruction sets supported by the host. Results must be bit-identical to the scalar kernels.
+ */
+
+namespace {
+
+const int size = 128;
+const int shadow = size + 2;
+const uint n_steps = 10;
+
+struct Grid {
+	vector<double> src, dst;
+	int sy = shadow, sz = shadow * shadow;
+	Grid() : src(shadow * shadow * shadow), dst(shadow * shadow * shadow, 0.0) {
+		for (auto& v : src) v = getRandom01();
+	}
+	int index(int x, int y, int z) const { return (x+1) + (y+1) * sy + (z+1) * sz; }
+};
+
+template <class Kernel>
+double runKernel(Grid& grid, Kernel kernel) {
+	double start = get_wall_time();
+	for (uint step=0; step<n_steps; step++) {
+		for (int z=0; z<size; z++) {
+			for (int y=0; y<size; y++) {
+				int row = grid.index(0,y,z);
+				kernel(&grid.src[row], &grid.dst[row]);
+			}
+		}
+	}
+	return get_wall_time() - start;
+}
+
+}
+
+TEST (FIELD_KERNELS, Cubic) {
+	setRandomSeed(42);
+	Grid grid;
+	const double alpha = 0.1, beta = 1 - 6 * alpha;
+	const int offsets[6] = { -1, 1, grid.sy, -grid.sy, grid.sz, -grid.sz };
+	const double alphas[6] = { alpha, alpha, alpha, alpha, alpha, alpha };
+	auto cubic = [&](const double* src, double* dst) { FieldKernels::diffusionCubic(src, dst, size, grid.sy, grid.sz, alpha, beta); };
+	auto generalized = [&](const double* src, double* dst) { FieldKernels::diffusionGeneralized(src, dst, size, offsets, alphas, 6, beta); };
+
+	const FieldKernels::SIMD default_simd = FieldKernels::simd();
+	FieldKernels::selectSIMD(FieldKernels::SIMD::Scalar);
+	runKernel(grid, cubic);
+	const vector<double> reference_cubic = grid.dst;
+	runKernel(grid, generalized);
+	const vector<double> reference_generalized = grid.dst;
+
+	double node_updates = double(n_steps) * size * size * size;
+	for (auto s : { FieldKernels::SIMD::Scalar, FieldKernels::SIMD::SSE2, FieldKernels::SIMD::AVX, FieldKernels::SIMD::AVX512 }) {
+		if (!FieldKernels::selectSIMD(s))
+			continue;
+		double cubic_time = runKernel(grid, cubic);
+		EXPECT_EQ(grid.dst, reference_cubic) << FieldKernels::simdName(s);
+		double generalized_time = runKernel(grid, generalized);
+		EXPECT_EQ(grid.dst, reference_generalized) << FieldKernels::simdName(s);
+		cout << "[ BENCH    ] " << FieldKernels::simdName(s) << ": cubic " << node_updates / cubic_time / 1e6 << " Mnodes/s, "
+		     << "generalized " << node_updates / generalized_time / 1e6 << " Mnodes/s" << endl;
+	}
+	FieldKernels::selectSIMD(default_simd);
+}
+
+namespace {
+
+/// Set the shadow of a shadowed @p grid as PDE_Layer does before each forward euler step, constant values are taken from @p init
+void setBoundaries(vector<double>& grid, const vector<double>& init, const VINT& size, const Boundary::Type boundaries[Boundary::nCodes]) {
+	const int sy = size.x+2, sz = sy*(size.y+2);
+	auto idx = [&](int x, int y, int z) { return (x+1) + (y+1)*sy + (z+1)*sz; };
+	for (int z=-1; z<=size.z; z++) for (int y=-1; y<=size.y; y++) {
+		int lo = idx(-1,y,z), hi = idx(size.x,y,z);
+		grid[lo] = boundaries[Boundary::mx] == Boundary::periodic ? grid[idx(size.x-1,y,z)] : boundaries[Boundary::mx] == Boundary::noflux ? grid[idx(0,y,z)] : init[lo];
+		grid[hi] = boundaries[Boundary::px] == Boundary::periodic ? grid[idx(0,y,z)] : boundaries[Boundary::px] == Boundary::noflux ? grid[idx(size.x-1,y,z)] : init[hi];
+	}
+	for (int z=-1; z<=size.z; z++) for (int x=-1; x<=size.x; x++) {
+		int lo = idx(x,-1,z), hi = idx(x,size.y,z);
+		grid[lo] = boundaries[Boundary::my] == Boundary::periodic ? grid[idx(x,size.y-1,z)] : boundaries[Boundary::my] == Boundary::noflux ? grid[idx(x,0,z)] : init[lo];
+		grid[hi] = boundaries[Boundary::py] == Boundary::periodic ? grid[idx(x,0,z)] : boundaries[Boundary::py] == Boundary::noflux ? grid[idx(x,size.y-1,z)] : init[hi];
+	}
+	for (int y=-1; y<=size.y; y++) for (int x=-1; x<=size.x; x++) {
+		int lo = idx(x,y,-1), hi = idx(x,y,size.z);
+		grid[lo] = boundaries[Boundary::mz] == Boundary::noflux ? grid[idx(x,y,0)] : init[lo];
+		grid[hi] = boundaries[Boundary::pz] == Boundary::noflux ? grid[idx(x,y,size.z-1)] : init[hi];
+	}
+}
+
+}
+
+TEST (FIELD_KERNELS, CubicWavefront) {
+	setRandomSeed(42);
+	const VINT wsize(192,192,192);
+	const int sy = wsize.x+2, sz = sy*(wsize.y+2);
+	const size_t n_nodes = size_t(sz) * (wsize.z+2);
+	const double alpha = 0.1, beta = 1 - 6 * alpha;
+	const Boundary::Type boundaries[Boundary::nCodes] = { Boundary::periodic, Boundary::periodic, Boundary::noflux, Boundary::constant, Boundary::constant, Boundary::noflux };
+	const uint depth = max(2u, FieldKernels::wavefrontDepth(wsize));
+	const uint n_blocks = 3;
+	
+	vector<double> init(n_nodes);
+	for (auto& v : init) v = getRandom01();
+	
+	// Reference, one sweep per step
+	vector<double> a = init, b(n_nodes, 0.0);
+	double start = get_wall_time();
+	for (uint step=0; step<depth*n_blocks; step++) {
+		setBoundaries(a, init, wsize, boundaries);
+		for (int z=0; z<wsize.z; z++) {
+			for (int y=0; y<wsize.y; y++) {
+				int row = 1 + (y+1)*sy + (z+1)*sz;
+				FieldKernels::diffusionCubic(&a[row], &b[row], wsize.x, sy, sz, alpha, beta);
+			}
+		}
+		swap(a,b);
+	}
+	double sweep_time = get_wall_time() - start;
+	
+	// Wavefront, depth steps per sweep
+	vector<double> c = init, d(n_nodes, 0.0), workspace;
+	start = get_wall_time();
+	for (uint block=0; block<n_blocks; block++) {
+		setBoundaries(c, init, wsize, boundaries);
+		FieldKernels::diffusionCubicWavefront(&c[0], &d[0], wsize, alpha, beta, depth, boundaries, workspace);
+		swap(c,d);
+	}
+	double wavefront_time = get_wall_time() - start;
+	
+	uint mismatches = 0;
+	for (int z=0; z<wsize.z; z++) for (int y=0; y<wsize.y; y++) for (int x=0; x<wsize.x; x++) {
+		int i = (x+1) + (y+1)*sy + (z+1)*sz;
+		if (a[i] != c[i]) mismatches++;
+	}
+	EXPECT_EQ(mismatches, 0u);
+	
+	double node_updates = double(depth) * n_blocks * wsize.x * wsize.y * wsize.z;
+	cout << "[ BENCH    ] " << wsize.x << "^3 cubic, " << depth << " steps per wavefront: sweeps " << node_updates / sweep_time / 1e6
+	     << " Mnodes/s, wavefront " << node_updates / wavefront_time / 1e6 << " Mnodes/s" << endl;
+}
@@ -0,0 +1,85 @@
+#include "test_operators.h"
+#include "core/boltzmann_acceptance.h"
+#include "core/random_functions.h"
+#include "core/rss_stat.h"
+
+/** Micro-benchmark of the Metropolis acceptance
+ *
+ *  Compares the tabulated BoltzmannAcceptance with the plain evaluation of exp(-dE/T) on
+ *  identical streams of energy differences and random numbers. Energy differences are
+ *  integral in most of the samples, as in models with integral interaction energies and targets.
+ */
+
+namespace {
+
+const uint n_samples = 10000000;
+const double temperature = 2.0;
+
+vector<double> createEnergies() {
+	setRandomSeed(42);
+	vector<double> energies(n_samples);
+	for (auto& dE : energies) {
+		if (getRandom01() < 0.8)
+			dE = double(getRandomUint(40)) - 10;
+		else
+			dE = 30 * getRandom01() - 10;
+	}
+	return energies;
+}
+
+vector<double> createRandoms() {
+	vector<double> randoms(n_samples);
+	for (auto& rnd : randoms) {
+		rnd = getRandom01();
+	}
+	return randoms;
+}
+
+}
+
+TEST (METROPOLIS, BoltzmannAcceptance) {
+	const vector<double> energies = createEnergies();
+	const vector<double> randoms = createRandoms();
+
+	double start = get_wall_time();
+	uint plain_accepted = 0;
+	for (uint i=0; i<n_samples; i++) {
+		const double dE = energies[i];
+		if (dE <= 0 || randoms[i] < exp(-dE / temperature))
+			plain_accepted++;
+	}
+	double plain_time = get_wall_time() - start;
+
+	BoltzmannAcceptance boltzmann;
+	boltzmann.setTemperature(temperature);
+	start = get_wall_time();
+	uint table_accepted = 0;
+	for (uint i=0; i<n_samples; i++) {
+		if (boltzmann.accept(energies[i], randoms[i]))
+			table_accepted++;
+	}
+	double table_time = get_wall_time() - start;
+
+	uint mismatches = 0;
+	for (uint i=0; i<n_samples; i++) {
+		const double dE = energies[i];
+		if (dE > 0 && boltzmann.probability(dE) != exp(-dE / temperature))
+			mismatches++;
+	}
+
+	cout << "[ BENCH    ] Metropolis acceptance of " << n_samples << " samples at T=" << temperature << endl;
+	cout << "[ BENCH    ]   exp()  " << n_samples / plain_time << " samples/s, acceptance " << double(plain_accepted) / n_samples << endl;
+	cout << "[ BENCH    ]   table  " << n_samples / table_time << " samples/s, acceptance " << double(table_accepted) / n_samples << endl;
+
+	EXPECT_EQ(plain_accepted, table_accepted);
+	EXPECT_EQ(mismatches, 0u);
+}
+
+TEST (METROPOLIS, TemperatureChange) {
+	BoltzmannAcceptance boltzmann;
+	boltzmann.setTemperature(1.0);
+	EXPECT_EQ(boltzmann.probability(3), exp(-3.0));
+	boltzmann.setTemperature(4.0);
+	EXPECT_EQ(boltzmann.probability(3), exp(-3.0 / 4.0));
+	EXPECT_EQ(boltzmann.probability(1000.5), exp(-1000.5 / 4.0));
+}
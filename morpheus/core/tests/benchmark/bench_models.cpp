@@ -0,0 +1,209 @@
+#include "gtest/gtest.h"
+#include "model_test.h"
+#include "core/simulation.h"
+#include "core/time_scheduler.h"
+#include "core/field.h"
+#include "core/celltype.h"
+#include "core/async_output.h"
+#include "core/rss_stat.h"
+#include <functional>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+#include <malloc.h>
+#endif
+
+/** Benchmark suite of representative model workloads (morpheus_bench)
+ *
+ *  Each workload runs an embedded model, whose placeholders %...% are substituted by the workload parameters.
+ *  All workloads are parametrized by the problem size and the number of OpenMP threads, i.e. 1 and all available threads.
+ *  Reported are the updates per second, as defined per workload, the heap memory held by the model after the run
+ *  and the peak resident set size of the process.
+ *
+ *  Select workloads with the test filter, e.g. morpheus_bench --gtest_filter='*BenchDiffusion*'
+ */
+
+namespace {
+
+/// Heap memory in use, falls back to the resident set size
+size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	return mallinfo2().uordblks;
+#else
+	return getCurrentRSS();
+#endif
+}
+
+string substitute(string model, const map<string,string>& values) {
+	for (const auto& v : values) {
+		string key = "%" + v.first + "%";
+		for (size_t pos = model.find(key); pos != string::npos; pos = model.find(key, pos))
+			model.replace(pos, key.size(), v.second);
+	}
+	return model;
+}
+
+vector<int> threadCounts() {
+	vector<int> counts = { 1 };
+	if (omp_get_max_threads() > 1)
+		counts.push_back(omp_get_max_threads());
+	return counts;
+}
+
+/** Run @p model using @p threads threads
+ *
+ *  @p updates is evaluated after the run and returns the number of updates performed, named by @p unit.
+ */
+void runBenchmark(const string& name, const string& model, int threads, const string& unit, std::function<double()> updates) {
+#ifdef HAVE_OPENMP
+	int max_threads = omp_get_max_threads();
+	omp_set_num_threads(threads);
+#endif
+	SIM::wipe();
+	size_t heap_before = heapInUse();
+
+	TestModel m(model);
+	double start = get_wall_time();
+	try { m.run(); }
+	catch (const string& e) { FAIL() << e; }
+	catch (const MorpheusException& e) { FAIL() << e.what() << " at " << e.where(); }
+	catch (const std::exception& e) { FAIL() << e.what(); }
+	TimeScheduler::finish();
+	AsyncOutputFile::sync();
+	double runtime = get_wall_time() - start;
+
+	size_t heap = heapInUse();
+	double n_updates = updates();
+	cout << "[ BENCH    ] " << name << " (" << threads << " threads)" << endl;
+	cout << "[ BENCH    ]   " << n_updates / runtime << " " << unit << "/s, runtime " << runtime << " s" << endl;
+	cout << "[ BENCH    ]   memory " << (heap > heap_before ? heap - heap_before : 0) / 1024 << " KiB, peak RSS " << getPeakRSS() / (1024*1024) << " MiB" << endl;
+
+	SIM::wipe();
+#ifdef HAVE_OPENMP
+	omp_set_num_threads(max_threads);
+#endif
+}
+
+int nodes(const VINT& size) { return max(size.x,1) * max(size.y,1) * max(size.z,1); }
+
+}
+
+///////////////////////////////////////////////
+// CPM sweep with different steppers
+///////////////////////////////////////////////
+
+class BenchCPMSweep : public ::testing::TestWithParam< tuple<string,int,int> > {};
+
+TEST_P (BenchCPMSweep, Run) {
+	string stepper = get<0>(GetParam());
+	int size = get<1>(GetParam()), threads = get<2>(GetParam());
+	const int mcs = 50;
+	auto file = ImportFile("bench_cpm.xml");
+	string model = substitute(file.getDataAsString(),
+		{ {"SIZE", to_str(size)}, {"CELLS", to_str(size*size/100)}, {"STEPPER", stepper}, {"STOP", to_str(mcs)} });
+	// Copy attempts of a Monte Carlo step, i.e. one per lattice node
+	runBenchmark("CPM " + stepper + " " + to_str(size) + "^2", model, threads, "node updates", [&]() { return double(mcs) * size * size; });
+}
+
+INSTANTIATE_TEST_SUITE_P(Models, BenchCPMSweep, ::testing::Combine(
+	::testing::Values("edgelist", "random"),
+	::testing::Values(100, 200),
+	::testing::ValuesIn(threadCounts())
+));
+
+///////////////////////////////////////////////
+// Diffusion on all lattice types
+///////////////////////////////////////////////
+
+class BenchDiffusion : public ::testing::TestWithParam< tuple<string,int,int> > {};
+
+TEST_P (BenchDiffusion, Run) {
+	string lattice = get<0>(GetParam());
+	int n_nodes = get<1>(GetParam()), threads = get<2>(GetParam());
+	VINT size;
+	if (lattice == "linear") size = VINT(n_nodes, 0, 0);
+	else if (lattice == "cubic") { int l = round(cbrt(n_nodes)); size = VINT(l, l, l); }
+	else { int l = round(sqrt(n_nodes)); size = VINT(l, l, 0); }
+	const double stop = 200;
+	auto file = ImportFile("bench_diffusion.xml");
+	string model = substitute(file.getDataAsString(),
+		{ {"LATTICE", lattice}, {"SIZE", to_str(size.x) + ", " + to_str(size.y) + ", " + to_str(size.z)}, {"STOP", to_str(stop)} });
+
+	runBenchmark("Diffusion " + lattice + " " + to_str(nodes(size)) + " nodes", model, threads, "node updates", [&]() {
+		auto field = dynamic_pointer_cast<const Field::Symbol>(SIM::findGlobalSymbol<double>("u"));
+		return nodes(size) * ceil(stop / field->getField()->getMaxTimeStep());
+	});
+}
+
+INSTANTIATE_TEST_SUITE_P(Models, BenchDiffusion, ::testing::Combine(
+	::testing::Values("linear", "square", "hexagonal", "cubic"),
+	::testing::Values(40000, 250000),
+	::testing::ValuesIn(threadCounts())
+));
+
+///////////////////////////////////////////////
+// ODE systems with all SystemSolver methods
+///////////////////////////////////////////////
+
+class BenchODESystem : public ::testing::TestWithParam< tuple<string,int,int> > {};
+
+TEST_P (BenchODESystem, Run) {
+	string solver = get<0>(GetParam());
+	int size = get<1>(GetParam()), threads = get<2>(GetParam());
+	const double stop = 10, time_step = 0.1;
+	auto file = ImportFile("bench_ode.xml");
+	string model = substitute(file.getDataAsString(),
+		{ {"SOLVER", solver}, {"SIZE", to_str(size)}, {"STOP", to_str(stop)} });
+	// Adaptive solvers take a varying number of internal steps per time step
+	runBenchmark("ODE " + solver + " " + to_str(size) + "^2", model, threads, "node steps", [&]() { return size * size * round(stop / time_step); });
+}
+
+INSTANTIATE_TEST_SUITE_P(Models, BenchODESystem, ::testing::Combine(
+	::testing::Values("euler", "heun", "runge-kutta", "bogacki-shampine", "cash-karp", "dormand-prince"),
+	::testing::Values(100, 300),
+	::testing::ValuesIn(threadCounts())
+));
+
+///////////////////////////////////////////////
+// Cell division at high population
+///////////////////////////////////////////////
+
+class BenchCellDivision : public ::testing::TestWithParam< tuple<int,int> > {};
+
+TEST_P (BenchCellDivision, Run) {
+	int n_cells = get<0>(GetParam()), threads = get<1>(GetParam());
+	// Start with an eighth of the population, which then grows about three generations
+	int size = round(sqrt(n_cells * 50.0));
+	const int mcs = 50;
+	auto file = ImportFile("bench_division.xml");
+	string model = substitute(file.getDataAsString(),
+		{ {"SIZE", to_str(size)}, {"CELLS", to_str(n_cells / 8)}, {"STOP", to_str(mcs)} });
+	runBenchmark("CellDivision " + to_str(n_cells) + " cells", model, threads, "node updates", [&]() {
+		cout << "[ BENCH    ]   " << CPM::findCellType("cells").lock()->getCellIDs().size() << " cells at the end" << endl;
+		return double(mcs) * size * size;
+	});
+}
+
+INSTANTIATE_TEST_SUITE_P(Models, BenchCellDivision, ::testing::Combine(
+	::testing::Values(2000, 8000),
+	::testing::ValuesIn(threadCounts())
+));
+
+///////////////////////////////////////////////
+// Logger and VTK output
+///////////////////////////////////////////////
+
+class BenchOutput : public ::testing::TestWithParam< tuple<int,int> > {};
+
+TEST_P (BenchOutput, Run) {
+	int size = get<0>(GetParam()), threads = get<1>(GetParam());
+	const int steps = 10;
+	auto file = ImportFile("bench_output.xml");
+	string model = substitute(file.getDataAsString(),
+		{ {"SIZE", to_str(size)}, {"CELLS", to_str(size*size/100)}, {"STOP", to_str(steps)} });
+	// Every step writes all nodes of the field and the cell lattice
+	runBenchmark("Output " + to_str(size) + "^2", model, threads, "nodes written", [&]() { return double(steps + 1) * size * size; });
+}
+
+INSTANTIATE_TEST_SUITE_P(Models, BenchOutput, ::testing::Combine(
+	::testing::Values(100, 300),
+	::testing::ValuesIn(threadCounts())
+));
@@ -0,0 +1,133 @@
+#include "test_operators.h"
+#include "core/node_set.h"
+#include "core/random_functions.h"
+#include "core/rss_stat.h"
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+#include <malloc.h>
+#endif
+
+/** Micro-benchmark of the cell node containers
+ *
+ *  Compares the ordered set<VINT,less_VINT> with the FlatNodeSet on a large spherical 3D cell.
+ *  The cell is built node by node, then its surface fluctuates by alternately removing a random
+ *  boundary node and adding a node at the boundary, i.e. the node container workload of accepted
+ *  CPM updates. Finally, all nodes are visited repeatedly like in a FocusRange over the cell nodes.
+ */
+
+namespace {
+
+const int radius = 24;
+const uint n_updates = 2000000;
+const uint n_sweeps = 200;
+
+/// Heap memory in use, falls back to the resident set size
+size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+	return mallinfo2().uordblks;
+#else
+	return getCurrentRSS();
+#endif
+}
+
+struct BenchNodes {
+	vector<VINT> cell;      ///< nodes of the initial cell
+	vector<VINT> shell;     ///< candidate nodes at the cell boundary
+};
+
+BenchNodes createNodes() {
+	BenchNodes b;
+	VINT pos;
+	for (pos.z=-radius-2; pos.z<=radius+2; pos.z++) {
+		for (pos.y=-radius-2; pos.y<=radius+2; pos.y++) {
+			for (pos.x=-radius-2; pos.x<=radius+2; pos.x++) {
+				double r = sqrt(double(pos.x*pos.x + pos.y*pos.y + pos.z*pos.z));
+				if (r <= radius) b.cell.push_back(pos + VINT(500,500,500));
+				if (r > radius-2 && r <= radius+2) b.shell.push_back(pos + VINT(500,500,500));
+			}
+		}
+	}
+	return b;
+}
+
+template <class Nodes>
+void runNodeSetBenchmark(const string& name) {
+	setRandomSeed(42);
+	BenchNodes b = createNodes();
+
+	size_t heap_before = heapInUse();
+	double start = get_wall_time();
+	Nodes nodes;
+	for (const auto& node : b.cell)
+		nodes.insert(node);
+	double insert_time = get_wall_time() - start;
+	size_t heap_nodes = heapInUse() - heap_before;
+
+	start = get_wall_time();
+	uint changes = 0;
+	for (uint i=0; i<n_updates; i++) {
+		const VINT& node = b.shell[getRandomUint(b.shell.size()-1)];
+		if (i%2)
+			changes += nodes.erase(node);
+		else
+			changes += nodes.insert(node).second;
+	}
+	double update_time = get_wall_time() - start;
+
+	start = get_wall_time();
+	VDOUBLE sum(0,0,0);
+	for (uint i=0; i<n_sweeps; i++) {
+		for (const auto& node : nodes)
+			sum += VDOUBLE(node);
+	}
+	double sweep_time = get_wall_time() - start;
+
+	cout << "[ BENCH    ] " << name << " with " << b.cell.size() << " nodes" << endl;
+	cout << "[ BENCH    ]   insert " << b.cell.size() / insert_time << " nodes/s, memory " << heap_nodes / 1024 << " KiB" << endl;
+	cout << "[ BENCH    ]   " << n_updates / update_time << " updates/s, " << changes << " changes, " << nodes.size() << " nodes" << endl;
+	cout << "[ BENCH    ]   iterate " << double(n_sweeps) * nodes.size() / sweep_time << " nodes/s, center " << sum / (double(n_sweeps) * nodes.size()) << endl;
+
+	// Both containers must end up with the same node content
+	set<VINT,less_VINT> reference(b.cell.begin(), b.cell.end());
+	setRandomSeed(42);
+	for (uint i=0; i<n_updates; i++) {
+		const VINT& node = b.shell[getRandomUint(b.shell.size()-1)];
+		if (i%2) reference.erase(node); else reference.insert(node);
+	}
+	EXPECT_EQ(nodes.size(), reference.size());
+	uint missing = 0;
+	for (const auto& node : reference)
+		missing += (nodes.count(node) == 0);
+	EXPECT_EQ(missing, 0u);
+}
+
+}
+
+TEST (NODE_SET, OrderedSet) {
+	runNodeSetBenchmark< set<VINT,less_VINT> >("set<VINT,less_VINT>");
+}
+
+TEST (NODE_SET, FlatNodeSet) {
+	runNodeSetBenchmark< FlatNodeSet >("FlatNodeSet");
+}
+
+TEST (NODE_SET, FlatNodeSetConsistency) {
+	setRandomSeed(7);
+	FlatNodeSet nodes;
+	set<VINT,less_VINT> reference;
+	for (uint i=0; i<200000; i++) {
+		VINT node(getRandomUint(30), getRandomUint(30), getRandomUint(3));
+		if (getRandom01() < 0.45) {
+			EXPECT_EQ(nodes.erase(node), reference.erase(node));
+		}
+		else {
+			EXPECT_EQ(nodes.insert(node).second, reference.insert(node).second);
+		}
+	}
+	EXPECT_EQ(nodes.size(), reference.size());
+	set<VINT,less_VINT> content(nodes.begin(), nodes.end());
+	EXPECT_TRUE(content == reference);
+	EXPECT_TRUE(nodes.find(VINT(-1,0,0)) == nodes.end());
+	while (!nodes.empty())
+		nodes.erase(nodes.begin());
+	EXPECT_EQ(nodes.count(VINT(1,1,1)), 0u);
+}
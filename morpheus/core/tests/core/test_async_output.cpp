@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+#include "core/traits.h"
+#include "core/async_output.h"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+
+string readFile(const string& filename) {
+	ifstream in(filename);
+	stringstream s;
+	s << in.rdbuf();
+	return s.str();
+}
+
+TEST (AsyncOutputFile, WriteAndAppend) {
+	const string filename = "async_output_test.txt";
+	stringstream expected;
+	{
+		AsyncOutputFile out(filename);
+		// exceed the chunk size to test intermediate submissions
+		for (int i=0; i<100000; i++) {
+			out << i << "\t" << 1.0/(i+1) << "\n";
+			expected << i << "\t" << 1.0/(i+1) << "\n";
+		}
+		// sync() also submits unflushed data
+		AsyncOutputFile::sync();
+		EXPECT_EQ(readFile(filename), expected.str());
+		out << "last line\n";
+		expected << "last line\n";
+	}
+	AsyncOutputFile::sync();
+	EXPECT_EQ(readFile(filename), expected.str());
+	
+	{
+		AsyncOutputFile out(filename, AsyncOutputFile::Mode::APPEND);
+		out << "appended\n";
+		expected << "appended\n";
+	}
+	AsyncOutputFile::sync();
+	EXPECT_EQ(readFile(filename), expected.str());
+	
+	{
+		AsyncOutputFile out(filename);
+	}
+	AsyncOutputFile::sync();
+	EXPECT_EQ(readFile(filename), "");
+	remove(filename.c_str());
+}
+
+TEST (AsyncOutputFile, ManyFiles) {
+	// more files than kept open by the I/O thread
+	const int n_files = 1100;
+	vector<unique_ptr<AsyncOutputFile>> files;
+	for (int i=0; i<n_files; i++) {
+		files.push_back(make_unique<AsyncOutputFile>("async_output_test_" + to_string(i) + ".txt"));
+	}
+	for (int j=0; j<3; j++) {
+		for (int i=0; i<n_files; i++) {
+			*files[i] << i << " " << j << "\n";
+			files[i]->flush();
+		}
+	}
+	files.clear();
+	AsyncOutputFile::sync();
+	for (int i=0; i<n_files; i++) {
+		string filename = "async_output_test_" + to_string(i) + ".txt";
+		EXPECT_EQ(readFile(filename), to_string(i) + " 0\n" + to_string(i) + " 1\n" + to_string(i) + " 2\n");
+		remove(filename.c_str());
+	}
+}
+
+TEST (AsyncOutputFile, SyncSelectedFiles) {
+	// Another thread keeps writing its own file while the selected one is synced
+	atomic<bool> done(false);
+	thread writer([&done] () {
+		AsyncOutputFile other("async_output_test_other.txt");
+		while (!done) {
+			other << "concurrent data\n";
+			other.flush();
+		}
+	});
+	stringstream expected;
+	{
+		AsyncOutputFile out("async_output_test_selected.txt");
+		for (int j=0; j<10; j++) {
+			for (int i=0; i<1000; i++) {
+				out << j << "\t" << i << "\n";
+				expected << j << "\t" << i << "\n";
+			}
+			AsyncOutputFile::sync({&out});
+			EXPECT_EQ(readFile("async_output_test_selected.txt"), expected.str());
+		}
+	}
+	done = true;
+	writer.join();
+	AsyncOutputFile::sync();
+	remove("async_output_test_selected.txt");
+	remove("async_output_test_other.txt");
+}
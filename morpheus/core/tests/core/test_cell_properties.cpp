@@ -0,0 +1,51 @@
+#include "test_operators.h"
+#include "core/celltype.h"
+
+TEST (CELL_PROPERTIES, SlotReuse) {
+	CellPropertyStore store;
+	store.addColumn(0, make_shared< PropertyColumn<double> >());
+	uint a = store.acquireSlot();
+	uint b = store.acquireSlot();
+	uint c = store.acquireSlot();
+	EXPECT_EQ(store.size(), 3u);
+	EXPECT_EQ(store.column<double>(0)->values.size(), 3u);
+
+	store.releaseSlot(b);
+	EXPECT_EQ(store.acquireSlot(), b);
+	EXPECT_EQ(store.size(), 3u);
+
+	store.releaseSlot(a);
+	store.releaseSlot(c);
+	store.acquireSlot(); store.acquireSlot();
+	EXPECT_EQ(store.acquireSlot(), 3u);
+
+	// Columns added later cover all slots
+	store.addColumn(1, make_shared< PropertyColumn<VDOUBLE> >());
+	EXPECT_EQ(store.column<VDOUBLE>(1)->values.size(), 4u);
+}
+
+TEST (CELL_PROPERTIES, ColumnBinding) {
+	CellPropertyStore store;
+	PrimitiveProperty<double> default_property("a", 2.5);
+	store.addColumn(0, default_property.createColumn());
+	auto column = store.column<double>(0);
+
+	auto p1 = static_pointer_cast<PrimitiveProperty<double>>(default_property.clone());
+	auto p2 = static_pointer_cast<PrimitiveProperty<double>>(default_property.clone());
+	uint s1 = store.acquireSlot(), s2 = store.acquireSlot();
+	p1->bind(store.column(0), s1);
+	p2->bind(store.column(0), s2);
+	EXPECT_EQ(column->values[s1], 2.5);
+	EXPECT_EQ(column->buffers[s2], 2.5);
+
+	p1->value() = 4;
+	p2->assign(p1);
+	EXPECT_EQ(column->values[s2], 4);
+	EXPECT_EQ(p2->value(), 4);
+
+	// Clones of bound properties are detached
+	auto p3 = static_pointer_cast<PrimitiveProperty<double>>(p1->clone());
+	p3->value() = 7;
+	EXPECT_EQ(p1->value(), 4);
+	EXPECT_EQ(default_property.value(), 2.5);
+}
@@ -0,0 +1,31 @@
+#include "gtest/gtest.h"
+#include "core/data_mapper.h"
+
+TEST (DATA_MAPPER, MergeEqualsSingleSlot) {
+	vector<double> values = { 3, -1.5, 2, 2, 7.25, 0, -4, 2, 3, 11 };
+	for (auto mode : DataMapper::getModeNames()) {
+		auto single = DataMapper::create(mode.second);
+		single->resize(1);
+		for (auto v : values) single->addVal(v, 0);
+
+		// Spread the values over 5 slots and merge them pairwise into slot 0
+		auto split = DataMapper::create(mode.second);
+		split->resize(5);
+		for (uint i=0; i<values.size(); i++) split->addVal(values[i], (i*3) % 5);
+		for (int stride=1; stride<5; stride*=2) {
+			for (int s=0; s+stride<5; s+=2*stride)
+				split->merge(s, s+stride);
+		}
+		EXPECT_NEAR(split->get(0), single->get(0), 1e-12) << "mapping " << mode.first;
+	}
+}
+
+TEST (DATA_MAPPER, ResizeResetsSlots) {
+	auto mapper = DataMapper::create(DataMapper::AVERAGE);
+	mapper->resize(3);
+	mapper->addVal(4, 2);
+	mapper->addVal(2, 2);
+	EXPECT_EQ(mapper->get(2), 3);
+	mapper->resize(3);
+	EXPECT_EQ(mapper->get(2), 0);
+}
@@ -0,0 +1,48 @@
+#include "test_operators.h"
+#include "core/flat_map.h"
+#include "core/random_functions.h"
+
+TEST (FLAT_MAP, Consistency) {
+	setRandomSeed(3);
+	FlatMap<uint, int, 4> flat;
+	map<uint, int> reference;
+	for (uint i=0; i<20000; i++) {
+		uint key = getRandomUint(20);
+		double r = getRandom01();
+		if (r < 0.3) {
+			EXPECT_EQ(flat.erase(key), reference.erase(key));
+		}
+		else if (r < 0.4) {
+			EXPECT_EQ(flat.insert(make_pair(key, int(i))).second, reference.insert(make_pair(key, int(i))).second);
+		}
+		else {
+			flat[key] += i;
+			reference[key] += i;
+		}
+		ASSERT_EQ(flat.size(), reference.size());
+	}
+	EXPECT_TRUE(std::equal(flat.begin(), flat.end(), reference.begin(),
+		[](const pair<uint,int>& a, const pair<const uint,int>& b) { return a.first == b.first && a.second == b.second; }));
+	for (uint key=0; key<=21; key++) {
+		EXPECT_EQ(flat.count(key), reference.count(key));
+	}
+}
+
+TEST (FLAT_MAP, InlineAndHeapStorage) {
+	FlatMap<uint, double, 2> a;
+	a[5] = 1; a[1] = 2;
+	FlatMap<uint, double, 2> b(a);
+	// exceed the inline storage
+	a[3] = 3;
+	EXPECT_EQ(a.size(), 3u);
+	EXPECT_EQ(a.begin()->first, 1u);
+	EXPECT_EQ(a.at(3), 3);
+	EXPECT_EQ(b.size(), 2u);
+	b = a;
+	a.clear();
+	EXPECT_TRUE(a.empty());
+	EXPECT_EQ(b.size(), 3u);
+	EXPECT_EQ(b.find(5)->second, 1);
+	EXPECT_TRUE(b.find(4) == b.end());
+	EXPECT_THROW(b.at(4), std::out_of_range);
+}
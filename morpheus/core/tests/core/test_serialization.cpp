@@ -1,6 +1,7 @@
 #include "test_operators.h"
 #include "core/traits.h"
 #include "core/delay.h"
+#include "core/checkpoint.h"
 
 
 TEST (SERIALIZATION, float) {
@@ -65,3 +66,27 @@ TEST (SERIALIZATION, DELAY_BUFFER) {
 	EXPECT_PRED_FORMAT2(EQ_PREC,a[2].value,b[2].value);
 	EXPECT_PRED_FORMAT2(EQ_PREC,a[2].time,b[2].time);
 }
+
+TEST (SERIALIZATION, BinaryCheckpoint) {
+	vector<double> a { M_PI, -1.0/3, 1e-300 };
+	vector<VINT> b { VINT(1,2,3), VINT(-4,5,-6) };
+	XMLNode xA, xB;
+	{
+		Checkpoint::Writer writer("test_checkpoint.bin");
+		EXPECT_EQ(Checkpoint::Writer::current(), &writer);
+		xA = writer.write(a.data(), a.size() * sizeof(double), sizeof(double));
+		xB = writer.write(b.data(), b.size() * sizeof(VINT), sizeof(VINT));
+	}
+	EXPECT_EQ(Checkpoint::Writer::current(), nullptr);
+	EXPECT_TRUE(Checkpoint::isBinary(xA));
+	
+	vector<double> a_restored(a.size());
+	vector<VINT> b_restored(b.size());
+	Checkpoint::read(xB, b_restored.data(), b_restored.size() * sizeof(VINT));
+	Checkpoint::read(xA, a_restored.data(), a_restored.size() * sizeof(double));
+	EXPECT_EQ(a, a_restored);
+	EXPECT_EQ(b[1].x, b_restored[1].x);
+	EXPECT_EQ(b[1].z, b_restored[1].z);
+	// Size mismatches are rejected
+	EXPECT_ANY_THROW(Checkpoint::read(xA, a_restored.data(), 2 * sizeof(double)));
+}
@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+#include "model_test.h"
+#include "core/simulation.h"
+#include "core/time_scheduler.h"
+#include "core/async_output.h"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+namespace {
+
+const vector<string> output_files = { "task_graph_u_u.csv", "task_graph_v_v.csv", "task_graph_ab.csv", "task_graph_mapped.csv" };
+
+/// Run the model and return the contents of its Logger files
+map<string, string> runModel(const string& model, bool task_graph) {
+	TimeScheduler::setTaskGraph(task_graph);
+	TestModel m(model);
+	m.run();
+	TimeScheduler::finish();
+	TimeScheduler::setTaskGraph(false);
+	SIM::wipe();
+	AsyncOutputFile::sync();
+
+	map<string, string> contents;
+	for (const auto& file : output_files) {
+		ifstream in(file);
+		EXPECT_TRUE(in.good()) << "Missing Logger output " << file;
+		stringstream s;
+		s << in.rdbuf();
+		contents[file] = s.str();
+		remove(file.c_str());
+	}
+	return contents;
+}
+
+}
+
+TEST (TaskGraph, SameOutputAsSerial) {
+	auto file = ImportFile("task_graph.xml");
+	string model = file.getDataAsString();
+#ifdef HAVE_OPENMP
+	// Let the tasks of a wave run concurrently
+	int max_threads = omp_get_max_threads();
+	omp_set_num_threads(4);
+#endif
+	auto serial = runModel(model, false);
+	auto concurrent = runModel(model, true);
+#ifdef HAVE_OPENMP
+	omp_set_num_threads(max_threads);
+#endif
+
+	for (const auto& file : output_files) {
+		EXPECT_FALSE(serial[file].empty()) << file;
+		// Parallel reductions within concurrent tasks may differ in the last bits
+		istringstream s(serial[file]), c(concurrent[file]);
+		string s_token, c_token;
+		int tokens = 0;
+		while (s >> s_token) {
+			ASSERT_TRUE(bool(c >> c_token)) << file << " ends after " << tokens << " values";
+			char* s_end, * c_end;
+			double s_val = strtod(s_token.c_str(), &s_end), c_val = strtod(c_token.c_str(), &c_end);
+			if (*s_end == 0 && *c_end == 0)
+				EXPECT_NEAR(s_val, c_val, 1e-9 * max(1.0, fabs(s_val))) << file << " value " << tokens;
+			else
+				EXPECT_EQ(s_token, c_token) << file << " value " << tokens;
+			tokens++;
+		}
+		EXPECT_FALSE(bool(c >> c_token)) << file << " has additional values";
+	}
+}
@@ -64,6 +64,45 @@ TEST (ExpressionEvaluator, JoinedCache) {
 }
 
 
+TEST (ExpressionEvaluator, ChangeStamps) {
+	auto scope = make_shared<Scope>();
+	auto cache = make_shared<EvaluatorCache>(scope.get());
+	auto variable_a = make_shared<PrimitiveVariableSymbol<double>>("a","a test a",3.0);
+	auto variable_b = make_shared<PrimitiveVariableSymbol<double>>("b","a test b",2.0);
+	scope->registerSymbol(variable_a);
+	scope->registerSymbol(variable_b);
+	
+	// Global expressions of stamped symbols are memoized and the shared cache skips unchanged symbols
+	auto evaluator = make_unique<ExpressionEvaluator<double>>("a*b+1",cache);
+	auto evaluator2 = make_unique<ExpressionEvaluator<double>>("a+1",cache);
+	evaluator->init();
+	evaluator2->init();
+	EXPECT_EQ(evaluator->get(SymbolFocus::global),7);
+	EXPECT_EQ(evaluator->get(SymbolFocus::global),7);
+	EXPECT_EQ(evaluator2->get(SymbolFocus::global),4);
+	
+	auto stamp = variable_a->stamp();
+	variable_a->set(SymbolFocus::global, 5.0);
+	EXPECT_GT(variable_a->stamp(), stamp);
+	EXPECT_EQ(evaluator2->get(SymbolFocus::global),6);
+	EXPECT_EQ(evaluator->get(SymbolFocus::global),11);
+	
+	variable_b->setBuffer(SymbolFocus::global, 4.0);
+	EXPECT_EQ(evaluator->get(SymbolFocus::global),11);
+	variable_b->applyBuffer();
+	EXPECT_EQ(evaluator->get(SymbolFocus::global),21);
+	EXPECT_EQ(evaluator2->get(SymbolFocus::global),6);
+	
+	// Vector components follow the stamp of their vector symbol
+	auto variable_v = make_shared<PrimitiveVariableSymbol<VDOUBLE>>("v","a test v",VDOUBLE(1,2,3));
+	scope->registerSymbol(variable_v);
+	auto evaluator3 = make_unique<ExpressionEvaluator<double>>("v.x*a",cache);
+	evaluator3->init();
+	EXPECT_EQ(evaluator3->get(SymbolFocus::global),5);
+	variable_v->set(SymbolFocus::global, VDOUBLE(2,2,3));
+	EXPECT_EQ(evaluator3->get(SymbolFocus::global),10);
+}
+
 TEST (ExpressionEvaluator, VectorSymbols) {
 	auto scope = make_shared<Scope>();
 	auto cache = make_shared<EvaluatorCache>(scope.get());
@@ -1,6 +1,7 @@
 #include "gtest/gtest.h"
 #include "muParser/muParser.h"
 #include <memory>
+#include <vector>
 using std::make_shared;
 
 double return_nargs(const double* cargs, int nargs) {
@@ -57,3 +58,73 @@ TEST (MUPARSER, OVERLOADING_GENERIC) {
 	EXPECT_EQ(parser->Eval(&data),data);
 	
 }
+
+TEST (MUPARSER, BULK) {
+	const int n = 37;
+	std::vector<double> x(n), y(n), bulk(n);
+	for (int i=0; i<n; i++) { x[i] = 0.1 * i - 1.05; y[i] = 2 + 0.3 * i; }
+	double data = 256;
+	auto rdata = make_shared<return_data_generic>();
+	
+	auto parser = make_shared<mu::Parser>();
+	parser->DefineFun("args",return_nargs);
+	parser->DefineFun("data",rdata.get());
+	// column-wise evaluation and the per item fallback for conditionals
+	for (auto expr : { "x^2 + 3*x*y - sin(y)/x + args(x,y,1) + data() + max(x,y) + (x<y) * y^x", "x<0 ? -x : y*3" }) {
+		parser->SetExpr(expr);
+		double xv, yv;
+		parser->DefineVar("x", &xv);
+		parser->DefineVar("y", &yv);
+		std::vector<double> scalar(n);
+		for (int i=0; i<n; i++) { xv = x[i]; yv = y[i]; scalar[i] = parser->Eval(&data); }
+		
+		parser->DefineVar("x", &x[0]);
+		parser->DefineVar("y", &y[0]);
+		parser->Eval(&bulk[0], n, &data);
+		EXPECT_EQ(bulk, scalar) << expr;
+		// bytecode is kept for subsequent bulk evaluations
+		x[3] = 5;
+		parser->Eval(&bulk[0], n, &data);
+		parser->DefineVar("x", &xv);
+		parser->DefineVar("y", &yv);
+		xv = 5; yv = y[3];
+		EXPECT_EQ(bulk[3], parser->Eval(&data)) << expr;
+		x[3] = 0.1 * 3 - 1.05;
+	}
+}
+
+TEST (MUPARSER, TAPE) {
+	double x = 0, y = 0, z = 0, data = 256;
+	auto rdata = make_shared<return_data_generic>();
+	auto r4 = make_shared<return_4_generic>();
+	auto parser = make_shared<mu::Parser>();
+	parser->DefineVar("x", &x);
+	parser->DefineVar("y", &y);
+	parser->DefineVar("z", &z);
+	parser->DefineFun("args",return_nargs);
+	parser->DefineFun("four",r4.get());
+	parser->DefineFun("data",rdata.get());
+	
+	const char* expressions[] = {
+		"x", "-x", "2.5", "x*y + 2*x - y/3", "x^2 - y^3 + x^4 + (x*x+y*y)^1.5 + 2^x",
+		"sin(x) + cos(x*y) + min(x,y,z) + max(x,2) + args(x,y,z,1)", "four(x) + data() * y",
+		"x<y ? x*2 : (y<z ? y : z)", "(x>0 ? 1 : 2) + (y>0 ? (z>0 ? 3 : 4) : 5)",
+		"x<=y && y>=z || x==z || x!=y", "z = x*y, z+1", "x, y*2, z^2"
+	};
+	const double values[] = { -1.5, 0.0, 0.7, 2.0 };
+	for (auto expr : expressions) {
+		for (double xv : values) for (double yv : values) {
+			std::vector<double> results[2];
+			for (int tape=0; tape<2; tape++) {
+				mu::ParserBase::EnableTape(tape);
+				parser->SetExpr(expr);
+				x = xv; y = yv; z = xv - yv;
+				int n;
+				double* r = parser->Eval(n, &data);
+				results[tape].assign(r, r+n);
+			}
+			EXPECT_EQ(results[0], results[1]) << expr << " at x=" << xv << " y=" << yv;
+		}
+	}
+	mu::ParserBase::EnableTape(true);
+}
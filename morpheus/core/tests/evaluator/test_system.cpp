@@ -2,6 +2,9 @@
 #include "core/system.h"
 #include "core/property.h"
 #include "core/time_scheduler.h"
+#include "core/simulation.h"
+#include "core/focusrange.h"
+#include "model_test.h"
 
 using std::string;
 // using std::unique_ptr;
@@ -142,6 +145,69 @@ TEST (System, Solver_RK23) {
 // 	std::cout << "Solving System took " << i << " substeps" << std::endl;
 }
 
+/// The model is imported at a single place, each ImportFile() call is injected as a separate ressource
+string batchModel() {
+	auto file = ImportFile("system_batch.xml");
+	return file.getDataAsString();
+}
+
+TEST (System, Batched) {
+	auto model = TestModel(batchModel());
+	model.run();
+	
+	auto k = SIM::findGlobalSymbol<double>("k");
+	auto u = SIM::findGlobalSymbol<double>("u");
+	auto v = SIM::findGlobalSymbol<double>("v");
+	auto w = SIM::findGlobalSymbol<double>("w");
+	double time = SIM::getTime();
+	FocusRange range(Granularity::Node, SIM::getGlobalScope());
+	ASSERT_GT(range.size(), 2 * SystemSolver::batch_size);
+	for (const auto& focus : range) {
+		double solution = exp(-k->get(focus) * time);
+		EXPECT_NEAR(u->get(focus), solution, solution * 1e-5);
+		EXPECT_EQ(v->get(focus), 2 * u->get(focus));
+		EXPECT_NEAR(w->get(focus), solution, solution * 1e-6);
+	}
+}
+
+
+TEST (System, BatchedMatchesPerNode) {
+	string model = batchModel();
+	// The adaptive and the fixed step systems are replaced by each solver of the kind
+	vector<pair<string, string>> solvers = {
+		{"dormand-prince", "runge-kutta"}, {"cash-karp", "heun"}, {"bogacki-shampine", "euler"}
+	};
+	for (const auto& solver : solvers) {
+		string solver_model = model;
+		for (auto s : {"dormand-prince", "runge-kutta"}) {
+			string from = string("solver=\"") + s + "\"", to = string("solver=\"") + (s == string("runge-kutta") ? solver.second : solver.first) + "\"";
+			for (auto pos = solver_model.find(from); pos != string::npos; pos = solver_model.find(from, pos + to.size()))
+				solver_model.replace(pos, from.size(), to);
+		}
+		TestModel m(solver_model);
+		m.run();
+		
+		// The systems of the *_node fields contain a local Function and are thus solved node by node
+		FocusRange range(Granularity::Node, SIM::getGlobalScope());
+		for (string symbol : {"u", "v", "w", "x"}) {
+			auto batched = SIM::findGlobalSymbol<double>(symbol);
+			auto per_node = SIM::findGlobalSymbol<double>(symbol + "_node");
+			for (const auto& focus : range) {
+				EXPECT_EQ(batched->get(focus), per_node->get(focus)) << solver.first << "/" << solver.second << ": " << symbol << " at " << focus.pos();
+			}
+		}
+		// Cell properties are read from their columns when solved in batches
+		auto ct = CPM::findCellType("ct").lock();
+		ASSERT_TRUE(ct);
+		auto c = ct->getScope()->findSymbol<double>("c");
+		auto c_cell = ct->getScope()->findSymbol<double>("c_cell");
+		ASSERT_FALSE(ct->getCellIDs().empty());
+		for (auto id : ct->getCellIDs()) {
+			EXPECT_EQ(c->get(SymbolFocus(id)), c_cell->get(SymbolFocus(id))) << solver.first << ": cell " << id;
+			EXPECT_LT(c->get(SymbolFocus(id)), 1);
+		}
+	}
+}
 
 
 /*
@@ -57,3 +57,36 @@ TEST (FieldDiffusion, Cubic) {
 	auto total_error = SIM::findGlobalSymbol<double>("total_error") -> get(SymbolFocus::global);
 	EXPECT_NEAR(total_error/initial_mass, 0, operator_error_tolerance_factor);
 }
+
+// Implicit euler is first order in time, thus compared at a larger tolerance
+const double implicit_operator_error_tolerance_factor = 1e-2;
+
+TEST (FieldDiffusion, SquareMultigrid) {
+	
+	auto file1 = ImportFile("field_diffusion_004.xml");
+	auto model = TestModel(file1.getDataAsString());
+
+	model.run();
+	
+	auto initial_mass = SIM::findGlobalSymbol<double>("initial_mass") -> get(SymbolFocus::global);
+	auto mass = SIM::findGlobalSymbol<double>("mass") -> get(SymbolFocus::global);
+	EXPECT_NEAR(mass, initial_mass, initial_mass*mass_error_tolerance_factor);
+	
+	auto total_error = SIM::findGlobalSymbol<double>("total_error") -> get(SymbolFocus::global);
+	EXPECT_NEAR(total_error/initial_mass, 0, implicit_operator_error_tolerance_factor);
+}
+
+TEST (FieldDiffusion, CubicADI) {
+	
+	auto file1 = ImportFile("field_diffusion_005.xml");
+	auto model = TestModel(file1.getDataAsString());
+
+	model.run();
+	
+	auto initial_mass = SIM::findGlobalSymbol<double>("initial_mass") -> get(SymbolFocus::global);
+	auto mass = SIM::findGlobalSymbol<double>("mass") -> get(SymbolFocus::global);
+	EXPECT_NEAR(mass, initial_mass, initial_mass*mass_error_tolerance_factor);
+	
+	auto total_error = SIM::findGlobalSymbol<double>("total_error") -> get(SymbolFocus::global);
+	EXPECT_NEAR(total_error/initial_mass, 0, implicit_operator_error_tolerance_factor);
+}
@@ -2,6 +2,8 @@
 #include "equation.h"
 #include "vector_equation.h"
 #include "system.h"
+#include "profiler.h"
+#include <exception>
 
 
 template<class T> 
@@ -25,7 +27,72 @@ bool set_disjoint(const std::set<T> &set1, const std::set<T> &set2)
     return true;
 }
 
+/// Run the due plugins of a wave, concurrently as OpenMP tasks if there are more than one
+template <class T, class Due, class Run>
+void runWave(const vector<T*>& wave, Due due, Run run, Plugin*& current_plugin)
+{
+	if (wave.size() == 1) {
+		if (due(wave[0])) {
+			current_plugin = wave[0];
+			run(wave[0]);
+		}
+		return;
+	}
+	
+	vector<T*> ready;
+	for (auto tsl : wave) {
+		if (due(tsl)) ready.push_back(tsl);
+	}
+	if (ready.size() <= 1) {
+		for (auto tsl : ready) {
+			current_plugin = tsl;
+			run(tsl);
+		}
+		return;
+	}
+	
+	// Exceptions must not leave a task, keep the first one and rethrow after the wave
+	std::exception_ptr error;
+	Plugin* failed_plugin = nullptr;
+#pragma omp parallel
+#pragma omp single
+	{
+		for (auto tsl : ready) {
+#pragma omp task firstprivate(tsl)
+			{
+				try {
+					run(tsl);
+				}
+				catch (...) {
+#pragma omp critical (task_graph_error)
+					if (!error) {
+						error = std::current_exception();
+						failed_plugin = tsl;
+					}
+				}
+			}
+		}
+	}
+	if (error) {
+		current_plugin = failed_plugin;
+		std::rethrow_exception(error);
+	}
+}
+
+template <class T>
+void printWaves(const vector< vector<T*> >& waves)
+{
+	for (const auto& wave : waves) {
+		if (wave.size() < 2) continue;
+		vector<string> names;
+		for (auto tsl : wave)
+			names.push_back(tsl->getFullName().empty() ? tsl->XMLName() : tsl->XMLName() + " [" + tsl->getFullName() + "]");
+		cout << "  + " << join(names," | ") << "\n";
+	}
+}
+
 unique_ptr<TimeScheduler> TimeScheduler::sched;
+bool TimeScheduler::task_graph = false;
 
 TimeScheduler::TimeScheduler() : start_time("StartTime",0), save_interval("SaveInterval",-1), is_state_valid(false), stop_time("StopTime",1000) {};
 
@@ -45,6 +112,63 @@ void TimeScheduler::wipe()
 }
 
 
+TimeScheduler::SymbolAccess TimeScheduler::symbolAccess(TimeStepListener* tsl) const
+{
+	SymbolAccess access;
+	access.reads = tsl->getDependSymbols();
+	auto leaf_reads = tsl->getLeafDependSymbols();
+	access.reads.insert(leaf_reads.begin(), leaf_reads.end());
+	access.writes = tsl->getOutputSymbols();
+	auto leaf_writes = tsl->getLeafOutputSymbols();
+	access.writes.insert(leaf_writes.begin(), leaf_writes.end());
+	
+	// Equation hooks are evaluated within the System
+	auto hooks = sub_step_hooks.find(tsl);
+	if (hooks != sub_step_hooks.end()) {
+		for (auto hook : hooks->second) {
+			auto hook_writes = hook->getLeafOutputSymbols();
+			access.writes.insert(hook_writes.begin(), hook_writes.end());
+		}
+	}
+	
+	// Cell creation, removal and motion is not covered by symbols
+	auto continuous = dynamic_cast<ContinuousProcessPlugin*>(tsl);
+	access.exclusive = dynamic_cast<InstantaneousProcessPlugin*>(tsl) || (continuous && continuous->getRank() == ContinuousProcessPlugin::MCS);
+	return access;
+}
+
+template <class T, class Ordered>
+TimeScheduler::Waves<T> TimeScheduler::createWaves(const vector<T*>& listeners, Ordered ordered) const
+{
+	Waves<T> waves;
+	if (!task_graph) {
+		for (auto tsl : listeners)
+			waves.push_back( vector<T*>(1,tsl) );
+		return waves;
+	}
+	
+	vector<SymbolAccess> access;
+	vector<uint> wave_of;
+	for (uint i=0; i<listeners.size(); i++) {
+		access.push_back(symbolAccess(listeners[i]));
+		uint wave = 0;
+		for (uint j=0; j<i; j++) {
+			bool conflict = listeners[i] == listeners[j] || ordered(listeners[j], listeners[i])
+				|| access[i].exclusive || access[j].exclusive
+				|| ! set_disjoint(access[i].writes, access[j].writes)
+				|| ! set_disjoint(access[i].writes, access[j].reads)
+				|| ! set_disjoint(access[i].reads, access[j].writes);
+			if (conflict)
+				wave = max(wave, wave_of[j]+1);
+		}
+		wave_of.push_back(wave);
+		if (wave == waves.size())
+			waves.push_back( vector<T*>() );
+		waves[wave].push_back(listeners[i]);
+	}
+	return waves;
+}
+
 void TimeScheduler::loadFromXML(XMLNode xTime, Scope* scope)
 {
 	TimeScheduler& ts = getInstance();
@@ -105,8 +229,10 @@ void TimeScheduler::init(Scope* scope)
 				
 				hooks.push_back(eqn);
 			}
-			if (!hooks.empty())
+			if (!hooks.empty()) {
 				static_cast<ContinuousSystem*>(tsl)->setSubStepHooks(hooks);
+				ts.sub_step_hooks[tsl] = hooks;
+			}
 		}
 	}
 	
@@ -324,6 +450,14 @@ void TimeScheduler::init(Scope* scope)
 	else 
 		ts.time_precision_patch = 1e-6;
 	
+	// Group the plugins of each phase into waves of mutually independent plugins
+	ts.continuous_waves = ts.createWaves(ts.continuous, [] (ContinuousProcessPlugin* lhs, ContinuousProcessPlugin* rhs) { return lhs->getRank() != rhs->getRank(); } );
+	ts.phase2_waves = ts.createWaves(ts.all_phase2, [] (TimeStepListener*, TimeStepListener*) { return false; } );
+	ts.analyser_waves = ts.createWaves(ts.analysers, [] (AnalysisPlugin*, AnalysisPlugin*) { return false; } );
+#ifdef HAVE_OPENMP
+	// Plugins running as tasks must not open nested teams, their per-thread data is indexed by omp_get_thread_index()
+	if (task_graph) omp_set_max_active_levels(1);
+#endif
 	
 	cout << " \n";
 	cout << "======================================================\n";
@@ -379,6 +513,15 @@ void TimeScheduler::init(Scope* scope)
 	}
 	cout << "------------------------------------------------------\n";
 	
+	if (task_graph) {
+		cout << "\n";
+		cout << "=====|  Concurrent Plugins  |=========================\n";
+		printWaves(ts.continuous_waves);
+		printWaves(ts.phase2_waves);
+		printWaves(ts.analyser_waves);
+		cout << "------------------------------------------------------\n";
+	}
+	
 	cout << "======================================================\n";
 	cout << endl;
 	
@@ -441,21 +584,18 @@ void TimeScheduler::compute()
 			// PHASE I -- TIME CONTINUOUS -- Synchronously updates schemes
 			///////////////////////////////////////////////////////////////
 			
+			auto due = [&ts] (TimeStepListener* tsl) { return tsl->currentTime() <= ts.current_time + ts.time_precision_patch; };
+			
 			// Run the computations to a buffer for reactions, ...
-			for (uint i=0; i<ts.continuous.size(); i++) {
-				if (ts.continuous[i]->currentTime() <= ts.current_time + ts.time_precision_patch) {
-					current_plugin = ts.continuous[i];
-					ts.continuous[i]->prepareTimeStep_internal(min_current_time);
-				}
+			for (const auto& wave : ts.continuous_waves) {
+				runWave(wave, due, [min_current_time] (ContinuousProcessPlugin* tsl) { tsl->prepareTimeStep_internal(min_current_time); }, current_plugin);
 			}
 			
 			// Now execute all required updates on continuous-time schemes. First will be CPM, then Delays, then Reactions, then Diffusion
-			for (uint i=0; i<ts.continuous.size(); i++) {
-				if (ts.continuous[i]->currentTime() <= ts.current_time + ts.time_precision_patch) {
-					current_plugin = ts.continuous[i];
-					ts.continuous[i]->executeTimeStep_internal();
-				}
-				min_current_time = min(min_current_time,ts.continuous[i]->currentTime() );
+			for (const auto& wave : ts.continuous_waves) {
+				runWave(wave, due, [] (ContinuousProcessPlugin* tsl) { tsl->executeTimeStep_internal(); }, current_plugin);
+				for (auto tsl : wave)
+					min_current_time = min(min_current_time, tsl->currentTime());
 			}
 			
 			// Now also respect the instantaneous processes and look how far in the future they are valid
@@ -471,11 +611,8 @@ void TimeScheduler::compute()
 			// PHASE II -- INSTANTANEOUS, sequentially sorted (Equations, Events, Reporters)
 			////////////////////////////////////////////////////////////////////////////////
 			
-			for (uint i=0; i<ts.all_phase2.size(); i++) {
-				if (ts.all_phase2[i]->currentTime() <= ts.current_time + ts.time_precision_patch) {
-					current_plugin = ts.all_phase2[i];
-					ts.all_phase2[i]->executeTimeStep_internal();
-				}
+			for (const auto& wave : ts.phase2_waves) {
+				runWave(wave, due, [] (TimeStepListener* tsl) { tsl->executeTimeStep_internal(); }, current_plugin);
 			}
 
 
@@ -483,11 +620,8 @@ void TimeScheduler::compute()
 			// PHASE III -- ANALYSIS
 			////////////////////////////////////////////////////////////////////////////////
 			
-			for (uint i=0; i<ts.analysers.size(); i++) {
-				if (ts.analysers[i]->currentTime() <= ts.current_time + ts.time_precision_patch) {
-					current_plugin = ts.analysers[i];
-					ts.analysers[i]->executeTimeStep_internal();
-				}
+			for (const auto& wave : ts.analyser_waves) {
+				runWave(wave, due, [] (AnalysisPlugin* tsl) { tsl->executeTimeStep_internal(); }, current_plugin);
 			}
 			
 			// Progress notification
@@ -497,6 +631,7 @@ void TimeScheduler::compute()
 	// 				 << SIM::sim_stop_time.getTimeScaleUnit()
 					<< endl;
 				ts.last_progress_notification = ts.current_time;
+				Profiler::sample(ts.current_time);
 			}
 			
 			// Checkpointing 
@@ -579,6 +714,10 @@ void TimeScheduler::finish()
 	
 	namespace pt = boost::property_tree;
 	auto& perf_json = SIM::getPerfLogger();
+	if (Profiler::enabled()) {
+		Profiler::sample(ts.current_time);
+		Profiler::write(perf_json);
+	}
 	
 	for (uint i=0; i<ts.all_listeners.size(); i++) {
 		pt::ptree entry;
@@ -602,6 +741,10 @@ void TimeScheduler::finish()
 	ts.instantaneous.clear();
 	ts.all_phase2.clear();
 	ts.analysers.clear();
+	ts.continuous_waves.clear();
+	ts.phase2_waves.clear();
+	ts.analyser_waves.clear();
+	ts.sub_step_hooks.clear();
 	
 	ts.stop_condition.reset();
 }
@@ -40,6 +40,15 @@
  *  \section UpdatePhase Update phases
  * 
  *  Conservative time propagation.
+ * 
+ *  \section TaskGraph Task graph execution
+ * 
+ *  Within each phase, the ordered plugins are grouped into waves. A plugin joins the first wave
+ *  after all preceding plugins it conflicts with, i.e. that write a symbol it reads or writes, or
+ *  read a symbol it writes. Instantaneous processes and the CPM sampler may modify cells beyond their
+ *  declared symbols and thus always form a wave of their own.
+ *  If enabled (see TimeScheduler::setTaskGraph), plugins of a wave run concurrently as OpenMP tasks.
+ *  Otherwise each wave holds a single plugin in sequential order.
  */
 
 class TimeScheduler {
@@ -55,6 +64,22 @@ private:
 	vector<TimeStepListener *> all_phase2;
 	vector<AnalysisPlugin *> analysers;
 	
+	/// Groups of mutually independent plugins, executed one after the other
+	template <class T> using Waves = vector< vector<T*> >;
+	Waves<ContinuousProcessPlugin> continuous_waves;
+	Waves<TimeStepListener> phase2_waves;
+	Waves<AnalysisPlugin> analyser_waves;
+	map<TimeStepListener*, vector<ReporterPlugin*> > sub_step_hooks;
+	static bool task_graph;
+	
+	struct SymbolAccess {
+		set<SymbolDependency> reads, writes;
+		bool exclusive;
+	};
+	SymbolAccess symbolAccess(TimeStepListener* tsl) const;
+	template <class T, class Ordered>
+	Waves<T> createWaves(const vector<T*>& listeners, Ordered ordered) const;
+	
 	Scope* global_scope;
 	double current_time;
 	double last_save_time;
@@ -76,6 +101,8 @@ public:
 	static void loadFromXML(XMLNode xTime, Scope* scope);
 	static XMLNode saveToXML();
 
+	/// Run mutually independent plugins of the same phase concurrently, must be set before init()
+	static void setTaskGraph(bool enabled) { task_graph = enabled; }
 	static void init(Scope* scope);
 	/// compute until time 
 	static void compute();
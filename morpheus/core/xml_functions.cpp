@@ -5,13 +5,12 @@ string readFile(string filename) {
 	if (file==NULL) { cerr << "unable to open file " << filename << endl; exit(-1); }
 	cout << "Initializing from file " << filename << endl;
 	string stringbuff;	int error;
-	char* buff= (char*)malloc(16384*sizeof(char));
+	const int buff_size = 1<<18;
+	vector<char> buff(buff_size);
 	int i;
-	while ((i=gzread(file,buff,sizeof(buff)))>0) {
-		buff[i]='\0';
-		stringbuff+=buff;
+	while ((i=gzread(file,buff.data(),buff_size))>0) {
+		stringbuff.append(buff.data(),i);
 	}
-	free(buff);
 	gzerror(file,&error);
 	gzclose(file); 
 	if (!(error==Z_STREAM_END or error==Z_OK)) {
@@ -71,7 +71,11 @@ void Logger::loadFromXML(const XMLNode xNode, Scope* scope){
 		writers.push_back(output);
 	}
 	if (xOutput.nChildNode("HDF5Output")) {
-		// not implemented yet
+#ifdef HAVE_HDF5
+		writers.push_back(make_shared<LoggerHDF5Writer>(*this, "Output/HDF5Output"));
+#else
+		throw MorpheusException("Logger: HDF5Output is not available, Morpheus was built without hdf5 support.", xNode);
+#endif
 	}
 
 	// plots
@@ -266,8 +270,17 @@ void Logger::analyse(double time){
 	}
 }
 
+void Logger::syncOutput() {
+	for (auto out : writers) {
+		out->sync();
+	}
+}
+
 void Logger::finish(){
 //    cout << "Logger::finish..." << endl;
+	for (auto out : writers) {
+		out->finish();
+	}
 // 	for(auto p:plots)
 // 		p->finish();
 }
@@ -394,6 +407,44 @@ LoggerTextWriter::LoggerTextWriter(Logger& logger, LoggerTextWriter::OutputForma
 }
 
 
+/// Names of the symbols providing the position along the data axes of a FocusRange
+static vector<string> axisSymbolNames(const vector<FocusRangeAxis>& axes) {
+	vector<string> names;
+	for (auto& axis : axes) {
+		switch(axis) {
+			case FocusRangeAxis::CELL :
+				names.push_back(SymbolBase::CellID_symbol);
+				break;
+			case FocusRangeAxis::X :
+				names.push_back(SymbolBase::Space_symbol+".x");
+				break;
+			case FocusRangeAxis::Y :
+				names.push_back(SymbolBase::Space_symbol+".y");
+				break;
+			case FocusRangeAxis::Z :
+				names.push_back(SymbolBase::Space_symbol+".z");
+				break;
+			case FocusRangeAxis::MEM_X :
+				names.push_back(SymbolBase::MembraneSpace_symbol+".phi");
+				break;
+			case FocusRangeAxis::MEM_Y :
+				names.push_back(SymbolBase::MembraneSpace_symbol+".theta");
+				break;
+			case FocusRangeAxis::NODE :
+				names.push_back(SymbolBase::Space_symbol+".x");
+				if (SIM::lattice().getDimensions()>1)
+					names.push_back(SymbolBase::Space_symbol+".y");
+				if (SIM::lattice().getDimensions()>2)
+					names.push_back(SymbolBase::Space_symbol+".z");
+				break;
+			default:
+				assert(0);
+				break;
+		}
+	}
+	return names;
+}
+
 void LoggerTextWriter::init() {
 
 // 	cout << "LoggerTextWriter::init" << endl;
@@ -457,48 +508,9 @@ void LoggerTextWriter::init() {
 		csv_header.push_back(SymbolBase::Time_symbol);
 // 		}
 		
-		for (auto& axis :range.dataAxis() ) {
-			switch(axis) {
-				case FocusRangeAxis::CELL :
-					output_symbols.push_back( output_scope->findSymbol<double>(SymbolBase::CellID_symbol) );
-					csv_header.push_back(SymbolBase::CellID_symbol);
-					break;
-				case FocusRangeAxis::X :
-					csv_header.push_back(SymbolBase::Space_symbol+".x");
-					output_symbols.push_back( output_scope->findSymbol<double>(SymbolBase::Space_symbol+".x") );
-					break;
-				case FocusRangeAxis::Y :
-					csv_header.push_back(SymbolBase::Space_symbol+".y");
-					output_symbols.push_back( output_scope->findSymbol<double>(SymbolBase::Space_symbol+".y") );
-					break;
-				case FocusRangeAxis::Z :
-					csv_header.push_back(SymbolBase::Space_symbol+".z");
-					output_symbols.push_back( output_scope->findSymbol<double>(SymbolBase::Space_symbol+".z") );
-					break;
-				case FocusRangeAxis::MEM_X :
-					csv_header.push_back(SymbolBase::MembraneSpace_symbol+".phi");
-					output_symbols.push_back( output_scope->findSymbol<double>(SymbolBase::MembraneSpace_symbol+".phi") );
-					break;
-				case FocusRangeAxis::MEM_Y :
-					csv_header.push_back(SymbolBase::MembraneSpace_symbol+".theta");
-					output_symbols.push_back( output_scope->findSymbol<double>(SymbolBase::MembraneSpace_symbol+".theta") );
-					break;
-				case FocusRangeAxis::NODE :
-					csv_header.push_back(SymbolBase::Space_symbol+".x");
-					output_symbols.push_back( output_scope->findSymbol<double>(SymbolBase::Space_symbol+".x") );
-					if (SIM::lattice().getDimensions()>1) {
-						csv_header.push_back(SymbolBase::Space_symbol+".y");
-						output_symbols.push_back( output_scope->findSymbol<double>(SymbolBase::Space_symbol+".y") );
-					}
-					if (SIM::lattice().getDimensions()>2) {
-						csv_header.push_back(SymbolBase::Space_symbol+".z");
-						output_symbols.push_back( output_scope->findSymbol<double>(SymbolBase::Space_symbol+".z") );
-					}
-					break;
-				default:
-					assert(0);
-					break;
-			}
+		for (const auto& axis_symbol : axisSymbolNames(range.dataAxis())) {
+			csv_header.push_back(axis_symbol);
+			output_symbols.push_back( output_scope->findSymbol<double>(axis_symbol) );
 		}
 		
 		auto& symbols = logger.getInputs();
@@ -575,20 +587,30 @@ vector<string> LoggerTextWriter::getDataFiles() {
 	return ret;
 }
 
-unique_ptr<ofstream> LoggerTextWriter::getOutFile(const SymbolFocus& focus, string symbol) {
+AsyncOutputFile& LoggerTextWriter::getOutFile(const SymbolFocus& focus, string symbol) {
 	
 	string filename = getDataFile(focus, SIM::getTime(), symbol);
 	
-	// if we already had the file just open it
+	// Matrices of separate cells are written in parallel
+	std::lock_guard<std::mutex> lock(out_files_mutex);
+	
+	// if the file is still open just use it
+	auto it = out_files.find(filename);
+	if (it != out_files.end()) {
+		return *it->second;
+	}
+	
+	// if we already had the file, reopen it
 	bool file_was_opened = files_opened.find(filename) != files_opened.end();
+	auto& out = out_files[filename];
 	if (file_was_opened) {
-		auto out = make_unique<ofstream>(filename, ofstream::out | ofstream::app);
+		out = make_unique<AsyncOutputFile>(filename, AsyncOutputFile::Mode::APPEND);
 		*out  << setprecision(10);
-		return out;
+		return *out;
 	}
 	
 	// first time opened : truncate and write header
-	auto out = make_unique<ofstream>(filename, ofstream::out | ofstream::trunc);
+	out = make_unique<AsyncOutputFile>(filename, AsyncOutputFile::Mode::TRUNCATE);
 	if (file_format == OutputFormat::CSV && header() ) {
 		//out << "#";
 		string guard =  header_guarding() ? "\"" : "";
@@ -607,7 +629,11 @@ unique_ptr<ofstream> LoggerTextWriter::getOutFile(const SymbolFocus& focus, stri
 	
 	files_opened.insert(filename);
 	
-	return out;
+	return *out;
+}
+
+void LoggerTextWriter::closeOutFiles() {
+	out_files.clear();
 }
 
 
@@ -615,10 +641,37 @@ void LoggerTextWriter::write()
 {
 	file_write_count++;
 	
+	// Files of the previous time step are complete
+	if (file_separation == FileSeparation::TIME || file_separation == FileSeparation::TIME_CELL)
+		closeOutFiles();
+	
 	if (file_format == OutputFormat::CSV)
 		writeCSV();
 	else
 		writeMatrix();
+	
+	// Hand the data to the I/O thread once in a while, sync() submits the remainder on demand
+	auto now = std::chrono::steady_clock::now();
+	if (now - last_flush > std::chrono::seconds(1)) {
+		for (auto& out : out_files) {
+			out.second->flush();
+		}
+		last_flush = now;
+	}
+}
+
+void LoggerTextWriter::finish()
+{
+	closeOutFiles();
+}
+
+void LoggerTextWriter::sync()
+{
+	vector<AsyncOutputFile*> files;
+	for (auto& out : out_files) {
+		files.push_back(out.second.get());
+	}
+	AsyncOutputFile::sync(files);
 }
 
 
@@ -655,7 +708,7 @@ void LoggerTextWriter::writeCSV() {
 			multimap<FocusRangeAxis,int> restrictions = plain_restrictions;
 			restrictions.insert(make_pair(FocusRangeAxis::CELL, cell) );
 			FocusRange cell_range(granularity, restrictions, logger.getDomainOnly());
-			auto out = getOutFile( *(cell_range.begin()) );
+			auto& out = getOutFile( *(cell_range.begin()) );
 			try {
 				for (const SymbolFocus& focus : cell_range) {
 					if (condition.isDefined() && condition.granularity() > Granularity::Cell) {
@@ -663,35 +716,35 @@ void LoggerTextWriter::writeCSV() {
 					}
 					// write point of data row
 					for (uint i=0; i<output_symbols.size(); i++ ) {
-						if (i!=0) *out << separator();
-						*out << output_symbols[i]->get( focus );
+						if (i!=0) out << separator();
+						out << output_symbols[i]->get( focus );
 					}
-					*out << "\n";
+					out << "\n";
 				}
 			}
 			catch (const string& e) {
-				*out << "\n";
+				out << "\n";
 				continue;
 			}
 		}
 		
 	}
 	else {
-		auto out = getOutFile( *(range.begin()) );
+		auto& out = getOutFile( *(range.begin()) );
 		for (const SymbolFocus& focus : range) {
 			try {
 				if (condition.isDefined() && !condition(focus)) continue;
 				// write point of data row header
 				for (uint i=0; i<output_symbols.size(); i++ ) {
-					if (i!=0) *out << separator();
-					*out << output_symbols[i]->get( focus );
+					if (i!=0) out << separator();
+					out << output_symbols[i]->get( focus );
 				}
 			}
 			catch (const string& e) {
-				*out << "\n";
+				out << "\n";
 				continue;
 			}
-			*out << "\n";
+			out << "\n";
 		}
 		// treat single cell as 0-dimensional data
 		int dim = range.dimensions();
@@ -699,7 +752,7 @@ void LoggerTextWriter::writeCSV() {
 			dim = 0;
 		// only separate multi-dimensional data
 		if( dim > 0 )
-			*out << "\n";
+			out << "\n";
 
 	}
 }
@@ -739,7 +792,7 @@ void LoggerTextWriter::writeMatrix() {
 					restrictions.insert( make_pair(FocusRangeAxis::CELL,cells[c]) );
 					FocusRange range(granularity,restrictions);
 // 					ofstream out(getOutFile( *(range.begin()), symbol->name()), ofstream::out | ofstream::app);
-					auto out = getOutFile( *(range.begin()), symbol->name());
+					auto& out = getOutFile( *(range.begin()), symbol->name());
 					
 					if( header() ){
 						// not implemented yet
@@ -748,22 +801,22 @@ void LoggerTextWriter::writeMatrix() {
 					uint col=0;
 					uint row=0;
 					for (auto f : range) {
-						*out << symbol->get(f);
+						out << symbol->get(f);
 						col++;
 						if (col==row_length) {
-							*out << "\n";
+							out << "\n";
 							col=0; row++;
 							if (row == row_count) {
-								*out << "\n";
+								out << "\n";
 								row=0;
 							}
 						}
 						else 
-							*out << sep;
+							out << sep;
 					}
 					// if 2D surface (e.g. membraneprop), separate the data sets by double blank line (to use gnuplot's index keyword)
 					if( range.dimensions() > 1 )
-						*out << "\n\n";
+						out << "\n\n";
 				}
 			}
 			else {
@@ -775,7 +828,7 @@ void LoggerTextWriter::writeMatrix() {
 		}
 		else {
 			if (range.size() == 0) return;
-			auto out = getOutFile( *(range.begin()), symbol->name());
+			auto& out = getOutFile( *(range.begin()), symbol->name());
 // 			FocusRange range(granularity,logger.getRestrictions());
 			bool write_header_block=header();
 			uint col=0;
@@ -785,41 +838,41 @@ void LoggerTextWriter::writeMatrix() {
 					// write header above columns
 					// for multiD, write header at the start of each data block
 					if ( range.dimensions() > 1 ){
-						writeMatrixColHeader(range, *out);
+						writeMatrixColHeader(range, out);
 // 						cout << "writeMatrixColHeader" << endl;
 					}
 					// for a 1D range, only write header at start (single data block)
 					else if ( range.dimensions() == 1 && SIM::getTime() == SIM::getStartTime()){
-						writeMatrixColHeader(range, *out);
+						writeMatrixColHeader(range, out);
 					}
 					write_header_block=false;
 				}
 				if (col==0 && header() )
 					// write header for row
-					writeMatrixRowHeader(f, range, *out);
+					writeMatrixRowHeader(f, range, out);
 				
-				*out << symbol->get(f);
+				out << symbol->get(f);
 				col++;
 				if (col==row_length) {
-					*out << "\n";
+					out << "\n";
 					col=0; row++;
 					if (row == row_count && row_count > 1) {
-						*out << "\n";
+						out << "\n";
 						row=0;
 						write_header_block=header();
 					}
 				}
 				else 
-					*out << sep;
+					out << sep;
 			}
 			// if 2D surface, separate the data sets by double blank line (to use gnuplot's index keyword)
 			if( range.dimensions() > 1 )
-				*out << "\n\n";
+				out << "\n\n";
 		}
 	}
 }
 
-void LoggerTextWriter::writeMatrixColHeader(FocusRange range, ofstream& fs)
+void LoggerTextWriter::writeMatrixColHeader(FocusRange range, ostream& fs)
 {
 	// write a header line containing
 	// - first: number of columns
@@ -912,7 +965,7 @@ void LoggerTextWriter::writeMatrixColHeader(FocusRange range, ofstream& fs)
 	fs.flush();	
 }
 
-void LoggerTextWriter::writeMatrixRowHeader(SymbolFocus focus, FocusRange range, ofstream& fs){
+void LoggerTextWriter::writeMatrixRowHeader(SymbolFocus focus, FocusRange range, ostream& fs){
 	Granularity granularity = logger.getGranularity();
 	double y_value = 0.0;
 	double x_min = numeric_limits<double>::max();
@@ -989,10 +1042,342 @@ void LoggerTextWriter::writeMatrixRowHeader(SymbolFocus focus, FocusRange range,
 	fs << y_value << separator();
 }
 
+#ifdef HAVE_HDF5
+
+namespace {
+	/// The hdf5 library is not thread safe, Loggers may run concurrently though (see TimeScheduler)
+	std::mutex hdf5_mutex;
+	/// Maximum rows per chunk of the table datasets, also the number of rows buffered before writing
+	const hsize_t table_chunk_rows = 1<<16;
+	/// Upper bound for the chunk size of frame datasets
+	const hsize_t max_chunk_bytes = 1<<22;
+	/// Block of a FocusRange gathered by a single thread
+	const size_t gather_block_size = 1024;
+	
+	void writeStringAttribute(hid_t object, const string& name, const string& value) {
+		hid_t type = H5Tcopy(H5T_C_S1);
+		H5Tset_size(type, max(value.size(), size_t(1)));
+		hid_t space = H5Screate(H5S_SCALAR);
+		hid_t attribute = H5Acreate2(object, name.c_str(), type, space, H5P_DEFAULT, H5P_DEFAULT);
+		H5Awrite(attribute, type, value.c_str());
+		H5Aclose(attribute);
+		H5Sclose(space);
+		H5Tclose(type);
+	}
+	
+	/// Apply @p f to all elements of @p range in parallel, each thread advancing its own iterator through a block of the range
+	template <class F>
+	void parallelForRange(const FocusRange& range, F f) {
+		size_t n = range.end() - range.begin();
+		int blocks = (n + gather_block_size - 1) / gather_block_size;
+#pragma omp parallel for schedule(dynamic)
+		for (int b=0; b<blocks; b++) {
+			size_t begin = b * gather_block_size;
+			size_t end = min(n, begin + gather_block_size);
+			auto focus = range.begin() + begin;
+			for (size_t i=begin; i<end; i++, ++focus) {
+				f(i, *focus);
+			}
+		}
+	}
+	
+	string axisName(FocusRangeAxis axis) {
+		switch (axis) {
+			case FocusRangeAxis::X : return "x";
+			case FocusRangeAxis::Y : return "y";
+			case FocusRangeAxis::Z : return "z";
+			case FocusRangeAxis::MEM_X : return "phi";
+			case FocusRangeAxis::MEM_Y : return "theta";
+			default: return "";
+		}
+	}
+}
+
+LoggerHDF5Writer::LoggerHDF5Writer(Logger& logger, string xml_base_path) : LoggerWriterBase(logger)
+{
+	filename.setXMLPath(xml_base_path + "/file-name");
+	filename.setDefault("automatic");
+	logger.registerPluginParameter(filename);
+	
+	compression.setXMLPath(xml_base_path + "/compression");
+	compression.setDefault("0");
+	logger.registerPluginParameter(compression);
+	
+	map<string, Precision> precision_map;
+	precision_map["float"] = Precision::FLOAT;
+	precision_map["double"] = Precision::DOUBLE;
+	precision.setConversionMap(precision_map);
+	precision.setXMLPath(xml_base_path + "/precision");
+	precision.setDefault("double");
+	logger.registerPluginParameter(precision);
+}
+
+LoggerHDF5Writer::~LoggerHDF5Writer()
+{
+	std::lock_guard<std::mutex> lock(hdf5_mutex);
+	try {
+		flushRows();
+	}
+	catch (const string& e) {
+		cerr << e << endl;
+	}
+	closeFile();
+}
+
+void LoggerHDF5Writer::init()
+{
+	std::lock_guard<std::mutex> lock(hdf5_mutex);
+	if (filename() == "automatic") {
+		file_name = "logger";
+		if (logger.getInstanceNum()>1) {
+			file_name += "_" + to_str(logger.getInstanceID());
+		}
+		file_name += ".h5";
+	}
+	else 
+		file_name = filename();
+	
+	if (compression() < 0 || compression() > 9)
+		throw string("Logger HDF5Output: Compression level must be in the range 0 - 9.");
+	if (compression() > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0)
+		throw string("Logger HDF5Output: Compression is not supported by the hdf5 library.");
+	
+	Granularity granularity = logger.getGranularity();
+	
+	// Pick the right scope from logger restrictions definition
+	const Scope* output_scope = SIM::getGlobalScope();
+	if (logger.getRestrictions().count(FocusRangeAxis::CellType)==1 )
+		output_scope = CPM::getCellTypes()[logger.getRestrictions().find(FocusRangeAxis::CellType)->second].lock()->getScope();
+	
+	// Regular data of constant size is stored in frames, like the matrix format of the TextWriter
+	FocusRange frame_range(granularity, logger.getRestrictions(), false);
+	const auto& axes = frame_range.dataAxis();
+	if ( frame_range.isRegular() && ! axes.empty() && find(axes.begin(), axes.end(), FocusRangeAxis::CELL) == axes.end() && ! logger.getRestrictionCondition().isDefined() )
+		layout = Layout::FRAMES;
+	else
+		layout = Layout::TABLE;
+	
+	hid_t data_type = precision() == Precision::FLOAT ? H5T_IEEE_F32LE : H5T_IEEE_F64LE;
+	columns.clear();
+	if (layout == Layout::TABLE) {
+		FocusRange range(granularity, logger.getRestrictions(), logger.getDomainOnly());
+		columns.emplace_back(SymbolBase::Time_symbol, output_scope->findSymbol<double>(SymbolBase::Time_symbol), H5T_IEEE_F64LE);
+		for (const auto& axis_symbol : axisSymbolNames(range.dataAxis())) {
+			hid_t type = axis_symbol == SymbolBase::CellID_symbol ? H5T_STD_U32LE : data_type;
+			columns.emplace_back(axis_symbol, output_scope->findSymbol<double>(axis_symbol), type);
+		}
+	}
+	else {
+		frame_dims.clear();
+		for (auto size : frame_range.dataSizes())
+			frame_dims.push_back(size);
+	}
+	for (auto& s : logger.getInputs()) {
+		columns.emplace_back(s->name(), s->accessor(), data_type);
+	}
+	
+	file = H5Fcreate(file_name.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+	if (file < 0)
+		throw string("Logger HDF5Output: Unable to create file ") + file_name;
+	writeStringAttribute(file, "layout", layout == Layout::TABLE ? "table" : "frames");
+	
+	if (layout == Layout::TABLE) {
+		// Chunks hold the rows of a few writes, such that small tables do not allocate large chunks
+		FocusRange range(granularity, logger.getRestrictions(), logger.getDomainOnly());
+		hsize_t chunk_rows = 1024;
+		while (chunk_rows < table_chunk_rows && chunk_rows < 16 * range.size())
+			chunk_rows *= 2;
+		for (auto& col : columns) {
+			col.dataset = createDataset(col.name, col.file_type, {}, chunk_rows);
+		}
+	}
+	else {
+		time_dataset = createDataset(SymbolBase::Time_symbol, H5T_IEEE_F64LE, {}, 1024);
+		string axes_description = SymbolBase::Time_symbol;
+		for (auto axis : axes)
+			axes_description += "," + axisName(axis);
+		for (auto& col : columns) {
+			col.dataset = createDataset(col.name, col.file_type, frame_dims, 1);
+			writeStringAttribute(col.dataset, "axes", axes_description);
+		}
+	}
+	frame_count = 0;
+	buffered_rows = 0;
+}
+
+hid_t LoggerHDF5Writer::createDataset(const string& name, hid_t type, const vector<hsize_t>& frame_dims, hsize_t chunk_frames)
+{
+	int rank = frame_dims.size() + 1;
+	vector<hsize_t> dims(rank, 0), max_dims(rank, H5S_UNLIMITED), chunk(rank, chunk_frames);
+	for (int d=1; d<rank; d++) {
+		dims[d] = max_dims[d] = chunk[d] = frame_dims[d-1];
+	}
+	// Split large frames into several chunks along the outer axes, hdf5 limits chunks to 4GB
+	auto chunk_bytes = [&] () { hsize_t bytes = H5Tget_size(type); for (auto c : chunk) bytes *= c; return bytes; };
+	for (int d=1; d<rank && chunk_bytes() > max_chunk_bytes; d++) {
+		while (chunk[d] > 1 && chunk_bytes() > max_chunk_bytes)
+			chunk[d] = (chunk[d] + 1) / 2;
+	}
+	
+	hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+	H5Pset_chunk(properties, rank, chunk.data());
+	if (compression() > 0) {
+		H5Pset_shuffle(properties);
+		H5Pset_deflate(properties, compression());
+	}
+	hid_t space = H5Screate_simple(rank, dims.data(), max_dims.data());
+	hid_t dataset = H5Dcreate2(file, name.c_str(), type, space, H5P_DEFAULT, properties, H5P_DEFAULT);
+	H5Sclose(space);
+	H5Pclose(properties);
+	if (dataset < 0)
+		throw string("Logger HDF5Output: Unable to create dataset ") + name + " in file " + file_name;
+	return dataset;
+}
+
+void LoggerHDF5Writer::appendData(hid_t dataset, const double* data, const vector<hsize_t>& frame_dims, hsize_t offset, hsize_t frames)
+{
+	if (frames == 0) return;
+	int rank = frame_dims.size() + 1;
+	vector<hsize_t> dims(rank), start(rank, 0), count(rank);
+	dims[0] = offset + frames; start[0] = offset; count[0] = frames;
+	for (int d=1; d<rank; d++) {
+		dims[d] = count[d] = frame_dims[d-1];
+	}
+	
+	herr_t status = H5Dset_extent(dataset, dims.data());
+	hid_t file_space = H5Dget_space(dataset);
+	H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr);
+	hid_t mem_space = H5Screate_simple(rank, count.data(), nullptr);
+	if (status >= 0)
+		status = H5Dwrite(dataset, H5T_NATIVE_DOUBLE, mem_space, file_space, H5P_DEFAULT, data);
+	H5Sclose(mem_space);
+	H5Sclose(file_space);
+	if (status < 0)
+		throw string("Logger HDF5Output: Unable to write to file ") + file_name;
+}
+
+void LoggerHDF5Writer::gather(const FocusRange& range, Column& column, vector<char>& valid)
+{
+	size_t offset = column.buffer.size();
+	column.buffer.resize(offset + (range.end() - range.begin()));
+	double* data = column.buffer.data() + offset;
+	parallelForRange(range, [&] (size_t i, const SymbolFocus& focus) {
+		if (!valid[i]) return;
+		try {
+			data[i] = column.symbol->get(focus);
+		}
+		catch (const string& e) {
+			valid[i] = false;
+			data[i] = std::numeric_limits<double>::quiet_NaN();
+		}
+	});
+}
+
+void LoggerHDF5Writer::write()
+{
+	std::lock_guard<std::mutex> lock(hdf5_mutex);
+	if (file < 0) return;
+	if (layout == Layout::TABLE)
+		writeTable();
+	else
+		writeFrames();
+}
+
+void LoggerHDF5Writer::writeTable()
+{
+	FocusRange range(logger.getGranularity(), logger.getRestrictions(), logger.getDomainOnly());
+	size_t n = range.size();
+	vector<char> valid(n, true);
+	const auto& condition = logger.getRestrictionCondition();
+	if (condition.isDefined()) {
+		parallelForRange(range, [&] (size_t i, const SymbolFocus& focus) {
+			try {
+				valid[i] = condition(focus) != 0;
+			}
+			catch (const string& e) {
+				valid[i] = false;
+			}
+		});
+	}
+	for (auto& col : columns) {
+		gather(range, col, valid);
+	}
+	// Drop the rows excluded by the condition or with undefined symbols
+	if (find(valid.begin(), valid.end(), false) != valid.end()) {
+		for (auto& col : columns) {
+			size_t offset = buffered_rows, kept = buffered_rows;
+			for (size_t i=0; i<n; i++) {
+				if (valid[i]) col.buffer[kept++] = col.buffer[offset + i];
+			}
+			col.buffer.resize(kept);
+		}
+	}
+	buffered_rows = columns.front().buffer.size();
+	if (buffered_rows >= table_chunk_rows)
+		flushRows();
+}
+
+void LoggerHDF5Writer::flushRows()
+{
+	if (file < 0 || buffered_rows == 0) return;
+	for (auto& col : columns) {
+		appendData(col.dataset, col.buffer.data(), {}, col.length, buffered_rows);
+		col.length += buffered_rows;
+		col.buffer.clear();
+	}
+	buffered_rows = 0;
+	H5Fflush(file, H5F_SCOPE_LOCAL);
+}
+
+void LoggerHDF5Writer::writeFrames()
+{
+	FocusRange range(logger.getGranularity(), logger.getRestrictions(), false);
+	hsize_t frame_size = 1;
+	for (auto size : frame_dims) frame_size *= size;
+	if (range.size() != frame_size)
+		throw string("Logger HDF5Output: Size of the logged range changed.");
+	
+	// Undefined values are stored as NaN
+	vector<char> valid(frame_size, true);
+	for (auto& col : columns) {
+		col.buffer.clear();
+		valid.assign(frame_size, true);
+		gather(range, col, valid);
+		appendData(col.dataset, col.buffer.data(), frame_dims, col.length, 1);
+		col.length++;
+	}
+	double time = SIM::getTime();
+	appendData(time_dataset, &time, {}, frame_count, 1);
+	frame_count++;
+	H5Fflush(file, H5F_SCOPE_LOCAL);
+}
+
+void LoggerHDF5Writer::finish()
+{
+	std::lock_guard<std::mutex> lock(hdf5_mutex);
+	flushRows();
+	closeFile();
+}
+
+void LoggerHDF5Writer::closeFile()
+{
+	if (file < 0) return;
+	for (auto& col : columns) {
+		if (col.dataset >= 0) H5Dclose(col.dataset);
+		col.dataset = -1;
+	}
+	if (time_dataset >= 0) H5Dclose(time_dataset);
+	time_dataset = -1;
+	H5Fclose(file);
+	file = -1;
+}
+
+#endif
+
 //// -------------------------------------------------------------------------------------------
 
 
-LoggerPlotBase::LoggerPlotBase(Logger& logger, string xml_base_path)
+LoggerPlotBase::LoggerPlotBase(Logger& logger, string xml_base_path) : owner(logger)
 {
 	map<string, Terminal> terminalmap;
 	terminalmap["png"] = Terminal::PNG;
@@ -1069,21 +1454,24 @@ void LoggerPlotBase::init() {
 void LoggerPlotBase::checkedPlot()
 {
 // 	cout << SIM::getTime() << "\t" << (last_plot_time + time_step()) << endl;
+	bool do_plot = false;
 	if( !time_step.isDefined() ) { // not defined, always plot if Logger is executed (as joern suggested)
-		this->plot(); last_plot_time = SIM::getTime();
+		do_plot = true;
 	}
 	else if (time_step() <= 0.0) { // if time=step=0.0 or -1, only plot at the end of simulation
-		if( SIM::getStopTime() - SIM::getTime() <  10e-6){
-			this->plot(); last_plot_time = SIM::getTime();
-		}
+		do_plot = SIM::getStopTime() - SIM::getTime() <  10e-6;
 	}
 	else if( (last_plot_time + time_step()) - SIM::getTime() < 10e-6   // t > t_-1 + dt 
 		|| SIM::getTime() < 10e-6 ) { // if t=0.0
-		this->plot(); last_plot_time = SIM::getTime();
+		do_plot = true;
 	}
-	else{
-		//cout << "NO PLOT" << endl;
-		// do not plot
+	
+	if (do_plot) {
+		// gnuplot reads the data files, which are written asynchronously.
+		// Only wait for the own files, other Loggers may write concurrently.
+		owner.syncOutput();
+		this->plot();
+		last_plot_time = SIM::getTime();
 	}
 }
 
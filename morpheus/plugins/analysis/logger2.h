@@ -17,9 +17,15 @@
 #include "core/celltype.h"
 #include "core/data_mapper.h"
 #include "core/plugin_parameter.h"
+#include "core/async_output.h"
 #include "gnuplot_i/gnuplot_i.h"
 #include <fstream>
 #include <sstream>
+#include <mutex>
+#include <chrono>
+#ifdef HAVE_HDF5
+#include <hdf5.h>
+#endif
 
 /*
 New features (compared to Logger of Morpheus 1.2)
@@ -53,7 +59,7 @@ Questions:
 Future features:
 - add a range of predefined color palettes to override the default gnuplot colorscale: https://github.com/Gnuplotting/gnuplot-palettes
 - enable plotting of matrix formatted files
-- write matrices to HDF5 files
+DONE - write data to HDF5 files
 
 */
 
@@ -93,6 +99,12 @@ Specifies the details of the output file
 - \b file-numbering (optional, default=time): filenames are named according to simulation time or incremental numbering
 - \b file-separation (optional, default=none): writes separate files for time, cells or both (cell+time)
 
+Alternatively, \b HDF5Output writes a binary hdf5 file, if Morpheus was built with hdf5 support. Regular spatial data (fields, slices, membranes) is stored as one dataset per symbol with a frame per time point, all other data as a table with one column dataset per symbol including 'time' and 'cell.id'. The file can be read with e.g. h5py or pandas.
+
+- \b file-name (optional, default=automatic): filename is created automatically by default
+- \b compression (optional, default=0): deflate compression level 0-9, 0 disables compression
+- \b precision (optional, default=double): store the data in single (float) or double precision
+
 \subsection Restriction Restriction (optional)
 
 Restrict the data query to a certain slice, a cell type or certain cell IDs.
@@ -407,6 +419,8 @@ public:
 	const SymbolAccessor<double> getInput(const string& symbol) const;
 	string getInputsDescription(const string& s) const;
 	int addWriter(shared_ptr<LoggerWriterBase> writer);
+	/// Make the data written so far available to external readers, e.g. gnuplot
+	void syncOutput();
 	const vector<shared_ptr<LoggerWriterBase> >& getWriters() const { return writers; };
 	int getInstanceID() const { return instance_id; };
 	int getInstanceNum() const { return instances; };
@@ -426,6 +440,8 @@ public:
 	virtual void init() =0;
 	virtual void write() =0;
 	virtual void finish() {};
+	/// Wait until the written data is on disk
+	virtual void sync() {};
 
 protected:
 	Logger& logger;
@@ -441,6 +457,8 @@ public:
 	LoggerTextWriter(Logger& logger, string xml_base_path = "");
 	void init() override;
 	void write() override;
+	void finish() override;
+	void sync() override;
 	
 	OutputFormat getOutputFormat() const { return file_format; };
 	FileSeparation getFileSeparation() const { return file_separation; } ;
@@ -463,6 +481,10 @@ private:
 	string file_basename;
 	string file_extension;
 	set<string> files_opened;
+	/// Files kept open for subsequent writes, data is written by the background I/O thread
+	map<string, unique_ptr<AsyncOutputFile> > out_files;
+	std::mutex out_files_mutex;
+	std::chrono::steady_clock::time_point last_flush;
 	
 	PluginParameter2<bool, XMLValueReader, DefaultValPolicy> header;
 	PluginParameter2<bool, XMLValueReader, DefaultValPolicy> header_guarding;
@@ -474,11 +496,12 @@ private:
 	PluginParameter2<FileSeparation, XMLNamedValueReader, DefaultValPolicy> xml_file_separation;
 	PluginParameter2<OutputFormat, XMLNamedValueReader, OptionalPolicy> xml_file_format;
 		
-	unique_ptr<ofstream> getOutFile(const SymbolFocus& f, string symbol = "");
+	AsyncOutputFile& getOutFile(const SymbolFocus& f, string symbol = "");
+	void closeOutFiles();
 	void writeCSV();
 	void writeMatrix();
-	void writeMatrixColHeader(FocusRange range, ofstream& fs);
-	void writeMatrixRowHeader(SymbolFocus focus, FocusRange range, ofstream& fs);	
+	void writeMatrixColHeader(FocusRange range, ostream& fs);
+	void writeMatrixRowHeader(SymbolFocus focus, FocusRange range, ostream& fs);	
 	vector <SymbolAccessor<double> > output_symbols;
 	vector <string> csv_header;
 	
@@ -495,9 +518,58 @@ class LoggerGnuplotWriter : public LoggerWriterBase {
 
 #ifdef HAVE_HDF5
 
-/** This Writer shall write data in hdf5 format, for easy input into python via pandas  .. **/
+/** This Writer writes data in binary hdf5 format, for easy input into python via h5py / pandas.
+ *
+ *  Regular spatial data (fields, field slices and membranes) is stored as one dataset per symbol,
+ *  that is extended by a frame at every write, alongside a 'time' dataset.
+ *  All other data is stored column-wise as a table of equally sized 1D datasets, 'time', the axis columns (e.g. 'cell.id') and one per symbol.
+ *  Rows are buffered and appended in chunks, that are optionally compressed.
+ **/
 class LoggerHDF5Writer : public LoggerWriterBase {
+public:
+	LoggerHDF5Writer(Logger& logger, string xml_base_path);
+	~LoggerHDF5Writer();
+	void init() override;
+	void write() override;
+	void finish() override;
+	
+	string getDataFile() const { return file_name; }
+
+private:
+	enum class Layout { TABLE, FRAMES };
+	enum class Precision { FLOAT, DOUBLE };
+	struct Column {
+		Column(string name, SymbolAccessor<double> symbol, hid_t file_type) : name(name), symbol(symbol), file_type(file_type) {};
+		string name;
+		SymbolAccessor<double> symbol;
+		/// Type stored in the file, data is converted from double by the hdf5 library
+		hid_t file_type;
+		hid_t dataset = -1;
+		/// Frame or row data not yet written
+		vector<double> buffer;
+		hsize_t length = 0;
+	};
+	
+	Layout layout;
+	string file_name;
+	hid_t file = -1;
+	hid_t time_dataset = -1;
+	hsize_t frame_count = 0;
+	vector<hsize_t> frame_dims;
+	vector<Column> columns;
+	hsize_t buffered_rows = 0;
+	
+	PluginParameter2<string, XMLValueReader, DefaultValPolicy> filename;
+	PluginParameter2<int, XMLValueReader, DefaultValPolicy> compression;
+	PluginParameter2<Precision, XMLNamedValueReader, DefaultValPolicy> precision;
 	
+	hid_t createDataset(const string& name, hid_t type, const vector<hsize_t>& frame_dims, hsize_t chunk_frames);
+	void appendData(hid_t dataset, const double* data, const vector<hsize_t>& frame_dims, hsize_t offset, hsize_t frames);
+	void gather(const FocusRange& range, Column& column, vector<char>& valid);
+	void writeTable();
+	void writeFrames();
+	void flushRows();
+	void closeFile();
 };
 
 #endif
@@ -512,6 +584,8 @@ public:
 protected:
 	virtual void plot() =0;
 	
+	/// Logger providing the plotted data
+	Logger& owner;
 	enum class Terminal{ PNG, PDF, JPG, GIF, SVG, EPS, SCREEN };
 	map<Terminal, string> terminal_file_extension;
 	map<Terminal, string> terminal_name;
@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+#include "model_test.h"
+#include "core/simulation.h"
+#include "core/time_scheduler.h"
+#include "core/string_functions.h"
+
+#ifdef HAVE_HDF5
+#include <hdf5.h>
+#include <fstream>
+
+namespace {
+
+struct CSVTable {
+	vector<string> header;
+	vector< vector<double> > columns;
+	size_t rows() const { return columns.empty() ? 0 : columns[0].size(); }
+	const vector<double>& column(const string& name) const {
+		auto it = find(header.begin(), header.end(), name);
+		if (it == header.end()) throw string("Column ") + name + " not found";
+		return columns[it - header.begin()];
+	}
+};
+
+/// Read a tab separated file with a guarded header line
+CSVTable readCSV(const string& file_name) {
+	CSVTable table;
+	ifstream in(file_name);
+	string line;
+	if (!getline(in, line)) throw string("Unable to read ") + file_name;
+	for (auto& name : tokenize(line, "\t")) {
+		name.erase(remove(name.begin(), name.end(), '"'), name.end());
+		table.header.push_back(name);
+	}
+	table.columns.resize(table.header.size());
+	while (getline(in, line)) {
+		if (line.empty()) continue;
+		auto values = tokenize(line, "\t");
+		if (values.size() != table.header.size()) throw string("Incomplete row in ") + file_name;
+		for (uint i=0; i<values.size(); i++)
+			table.columns[i].push_back(stod(values[i]));
+	}
+	return table;
+}
+
+vector<double> readDataset(hid_t file, const string& name, vector<hsize_t>& dims) {
+	hid_t dataset = H5Dopen2(file, name.c_str(), H5P_DEFAULT);
+	if (dataset < 0) throw string("Dataset ") + name + " not found";
+	hid_t space = H5Dget_space(dataset);
+	dims.resize(H5Sget_simple_extent_ndims(space));
+	H5Sget_simple_extent_dims(space, dims.data(), nullptr);
+	vector<double> data(H5Sget_simple_extent_npoints(space));
+	H5Dread(dataset, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data());
+	H5Sclose(space);
+	H5Dclose(dataset);
+	return data;
+}
+
+string readStringAttribute(hid_t object, const string& name) {
+	hid_t attribute = H5Aopen(object, name.c_str(), H5P_DEFAULT);
+	if (attribute < 0) throw string("Attribute ") + name + " not found";
+	hid_t type = H5Aget_type(attribute);
+	string value(H5Tget_size(type), '\0');
+	H5Aread(attribute, type, &value[0]);
+	H5Tclose(type);
+	H5Aclose(attribute);
+	return value;
+}
+
+void expectSameValues(const vector<double>& h5, const vector<double>& csv, const string& name) {
+	ASSERT_EQ(h5.size(), csv.size()) << name;
+	for (uint i=0; i<h5.size(); i++) {
+		// The text output keeps 10 significant digits
+		EXPECT_NEAR(h5[i], csv[i], 1e-9 * max(1.0, fabs(csv[i]))) << name << " row " << i;
+	}
+}
+
+/// Compare a table layout hdf5 file to the @p csv_file of the same logger configuration, and return the csv data
+CSVTable expectTableMatchesCSV(const string& name, const string& csv_file) {
+	auto csv = readCSV(csv_file);
+	hid_t file = H5Fopen((name + ".h5").c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+	EXPECT_GE(file, 0) << name;
+	if (file < 0) return csv;
+	EXPECT_EQ(readStringAttribute(file, "layout"), "table") << name;
+	EXPECT_GT(csv.rows(), 0) << name;
+	for (uint c=0; c<csv.header.size(); c++) {
+		vector<hsize_t> dims;
+		auto data = readDataset(file, csv.header[c], dims);
+		EXPECT_EQ(dims.size(), 1) << csv.header[c];
+		expectSameValues(data, csv.columns[c], name + ":" + csv.header[c]);
+	}
+	H5Fclose(file);
+	return csv;
+}
+
+/// Run the logger model, which is imported only here to get a single injected ressource
+void runModel() {
+	auto file = ImportFile("logger_hdf5.xml");
+	TestModel m(file.getDataAsString());
+	m.run();
+	TimeScheduler::finish();
+}
+
+}
+
+TEST (LoggerHDF5, TableLayout) {
+	runModel();
+	
+	try {
+		auto cells = expectTableMatchesCSV("cells", "cells.csv");
+		auto cells_condition = expectTableMatchesCSV("cells_condition", "cells_condition.csv");
+		// Only cells with odd ids pass the condition
+		EXPECT_LT(cells_condition.rows(), cells.rows());
+		for (auto id : cells_condition.column(SymbolBase::CellID_symbol))
+			EXPECT_EQ(int(id) % 2, 1);
+		
+		// A field with a condition is stored as a table
+		auto field_condition = expectTableMatchesCSV("field_condition", "field_condition.csv");
+		EXPECT_LT(field_condition.rows(), 5 * 12 * 8);
+		for (auto u : field_condition.column("u"))
+			EXPECT_GT(u, 50);
+	}
+	catch (const string& e) {
+		FAIL() << e;
+	}
+}
+
+TEST (LoggerHDF5, FramesLayout) {
+	runModel();
+	
+	try {
+		auto csv = readCSV("field.csv");
+		hid_t h5 = H5Fopen("field.h5", H5F_ACC_RDONLY, H5P_DEFAULT);
+		ASSERT_GE(h5, 0);
+		EXPECT_EQ(readStringAttribute(h5, "layout"), "frames");
+		
+		vector<hsize_t> time_dims, dims;
+		auto time = readDataset(h5, SymbolBase::Time_symbol, time_dims);
+		auto u = readDataset(h5, "u", dims);
+		hid_t dataset = H5Dopen2(h5, "u", H5P_DEFAULT);
+		EXPECT_EQ(readStringAttribute(dataset, "axes").substr(0, SymbolBase::Time_symbol.size()), SymbolBase::Time_symbol);
+		H5Dclose(dataset);
+		H5Fclose(h5);
+		
+		// One frame of 12 x 8 nodes per time step, the rows of the csv file enumerate the frames
+		ASSERT_EQ(dims.size(), 3);
+		EXPECT_EQ(dims[0], time.size());
+		EXPECT_EQ(dims[1] * dims[2], 12 * 8);
+		size_t frame_size = dims[1] * dims[2];
+		ASSERT_EQ(csv.rows(), time.size() * frame_size);
+		vector<double> csv_frame_time;
+		for (size_t row=0; row<csv.rows(); row += frame_size)
+			csv_frame_time.push_back(csv.column(SymbolBase::Time_symbol)[row]);
+		expectSameValues(time, csv_frame_time, "field:time");
+		expectSameValues(u, csv.column("u"), "field:u");
+	}
+	catch (const string& e) {
+		FAIL() << e;
+	}
+}
+
+#endif
@@ -94,17 +94,22 @@ bool MechanicalLink::removeBond(const SymbolFocus& cell_a, const SymbolFocus& ce
 void MechanicalLink::executeTimeStep(){
 	// cell population of celltype 
 	vector<CPM::CELL_ID> cell_ids = celltype->getCellIDs();
-	// create and delete bonds to neighbors
+	bond_changes.resize(max(1, omp_get_max_threads()));
+	
+	// Decide on bond removal and creation in parallel, using the random engine of the thread.
+	// Each pair of cells is handled by the cell with the lower id only.
+#pragma omp parallel for schedule(static)
 	for ( uint i=0; i<cell_ids.size(); i++ ) {
-
+		auto& changes = bond_changes[omp_get_thread_index()];
 		SymbolFocus cellFocus(cell_ids[i]);
 		const auto& cell = cellFocus.cell();
 		const vector<CPM::CELL_ID>& cell_bonds = bonds->get(cellFocus);
+		// Bonds of this cell removed in this step may be linked again right away
+		auto first_removed = changes.removed.size();
 		// Remove Links from the bonds
-		for (auto it_bond = cell_bonds.begin(); it_bond < cell_bonds.end(); ) {
-			// assert single processing
-			SymbolFocus cellFocusN(*it_bond); it_bond++;
-			if (cellFocus.cellID() > *it_bond) continue;
+		for (auto bond : cell_bonds) {
+			if (cellFocus.cellID() > bond) continue;
+			SymbolFocus cellFocusN(bond);
 			
 			double center_equi_dist = sqrt(cell.getSize()/M_PI) + sqrt(cellFocusN.cell().getSize()/M_PI);
 			double center_dist = (cell.getCenter() - cellFocusN.cell().getCenter()).abs();
@@ -119,30 +124,44 @@ void MechanicalLink::executeTimeStep(){
 			
 			// probabilistic breakup
 			if (unlink_probability(cellFocus) >= getRandom01()) {
-				removeBond(cellFocus, cellFocusN);
+				changes.removed.push_back(make_pair(cellFocus.cellID(), cellFocusN.cellID()));
 			}
 		}
 		
 		// Create Links for unlinked direct neighbors
 		// iterate through list of neighbors with cell granularity
-		const map< CPM::CELL_ID, double >& interfaces =  cell.getInterfaceLengths();
-		for (pair< CPM::CELL_ID, double > it_neighbors: interfaces) {
+		const auto& interfaces =  cell.getInterfaceLengths();
+		for (const auto& it_neighbors: interfaces) {
 			SymbolFocus cellFocusN(it_neighbors.first);
 			// has interface, assert single processing and same celltype
 			if (it_neighbors.second > 0 && cellFocus.cellID() < cellFocusN.cellID() && cellFocusN.celltype() == celltype->getID()) {
-				if (!contains(cell_bonds, cellFocusN.cellID())) {
+				bool removed = any_of(changes.removed.begin() + first_removed, changes.removed.end(),
+					[&](const pair<CPM::CELL_ID, CPM::CELL_ID>& bond) { return bond.second == cellFocusN.cellID(); });
+				if (removed || !contains(cell_bonds, cellFocusN.cellID())) {
 					// bond does not exist
 					if (use_ns_link) {
-						unlink_probability.setNameSpaceFocus(ns1_id,cellFocus);
-						unlink_probability.setNameSpaceFocus(ns2_id,cellFocusN);
+						link_probability.setNameSpaceFocus(ns1_id,cellFocus);
+						link_probability.setNameSpaceFocus(ns2_id,cellFocusN);
 					}
 					if (link_probability(cellFocus) > getRandom01()) {
-						insertBond(cellFocus, cellFocusN);
+						changes.created.push_back(make_pair(cellFocus.cellID(), cellFocusN.cellID()));
 					}
 				}
 			}
 		}
 	}
+	
+	// Apply the bond changes in the order of the cell population
+	for (auto& changes : bond_changes) {
+		for (const auto& bond : changes.removed)
+			removeBond(SymbolFocus(bond.first), SymbolFocus(bond.second));
+		changes.removed.clear();
+	}
+	for (auto& changes : bond_changes) {
+		for (const auto& bond : changes.created)
+			insertBond(SymbolFocus(bond.first), SymbolFocus(bond.second));
+		changes.created.clear();
+	}
 }
 
 double MechanicalLink::delta ( const SymbolFocus& cell_focus, const CPM::Update& /*update*/) const
@@ -38,14 +38,17 @@ public:
 	typedef vector<CPM::CELL_ID> LinkType;
 private:
 	PluginParameter2<double, XMLEvaluator, RequiredPolicy> strength;
-	PluginParameter2<double, XMLEvaluator, RequiredPolicy> link_probability;
-	PluginParameter2<double, XMLEvaluator, RequiredPolicy> unlink_probability;
+	PluginParameter2<double, XMLThreadsaveEvaluator, RequiredPolicy> link_probability;
+	PluginParameter2<double, XMLThreadsaveEvaluator, RequiredPolicy> unlink_probability;
 	
 	int ns1_id, ns2_id;
 	bool use_ns_strength, use_ns_link, use_ns_unlink;
 
 	CellType* celltype;
 	CellType::PropertyAccessor<LinkType> bonds;
+	/// Bonds to be removed and created, collected per thread
+	struct BondChanges { vector< pair<CPM::CELL_ID, CPM::CELL_ID> > removed, created; };
+	vector<BondChanges> bond_changes;
 	
 	bool insertBond(const SymbolFocus& cell_a, const SymbolFocus& cell_b) const;
 	bool removeBond(const SymbolFocus& cell_a, const SymbolFocus& cell_b) const;
@@ -0,0 +1,39 @@
+#include "gtest/gtest.h"
+#include "model_test.h"
+#include "core/simulation.h"
+#include "core/time_scheduler.h"
+#include "core/celltype.h"
+
+TEST (MechanicalLink, LinkProbabilityOfBothCells) {
+	auto file = ImportFile("mechanical_link.xml");
+	TestModel m(file.getDataAsString());
+	m.run();
+	
+	auto ct = CPM::findCellType("ct").lock();
+	ASSERT_TRUE(ct);
+	auto scope = ct->getScope();
+	auto allow = scope->findSymbol<double>("allow");
+	auto bonds = scope->findSymbol< vector<CPM::CELL_ID> >("_mechanical_links");
+	
+	// Cells are frozen, thus all touching pairs that are allowed to link are linked at the end
+	uint n_expected = 0, n_bonds = 0, n_touching = 0;
+	for (auto id : ct->getCellIDs()) {
+		SymbolFocus cell(id);
+		auto cell_bonds = bonds->get(cell);
+		n_bonds += cell_bonds.size();
+		for (const auto& neighbor : cell.cell().getInterfaceLengths()) {
+			if (neighbor.second <= 0 || CPM::getCellIndex(neighbor.first).celltype != ct->getID())
+				continue;
+			n_touching++;
+			bool linked = find(cell_bonds.begin(), cell_bonds.end(), neighbor.first) != cell_bonds.end();
+			bool expected = allow->get(cell) && allow->get(SymbolFocus(neighbor.first));
+			EXPECT_EQ(linked, expected) << "Cells " << id << " and " << neighbor.first;
+			if (expected) n_expected++;
+		}
+	}
+	EXPECT_EQ(n_bonds, n_expected);
+	// Not all touching cells may link
+	EXPECT_GT(n_expected, 0);
+	EXPECT_LT(n_expected, n_touching);
+	TimeScheduler::finish();
+}
@@ -86,6 +86,7 @@ void Pseudopodia::init(const Scope *scope) {
 
     cpmLayer = CPM::getLayer();
     cellType = scope->getCellType();
+    secondOrderNeighbors = getLattice()->getNeighborhoodByOrder(2).neighbors();
 
     //TODO addProperty for the pseudopods instead of map?
 }
@@ -96,26 +97,63 @@ void Pseudopodia::executeTimeStep() {
 
     // This is only called the first time to allocate space for pseudopod storage
     call_once(initPseudopods, [&]() {
-        for (auto &cellId : cells) {
-            auto pseudopod = Pseudopod((unsigned int) maxGrowthTime(), cpmLayer.get(),
-                                       cellId, &movingDirection, &field, retractionMethod(), directionalStrengthInit(),
-                                       directionalStrengthCont(), touchBehavior(), timeBetweenExtensions());
-            pseudopods.insert(make_pair(cellId, vector<Pseudopod>((size_t) maxPseudopods(), pseudopod)));
+        cellIds = cells;
+        sort(cellIds.begin(), cellIds.end());
+        auto bundleCapacity = (size_t) maxGrowthTime() + 1;
+        pseudopods.reserve(cellIds.size() * maxPseudopods());
+        bundlePoints.resize(cellIds.size() * maxPseudopods() * bundleCapacity);
+        for (auto &cellId : cellIds) {
+            for (uint i = 0; i < maxPseudopods(); i++) {
+                auto bundleStorage = &bundlePoints[pseudopods.size() * bundleCapacity];
+                pseudopods.push_back(Pseudopod((unsigned int) maxGrowthTime(), cpmLayer.get(),
+                                               cellId, &movingDirection, bundleStorage, retractionMethod(), directionalStrengthInit(),
+                                               directionalStrengthCont(), touchBehavior(), timeBetweenExtensions()));
+            }
         }
+        actinChanges.resize(max(1, omp_get_max_threads()));
     });
-    assert(pseudopods.size() == cells.size()); // We don't handle cell death or proliferation
-    for (auto &it : pseudopods) {
-        assert(CPM::cellExists(it.first));
-        if (CPM::getCell(it.first).getNodes().empty())
+    assert(cellIds.size() == cells.size()); // We don't handle cell death or proliferation
+
+    // Cells are stepped in parallel using the random engine of the thread, the actin field is changed afterwards
+    uint nPseudopods = maxPseudopods();
+#pragma omp parallel for schedule(static)
+    for (uint i = 0; i < cellIds.size(); i++) {
+        assert(CPM::cellExists(cellIds[i]));
+        if (CPM::getCell(cellIds[i]).getNodes().empty())
             //FIXME HACK 0.0 is the default, we want to wait for a real moving direction
-            // || movingDirection(SymbolFocus(it.first)) == 0.0)
+            // || movingDirection(SymbolFocus(cellIds[i])) == 0.0)
             continue;
-        int test = 0;
 
-        for (auto &pseudopod : it.second) {
-            pseudopod.timeStep();
-            test++;
+        auto &changes = actinChanges[omp_get_thread_index()];
+        for (uint p = i * nPseudopods; p < (i + 1) * nPseudopods; p++) {
+            pseudopods[p].timeStep(changes);
+        }
+    }
+
+    for (auto &changes : actinChanges) {
+        for (const auto &change : changes) {
+            auto level = field.get(change.first) + change.second;
+            assert(level >= 0);
+            field.set(change.first, level);
+        }
+        changes.clear();
+    }
+    updateTipIndex();
+}
+
+void Pseudopodia::updateTipIndex() {
+    tips.clear();
+    tipRanges.assign(cellIds.empty() ? 0 : cellIds.back() + 1, make_pair(0u, 0u));
+    for (uint i = 0; i < cellIds.size(); i++) {
+        uint begin = tips.size();
+        for (uint p = i * maxPseudopods(); p < (i + 1) * maxPseudopods(); p++) {
+            const auto &pseudopod = pseudopods[p];
+            if (!pseudopod.hasBundleTip()) continue;
+            auto tip = pseudopod.getBundleTip();
+            bool pulling = pseudopod.state() == Pseudopod::State::RETRACTING || pseudopod.state() == Pseudopod::State::TOUCHING;
+            tips.push_back({VINT(tip), tip, pulling});
         }
+        tipRanges[cellIds[i]] = make_pair(begin, (uint) tips.size());
     }
 }
 
@@ -140,8 +178,7 @@ double Pseudopodia::calcNeighboringActinBonus(const CPM::Update &update) const {
     if(!update.opAdd()) return 0.0;
 
     auto pos = update.focus().pos();
-    auto neighbors = getLattice()->getNeighborhoodByOrder(2).neighbors();
-    for(auto const& neighbor : neighbors) {
+    for(auto const& neighbor : secondOrderNeighbors) {
         auto neighborPos = pos + neighbor;
         // if neighbor belongs to the same cell and has positive actin level -> give bonus
         if(cpmLayer->get(neighborPos).cell_id == update.source().cellID()
@@ -155,24 +192,14 @@ double Pseudopodia::calcNeighboringActinBonus(const CPM::Update &update) const {
 }
 
 double Pseudopodia::minDistanceToPseudopodTip(const VINT pos, const CPM::CELL_ID& cellId) const {
-    auto pseudopods = getPseudopodsForCell(cellId);
-    // Remove pseudopods that have no tips (yet)
-    pseudopods.erase(
-            std::remove_if(
-                    pseudopods.begin(),
-                    pseudopods.end(),
-                    [](const Pseudopod& pseudopod) { return !pseudopod.hasBundleTip(); }
-            ),
-            pseudopods.end()
-    );
-    if(pseudopods.empty()) return std::numeric_limits<double>::infinity();
-    std::vector<double> distancePosToTip;
-    std::transform(pseudopods.begin(), pseudopods.end(), std::back_inserter(distancePosToTip),
-                   [&](Pseudopod &pseudopod) -> double {
-        return dist(pos, VINT(pseudopod.getBundleTip()));
-    });
-    return *std::min_element(distancePosToTip.begin(), distancePosToTip.end());
-
+    // Only pseudopods with a tip are indexed
+    auto minDistance = std::numeric_limits<double>::infinity();
+    if (cellId >= tipRanges.size()) return minDistance;
+    const auto &range = tipRanges[cellId];
+    for (uint i = range.first; i < range.second; ++i) {
+        minDistance = min(minDistance, dist(pos, tips[i].node));
+    }
+    return minDistance;
 }
 
 double Pseudopodia::calcPseudopodTipBonus(const SymbolFocus &cell_focus, const CPM::Update &update) const {
@@ -186,13 +213,16 @@ double Pseudopodia::calcPseudopodTipBonus(const SymbolFocus &cell_focus, const C
     }
     auto isTouchingNeighbor = FALSE;
     // TODO find better way of getting nearby cells?
-    auto neighbors = getLattice()->getNeighborhoodByOrder(2).neighbors();
-    for(auto const& neighbor : neighbors) {
+    auto checkedCellId = cellID;
+    for(auto const& neighbor : secondOrderNeighbors) {
         auto neighborPos = pos + neighbor;
         auto neighborCellId = cpmLayer->get(neighborPos).cell_id;
         if(neighborCellId == cellID || neighborCellId == CPM::getEmptyState().cell_id) continue;
         // if neighbor belongs to a different cell and is close to a pseudopod tip -> give bonus
         isTouchingNeighbor = TRUE;
+        // the tips of a neighbor cell found at consecutive nodes are already known to be too far
+        if(neighborCellId == checkedCellId) continue;
+        checkedCellId = neighborCellId;
         if(minDistanceToPseudopodTip(pos, neighborCellId) <= pseudopodTipBonusMaxDistance()) {
             if(update.opAdd()) {
                 // Make more likely
@@ -242,34 +272,21 @@ bool Pseudopodia::update_check(CPM::CELL_ID cell_id, const CPM::Update &update)
     return true;
 }
 
-vector<Pseudopod> Pseudopodia::getPseudopodsForCell(const CPM::CELL_ID &cell_id) const {
-    auto it = pseudopods.find(cell_id);
-    return it != pseudopods.end() ? it->second : vector<Pseudopod>();
-}
-
 double Pseudopodia::calcPersistenceBonus(const SymbolFocus &cell_focus, const CPM::Update &update) const {
     auto cellID = cell_focus.cellID();
-    auto pseudopods = getPseudopodsForCell(cellID);
-    pseudopods.erase(
-            std::remove_if(
-                    pseudopods.begin(),
-                    pseudopods.end(),
-                    [](const Pseudopod& pseudopod) { return !pseudopod.hasBundleTip() |
-                    //(pseudopod.state() != Pseudopod::State::PULLING && pseudopod.state() != Pseudopod::State::TOUCHING);
-                        (pseudopod.state() != Pseudopod::State::RETRACTING && pseudopod.state() != Pseudopod::State::TOUCHING);
-                    }
-            ),
-            pseudopods.end()
-    );
-    if(pseudopods.empty()) return 0.0;
+    if (cellID >= tipRanges.size()) return 0.0;
+    const auto &range = tipRanges[cellID];
+    // Only tips of retracting or touching pseudopods pull the cell
+    if (std::none_of(tips.begin() + range.first, tips.begin() + range.second,
+                     [](const BundleTip &tip) { return tip.pulling; }))
+        return 0.0;
     const auto &cell = cell_focus.cell();
     auto cell_center = cell.getCenter();
-    auto force_vector = std::accumulate(pseudopods.begin(), pseudopods.end(), VDOUBLE(0.0,0.0,0.0),
-            [&](VDOUBLE acc, Pseudopod &pseudopod) -> VDOUBLE {
-        return acc + (pseudopod.getBundleTip() - cell_center);
-    });
+    auto force_vector = VDOUBLE(0.0,0.0,0.0);
+    for (uint i = range.first; i < range.second; ++i) {
+        if (tips[i].pulling) force_vector += tips[i].pos - cell_center;
+    }
     auto update_direction = cell.getUpdatedCenter() - cell.getCenter();
     auto cell_size = cell.nNodes();
     return -pullStrength() * dot(update_direction.norm(), force_vector) / cell_size;
 }
-
@@ -50,7 +50,24 @@ private:
     // auxiliary plugin-internal variables and functions can be declared here.
     shared_ptr<const CPM::LAYER> cpmLayer;
     CellType *cellType;
-    map<CPM::CELL_ID, vector<Pseudopod>> pseudopods;
+    // Pooled pseudopod store, the pseudopods of the cell cellIds[i] are pseudopods[i * maxPseudopods() ...]
+    // and each pseudopod keeps its bundle points in a fixed slot of bundlePoints
+    vector<CPM::CELL_ID> cellIds;
+    vector<Pseudopod> pseudopods;
+    vector<VDOUBLE> bundlePoints;
+    // Actin field changes of each thread
+    vector<Pseudopod::ActinChanges> actinChanges;
+    vector<VINT> secondOrderNeighbors;
+
+    // Bundle tips of the pseudopods, rebuilt after each time step since the tips only change there
+    struct BundleTip {
+        VINT node;
+        VDOUBLE pos;
+        bool pulling; // retracting or touching, contributes to the persistence bonus
+    };
+    vector<BundleTip> tips;
+    // Range of the tips of each cell in tips, indexed by cell id
+    vector<pair<uint, uint>> tipRanges;
 
 public:
     // constructor
@@ -75,7 +92,7 @@ private:
 
     double calcPseudopodTipBonus(const SymbolFocus &cell_focus, const CPM::Update &update) const;
 
-    vector<Pseudopod> getPseudopodsForCell(const CPM::CELL_ID &cell_id) const;
+    void updateTipIndex();
 
     double minDistanceToPseudopodTip(VINT pos, const CPM::CELL_ID &cellId) const;
 
@@ -37,13 +37,12 @@ static VDOUBLE RandomVonMisesPoint(VDOUBLE mu, double kappa) {
 
 Pseudopod::Pseudopod(unsigned int maxGrowthTime, const CPM::LAYER *cpm_layer, CPM::CELL_ID cellId,
           PluginParameter2<double, XMLReadableSymbol, RequiredPolicy> *movingDirection,
-          PluginParameter2<double, XMLReadWriteSymbol, RequiredPolicy> *field, RetractionMethod retractionMethod,
+          VDOUBLE *bundleStorage, RetractionMethod retractionMethod,
           double kappaInit, double kappaCont, TouchBehavior touchBehavior, unsigned int timeBetweenExtensions) :
         maxGrowthTime_(maxGrowthTime), _cpm_layer(cpm_layer), cellId(cellId),
-        movingDirection_(movingDirection), state_(State::INACTIVE), field_(field),
+        movingDirection_(movingDirection), state_(State::INACTIVE), bundle_(bundleStorage), bundleFirst_(0), bundleSize_(0),
         timeLeftForGrowth_(0), timeNoExtension_(0), paramRetractionMethod_(retractionMethod), currRetractionMethod_(retractionMethod), kappaInit_(kappaInit),
-        kappaCont_(kappaCont), touchBehavior_(touchBehavior), timeBetweenExtensions_(timeBetweenExtensions){
-    bundlePositions_.reserve(maxGrowthTime);
+        kappaCont_(kappaCont), touchBehavior_(touchBehavior), timeBetweenExtensions_(timeBetweenExtensions), actinChanges_(nullptr) {
 }
 
 Pseudopod::State Pseudopod::state() const {
@@ -69,8 +68,11 @@ void Pseudopod::startNewBundle() {
 }
 
 void Pseudopod::addPosToBundle(VDOUBLE const &pos) {
-    field_->set(VINT(pos), field_->get(VINT(pos)) + 1);
-    bundlePositions_.emplace_back(pos);
+    // Bundles only grow until they start retracting, thus a new bundle can start at the beginning of the slot
+    if (bundleSize_ == 0) bundleFirst_ = 0;
+    assert(bundleFirst_ + bundleSize_ <= maxGrowthTime_);
+    actinChanges_->emplace_back(VINT(pos), 1.0);
+    bundle_[bundleFirst_ + bundleSize_++] = pos;
 }
 
 void Pseudopod::setRetracting(RetractionMethod retractionMethod) {
@@ -89,7 +91,6 @@ void Pseudopod::setRetracting(RetractionMethod retractionMethod) {
 
 void Pseudopod::setRetractingIfStuck() {
     if (timeNoExtension_ > timeNoExtensionLimit_) {
-        cout << "long time without extension" << endl;
         setRetracting(RetractionMethod::FORWARD);
         //state_ = State::PULLING;
     }
@@ -107,7 +108,7 @@ void Pseudopod::growBundle() {
 
     auto extendDirection = RandomVonMisesPoint(polarisationDirection_, kappaCont_);
     auto orthoOffset = VDOUBLE::from_radial(extendDirection);
-    auto newBundlePosition = bundlePositions_.back() + orthoOffset;
+    auto newBundlePosition = bundle_[bundleFirst_ + bundleSize_ - 1] + orthoOffset;
 
     // get cell id of (possible) new bundle position
     auto newPosCellId = _cpm_layer->get(VINT(newBundlePosition)).cell_id;
@@ -131,7 +132,7 @@ void Pseudopod::growBundle() {
             	case TouchBehavior::POOF_DIRECTIONAL:
 				{
 					auto movingAngle = movingDirection_->get(SymbolFocus(cellId));
-					auto directionAngle = VDOUBLE(bundlePositions_.back() - bundlePositions_.front()).angle_xy();
+					auto directionAngle = VDOUBLE(bundle_[bundleFirst_ + bundleSize_ - 1] - bundle_[bundleFirst_]).angle_xy();
 					if(cos(directionAngle - movingAngle) < 0.85) {
 						deleteBundle();
 					} else {
@@ -154,18 +155,16 @@ void Pseudopod::growBundle() {
     }
 }
 
-void Pseudopod::decrementActinLevelAt(VINT pos) const {
-    auto prevFieldVal = field_->get(pos);
-    assert(prevFieldVal > 0);
-    field_->set(pos, prevFieldVal - 1);
+void Pseudopod::decrementActinLevelAt(VINT pos) {
+    actinChanges_->emplace_back(pos, -1.0);
 }
 
 void Pseudopod::deleteBundle() {
 
-	for(auto const &pos: bundlePositions_) {
-		decrementActinLevelAt(VINT(pos));
+	for(unsigned int i = bundleFirst_; i < bundleFirst_ + bundleSize_; ++i) {
+		decrementActinLevelAt(VINT(bundle_[i]));
 	}
-	bundlePositions_.clear();
+	bundleSize_ = 0;
 
 	// completely retracted, start over
 	state_ = State::INACTIVE;
@@ -179,27 +178,29 @@ void Pseudopod::retractBundle() {
 
     VINT pos;
     if(currRetractionMethod_ == RetractionMethod::BACKWARD) {
-        pos = VINT(bundlePositions_.back());
+        pos = VINT(bundle_[bundleFirst_ + bundleSize_ - 1]);
     } else if (currRetractionMethod_ == RetractionMethod::FORWARD) {
-        pos = VINT(bundlePositions_.front());
+        pos = VINT(bundle_[bundleFirst_]);
     }
 
     decrementActinLevelAt(pos);
 
     if(currRetractionMethod_ == RetractionMethod::BACKWARD) {
-        bundlePositions_.pop_back();
+        bundleSize_--;
     } else if (currRetractionMethod_ == RetractionMethod::FORWARD) {
-        bundlePositions_.erase(bundlePositions_.begin());
+        bundleFirst_++;
+        bundleSize_--;
     }
 
-    if (bundlePositions_.empty()) {
+    if (bundleSize_ == 0) {
         // completely retracted, start over
         state_ = State::INACTIVE;
     }
 }
 
-void Pseudopod::timeStep() {
+void Pseudopod::timeStep(ActinChanges &actinChanges) {
 //cout << "timeStep: " << magic(state_) << endl;
+    actinChanges_ = &actinChanges;
     switch (state_) {
         case State::INIT:
             startNewBundle();
@@ -233,9 +234,9 @@ VDOUBLE Pseudopod::getBundleTip() const {
         cerr << "Pseudopod::getBundleTip: pseudo in INIT or INACTIVE state, no bundle tip" << endl;
         throw MorpheusException("No bundle tip", "Pseudopod::getBundleTip");
     }
-    return bundlePositions_.back();
+    return bundle_[bundleFirst_ + bundleSize_ - 1];
 }
 
 bool Pseudopod::hasBundleTip() const {
-    return !bundlePositions_.empty();
+    return bundleSize_ > 0;
 }
@@ -29,9 +29,14 @@ public:
         NOTHING,
         POOF_DIRECTIONAL
     };
+    /// Actin field increments of a time step, applied after all pseudopods have been stepped
+    using ActinChanges = vector<pair<VINT, double>>;
 
 private:
-    vector<VDOUBLE> bundlePositions_;
+    // Bundle points are kept in a slot of pooled storage with room for maxGrowthTime + 1 points
+    VDOUBLE *bundle_;
+    unsigned int bundleFirst_;
+    unsigned int bundleSize_;
     unsigned int timeLeftForGrowth_;
     unsigned int maxGrowthTime_;
     unsigned int timeNoExtension_;
@@ -48,13 +53,13 @@ private:
     State state_;
     CPM::CELL_ID cellId;
     const CPM::LAYER *_cpm_layer;
-    PluginParameter2<double, XMLReadWriteSymbol, RequiredPolicy> *field_;
     PluginParameter2<double, XMLReadableSymbol, RequiredPolicy> *movingDirection_;
     TouchBehavior touchBehavior_;
+    ActinChanges *actinChanges_;
 
     void startNewBundle();
     void retractBundle();
-    void decrementActinLevelAt(VINT pos) const;
+    void decrementActinLevelAt(VINT pos);
     void setRetractingIfStuck();
     void growBundle();
     void setRetracting(RetractionMethod retractionMethod);
@@ -65,11 +70,12 @@ private:
 public:
     Pseudopod(unsigned int maxGrowthTime, const CPM::LAYER *cpm_layer, CPM::CELL_ID cellId,
               PluginParameter2<double, XMLReadableSymbol, RequiredPolicy> *movingDirection,
-              PluginParameter2<double, XMLReadWriteSymbol, RequiredPolicy> *field, RetractionMethod retractionMethod,
+              VDOUBLE *bundleStorage, RetractionMethod retractionMethod,
               double kappaInit, double kappaCont, TouchBehavior touchBehavior, unsigned int timeBetweenExtensions);
 
     State state() const;
-    void timeStep();
+    /// Advance the pseudopod, changes of the actin field are appended to @p actinChanges
+    void timeStep(ActinChanges &actinChanges);
     VDOUBLE getBundleTip() const;
     bool hasBundleTip() const;
 
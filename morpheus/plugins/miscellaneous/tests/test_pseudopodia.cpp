@@ -0,0 +1,65 @@
+#include "gtest/gtest.h"
+#include "model_test.h"
+#include "core/simulation.h"
+#include "core/time_scheduler.h"
+#include "core/celltype.h"
+
+namespace {
+
+struct CellState {
+	CPM::CELL_ID id;
+	uint volume;
+	VDOUBLE center;
+	double actin;
+};
+
+vector<CellState> cellStates() {
+	vector<CellState> states;
+	auto ct = CPM::findCellType("amoeba").lock();
+	if (!ct) return states;
+	auto actin = ct->getScope()->findSymbol<double>("actin");
+	for (auto id : ct->getCellIDs()) {
+		const auto& cell = CPM::getCell(id);
+		states.push_back({ id, cell.nNodes(), cell.getCenter(), actin->get(SymbolFocus(id)) });
+	}
+	return states;
+}
+
+}
+
+/// Results of the serial implementation of the Pseudopodia plugin, which a single thread has to reproduce
+TEST (Pseudopodia, SingleThreadRegression) {
+	const vector<CellState> expected = {
+		{ 1, 251, VDOUBLE(41.705179282868528, 19.179282868525895, 0), 13 },
+		{ 2, 249, VDOUBLE(88.136546184738961, 23.811244979919678, 0), 24 },
+		{ 3, 249, VDOUBLE(39, 48.168674698795179, 0), 16 },
+		{ 4, 251, VDOUBLE(83.366533864541836, 40.059760956175296, 0), 10 },
+		{ 5, 250, VDOUBLE(23.884, 90.132000000000005, 0), 11 },
+		{ 6, 250, VDOUBLE(87.775999999999996, 87.900000000000006, 0), 18 }
+	};
+	
+	auto file = ImportFile("pseudopodia.xml");
+	TestModel m(file.getDataAsString());
+#ifdef HAVE_OPENMP
+	int max_threads = omp_get_max_threads();
+	omp_set_num_threads(1);
+#endif
+	// A second run has to reproduce the first one
+	for (int run=0; run<2; run++) {
+		m.run();
+		auto states = cellStates();
+		ASSERT_EQ(states.size(), expected.size());
+		for (uint i=0; i<states.size(); i++) {
+			EXPECT_EQ(states[i].id, expected[i].id);
+			EXPECT_EQ(states[i].volume, expected[i].volume) << "Cell " << states[i].id;
+			EXPECT_NEAR(states[i].center.x, expected[i].center.x, 1e-9) << "Cell " << states[i].id;
+			EXPECT_NEAR(states[i].center.y, expected[i].center.y, 1e-9) << "Cell " << states[i].id;
+			EXPECT_EQ(states[i].actin, expected[i].actin) << "Cell " << states[i].id;
+		}
+		EXPECT_EQ(SIM::findGlobalSymbol<double>("actin_total")->get(SymbolFocus::global), 92);
+		TimeScheduler::finish();
+	}
+#ifdef HAVE_OPENMP
+	omp_set_num_threads(max_threads);
+#endif
+}
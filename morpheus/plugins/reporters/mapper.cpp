@@ -6,6 +6,9 @@ REGISTER_PLUGIN(Mapper);
 Mapper::Mapper() {
 	input->setXMLPath("Input/value");
 	this->registerPluginParameter(*input);
+	incremental.setXMLPath("Input/incremental");
+	incremental.setDefault("false");
+	this->registerPluginParameter(incremental);
 	
 	polarity_output->setXMLPath("Polarity/symbol-ref");
 	this->registerPluginParameter(polarity_output);
@@ -32,6 +35,14 @@ void Mapper::init(const Scope* scope)
 {
 	this->scope = scope;
 	TimeStepListener::init(scope);
+	if (incremental()) {
+		try {
+			incremental_field = dynamic_pointer_cast<const Field::Symbol>(scope->findSymbol<double>(input->stringVal()));
+		}
+		catch (const SymbolError&) {}
+		if (!incremental_field)
+			throw MorpheusException("Mapper: Incremental mapping requires a Field symbol as Input.", stored_node);
+	}
 	// Reporter output value depends on cell position
 	if (scope->getCellType())
 		registerCellPositionDependency();
@@ -63,6 +74,53 @@ void Mapper::report_output(const OutputSpec& output, const SymbolFocus& focus) {
 	}
 }
 
+template <class KeyFun, class KeyRangeFun, class WriteFun>
+void Mapper::reduce(DataMapper::Mode mode, const FocusRange& input_range, int n_keys, KeyFun key, KeyRangeFun key_range, WriteFun write)
+{
+	auto mapper = DataMapper::create(mode);
+	int n_threads = max(1, omp_get_max_threads());
+	long max_slots = mode == DataMapper::DISCRETE ? max_discrete_sweep_slots : max_sweep_slots;
+	if (long(n_keys) * n_threads > max_slots) {
+		// One statistic per thread, each key is reduced over its own input range
+		mapper->resize(n_threads);
+#pragma omp parallel
+		{
+			int thread = omp_get_thread_index();
+#pragma omp for schedule(dynamic,16)
+			for (int k=0; k<n_keys; k++) {
+				mapper->reset(thread);
+				for (const auto& focus : key_range(k)) {
+					mapper->addVal(input(focus), thread);
+				}
+				write(k, mapper->get(thread));
+			}
+		}
+		return;
+	}
+	
+	// Each thread accumulates into a block of its own
+	mapper->resize(n_keys * n_threads);
+#pragma omp parallel
+	{
+		int offset = omp_get_thread_index() * n_keys;
+#pragma omp for schedule(static)
+		for (auto focus=input_range.begin(); focus<input_range.end(); ++focus) {
+			int k = key(*focus);
+			if (k>=0)
+				mapper->addVal(input(*focus), offset + k);
+		}
+		// Pairwise merge of the thread blocks into the first block
+#pragma omp for schedule(static)
+		for (int k=0; k<n_keys; k++) {
+			for (int stride=1; stride<n_threads; stride*=2) {
+				for (int t=0; t+stride<n_threads; t+=2*stride)
+					mapper->merge(t*n_keys + k, (t+stride)*n_keys + k);
+			}
+			write(k, mapper->get(k));
+		}
+	}
+}
+
 void Mapper::report_output(const OutputSpec& output, const Scope* scope) {
 
 // 	
@@ -82,25 +140,51 @@ void Mapper::report_output(const OutputSpec& output, const Scope* scope) {
 			auto extends = range.spatialExtends();
 			auto input_extends = FocusRange(input->granularity(), scope).spatialExtends();
 			bool dimensions_lost = extends.size() < input_extends.size();
-			if (  output.symbol->granularity() ==  input->granularity() &&  dimensions_lost) {
-				auto mapper =  DataMapper::create(output.mapping());
-#pragma omp parallel
-				{
-					auto thread = omp_get_thread_num();
-#pragma omp for schedule(static)
-					for (auto focus=range.begin(); focus<range.end(); ++focus) {
-						multimap<FocusRangeAxis,int> restrictions;
-						for (auto e : extends) {
-							restrictions.insert(make_pair(e,focus->get(e)));
-						}
-						FocusRange inner_range(input->granularity(),restrictions);
-						mapper->reset(thread);
-						for (const auto& inner_focus : inner_range ){
-							mapper->addVal(input(inner_focus),thread);
-						}
-						output.symbol->set(*focus,mapper->get(thread));
+			if (  output.symbol->granularity() ==  input->granularity() &&  dimensions_lost && range.size()>0) {
+				// Index the output range by the values of the kept axes
+				vector<FocusRangeAxis> axes(extends.begin(), extends.end());
+				vector<int> lower(axes.size(), std::numeric_limits<int>::max()), upper(axes.size(), std::numeric_limits<int>::min());
+				for (const auto& focus : range) {
+					for (uint a=0; a<axes.size(); a++) {
+						int v = focus.get(axes[a]);
+						lower[a] = min(lower[a], v);
+						upper[a] = max(upper[a], v);
+					}
+				}
+				int n_index = 1;
+				for (uint a=0; a<axes.size(); a++)
+					n_index *= upper[a] - lower[a] + 1;
+				auto index = [&](const SymbolFocus& focus) {
+					int idx = 0;
+					for (uint a=0; a<axes.size(); a++) {
+						int v = focus.get(axes[a]);
+						if (v<lower[a] || v>upper[a]) return -1;
+						idx = idx * (upper[a] - lower[a] + 1) + v - lower[a];
 					}
+					return idx;
+				};
+				vector<int> keys(n_index, -1);
+				for (auto focus=range.begin(); focus<range.end(); ++focus) {
+					keys[index(*focus)] = focus - range.begin();
 				}
+				
+				reduce(output.mapping(), FocusRange(input->granularity(), scope), range.size(),
+					[&](const SymbolFocus& focus) {
+						int idx = index(focus);
+						return idx<0 ? -1 : keys[idx];
+					},
+					[&](int k) {
+						// All input nodes within the scope that share the kept coordinates of output node k
+						multimap<FocusRangeAxis,int> restrictions;
+						if (scope->getCellType())
+							restrictions.insert(make_pair(FocusRangeAxis::CellType, scope->getCellType()->getID()));
+						auto out_focus = range.begin() + k;
+						for (auto axis : axes)
+							restrictions.insert(make_pair(axis, out_focus->get(axis)));
+						return FocusRange(input->granularity(), restrictions);
+					},
+					[&](int k, double value) { output.symbol->set(*(range.begin() + k), value); }
+				);
 			}
 			else {
 				// Just write input to the output
@@ -142,37 +226,44 @@ void Mapper::report_output(const OutputSpec& output, const Scope* scope) {
 		}
 	}
 	else {
-		auto mapper =  DataMapper::create(output.mapping());
-		if (output.symbol->granularity() == Granularity::Cell) {
+		if (output.symbol->granularity() == Granularity::Cell && incremental_field
+			&& (output.mapping() == DataMapper::SUM || output.mapping() == DataMapper::AVERAGE)) {
+			auto& statistics = incremental_field->getField()->cellStatistics();
+			statistics.validate();
+			bool average = output.mapping() == DataMapper::AVERAGE;
 			FocusRange out_range(output.symbol->accessor(), scope);
-#pragma omp parallel
-			{
-				auto thread = omp_get_thread_num();
-#pragma omp for schedule(static)
-				for (auto out_focus=out_range.begin(); out_focus<out_range.end(); ++out_focus) {
-					// Optimization for single node cells
-					if (out_focus->cell().nNodes() ==1) {
-						SymbolFocus node_focus(*out_focus);
-						node_focus.setCell(node_focus.cellID(), *(node_focus.cell().getNodes().begin()));
-						output.symbol->set(*out_focus,input(node_focus));
-					}
-					else {
-						FocusRange input_range(input->granularity(),out_focus->cellID());
-						for (auto focus: input_range) {
-							mapper->addVal(input(focus),thread);
-						}
-						output.symbol->set(*out_focus,mapper->get(thread));
-						mapper->reset(thread);
-					}
-				}
+#pragma omp parallel for schedule(static)
+			for (auto out_focus=out_range.begin(); out_focus<out_range.end(); ++out_focus) {
+				auto id = out_focus->cellID();
+				output.symbol->set(*out_focus, average ? statistics.average(id) : statistics.sum(id));
 			}
 		}
-		else if (output.symbol->granularity() == Granularity::Global) {
-			FocusRange input_range(input->granularity(),scope);
-			for (auto focus: input_range) {
-				mapper->addVal(input(focus),0);
+		else if (output.symbol->granularity() == Granularity::Cell) {
+			FocusRange out_range(output.symbol->accessor(), scope);
+			// Index the output range by cell id
+			vector<int> keys;
+			for (auto out_focus=out_range.begin(); out_focus<out_range.end(); ++out_focus) {
+				auto id = out_focus->cellID();
+				if (id >= keys.size()) keys.resize(id+1, -1);
+				keys[id] = out_focus - out_range.begin();
 			}
-			output.symbol->set(SymbolFocus::global, mapper->get(0));
+			
+			reduce(output.mapping(), FocusRange(input->granularity(), scope), out_range.size(),
+				[&](const SymbolFocus& focus) {
+					auto id = focus.cellID();
+					return id < keys.size() ? keys[id] : -1;
+				},
+				[&](int k) { return FocusRange(input->granularity(), (out_range.begin() + k)->cellID()); },
+				[&](int k, double value) { output.symbol->set(*(out_range.begin() + k), value); }
+			);
+		}
+		else if (output.symbol->granularity() == Granularity::Global) {
+			FocusRange input_range(input->granularity(), scope);
+			reduce(output.mapping(), input_range, 1,
+				[](const SymbolFocus&) { return 0; },
+				[&](int) { return input_range; },
+				[&](int, double value) { output.symbol->set(SymbolFocus::global, value); }
+			);
 		}
 		else {
 			throw string("Missing mapping implementation");
@@ -25,6 +25,7 @@ A \b Mapper defines how data within a spatial context, e.g. a cell, a cell popul
 
 A single \b Input element must be specified:
 - \b value: input variable (e.g. \ref ML_Property, \ref ML_MembraneProperty or \ref ML_Field) or a respective expression.
+- \b incremental (optional): if true, per cell sums and averages of a \ref ML_Field input are taken from sums that are adjusted upon every change of a node's owner, instead of scanning all cell nodes at every report. Requires the input to be a plain Field symbol. Explicit diffusion on lattices without domain re-synchronizes the sums along with the diffusion step, other modifications of the field cause a scan of all cell nodes at the next report.
 
 That information can be written to an output symbol, if necessary, reduced in spatial granularity by means of the \b mapping statistics.
 If the output granularity is sufficient, i.e. when writing to a \ref ML_Field or \ref ML_MembraneProperty, no \b mapping function needs to be specified.
@@ -93,6 +94,7 @@ Compute the binding rate of a soluble substance (A) to a membrane bound molecule
 #include "core/focusrange.h"
 #include "core/data_mapper.h"
 #include "core/membranemapper.h"
+#include "core/field.h"
 
 class Mapper : public ReporterPlugin
 {
@@ -101,6 +103,9 @@ private:
 	const Scope* scope;
 	
 	PluginParameter_Shared<double, XMLThreadsaveEvaluator, RequiredPolicy> input;
+	PluginParameter2<bool, XMLValueReader, DefaultValPolicy> incremental;
+	/// Field input with incrementally tracked per cell sums
+	shared_ptr<const Field::Symbol> incremental_field;
 	
 	struct OutputSpec {
 		PluginParameter_Shared<DataMapper::Mode, XMLNamedValueReader, OptionalPolicy> mapping;
@@ -114,6 +119,18 @@ private:
 	
 	void report_polarity(const Scope* scope);
 	
+	/** Reduce the input over @p input_range into @p n_keys statistics and pass them to @p write(k, value).
+	 * 
+	 *  @p key maps an input focus to the index of its statistic, or -1 to skip it.
+	 *  As long as one statistic per key and thread is affordable, all keys are reduced in a single parallel sweep.
+	 *  Otherwise, the keys are reduced one after another over the input range @p key_range(k).
+	 */
+	template <class KeyFun, class KeyRangeFun, class WriteFun>
+	void reduce(DataMapper::Mode mode, const FocusRange& input_range, int n_keys, KeyFun key, KeyRangeFun key_range, WriteFun write);
+	/// Maximum number of per thread statistics used by reduce() for a single sweep
+	static const int max_sweep_slots = 1<<20;
+	static const int max_discrete_sweep_slots = 1<<10;
+	
 	PluginParameter_Shared<VDOUBLE, XMLWritableSymbol, OptionalPolicy> polarity_output;
 
 public:
@@ -140,7 +140,7 @@ void NeighborhoodReporter::reportGlobal() {
 	auto neighbors = SIM::lattice().getDefaultNeighborhood().neighbors();
 #pragma omp parallel
 	{
-		int thread = omp_get_thread_num();
+		int thread = omp_get_thread_index();
 #pragma omp for schedule(static)
 		for (auto i_node = range.begin(); i_node<range.end(); ++i_node) {
 			const auto& node = *i_node;
@@ -184,7 +184,7 @@ void NeighborhoodReporter::reportCelltype(CellType* celltype) {
 #pragma omp parallel
 		{
 			// There might also be boolean input, that we cannot easily handle this way. But works for concentrations and rates, i.e. all continuous quantities.
-			auto thread = omp_get_thread_num();
+			auto thread = omp_get_thread_index();
 			unique_ptr<MembraneMapper> mapper;
 			unique_ptr<MembraneMapper> discrete_mapper;
 			struct count_data { double val; double count; };
@@ -359,7 +359,7 @@ void NeighborhoodReporter::reportCelltype(CellType* celltype) {
 		ExceptionCatcher exception_catcher;
 #pragma omp parallel
 		{
-			int thread = omp_get_thread_num();
+			int thread = omp_get_thread_index();
 			for (auto const& out : interf_output) {
 				out->mapper->reset(thread);
 			}
@@ -108,8 +108,8 @@ void NeighborhoodVectorReporter::reportCelltype(CellType* celltype) {
 		}
 		
 		// loop through its neighbors
-		const map <CPM::CELL_ID, double >& interfaces = cell_focus.cell().getInterfaceLengths();
-		for (map<CPM::CELL_ID,double>::const_iterator nb = interfaces.begin(); nb != interfaces.end(); nb++) {
+		const auto& interfaces = cell_focus.cell().getInterfaceLengths();
+		for (auto nb = interfaces.begin(); nb != interfaces.end(); nb++) {
 
 			CPM::CELL_ID nei_cell_id = nb->first;
 			SymbolFocus neighbor(nei_cell_id);
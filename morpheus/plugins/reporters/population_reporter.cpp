@@ -175,8 +175,8 @@ void PopulationReporter::computeTimeStep(){
 				double mindist = 9999.9;
 				
 				// get nearest neighbor
-				const map <CPM::CELL_ID, double >& interfaces = cellfocus.cell().getInterfaceLengths();
-				for (map<CPM::CELL_ID,double>::const_iterator nb = interfaces.begin(); nb != interfaces.end(); nb++) {
+				const auto& interfaces = cellfocus.cell().getInterfaceLengths();
+				for (auto nb = interfaces.begin(); nb != interfaces.end(); nb++) {
 					CPM::CELL_ID cell_id = nb->first;
 					if ( cell_id == CPM::getEmptyState().cell_id )
 						continue;
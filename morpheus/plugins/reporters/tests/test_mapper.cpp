@@ -0,0 +1,116 @@
+#include "gtest/gtest.h"
+#include "model_test.h"
+#include "core/simulation.h"
+#include "core/time_scheduler.h"
+#include "core/celltype.h"
+#include "core/data_mapper.h"
+#include <functional>
+
+namespace {
+
+double cellValue(const Scope* scope, const string& symbol, CPM::CELL_ID id) {
+	return scope->findSymbol<double>(symbol)->get(SymbolFocus(id));
+}
+
+/// Compare the incremental Mapper outputs for @p field to the ones from scanning the cell nodes
+void expectIncrementalMatches(const string& field) {
+	auto ct = CPM::findCellType("ct").lock();
+	ASSERT_TRUE(ct);
+	ASSERT_FALSE(ct->getCellIDs().empty());
+	auto scope = ct->getScope();
+	for (auto id : ct->getCellIDs()) {
+		double sum = cellValue(scope, field + "_sum", id);
+		EXPECT_NE(sum, 0) << "Cell " << id;
+		EXPECT_NEAR(cellValue(scope, field + "_inc_sum", id), sum, 1e-10 * max(1.0, fabs(sum))) << "Cell " << id;
+		double avg = cellValue(scope, field + "_avg", id);
+		EXPECT_NEAR(cellValue(scope, field + "_inc_avg", id), avg, 1e-12 * max(1.0, fabs(avg))) << "Cell " << id;
+	}
+}
+
+/// Shared by the incremental tests, InjectModels() adds a ressource per ImportFile() call
+string incrementalModel() {
+	auto file = ImportFile("mapper_incremental.xml");
+	return file.getDataAsString();
+}
+
+}
+
+TEST (Mapper, IncrementalFieldWrittenBySymbol) {
+	TestModel m(incrementalModel());
+	m.run();
+	expectIncrementalMatches("u");
+	TimeScheduler::finish();
+}
+
+TEST (Mapper, IncrementalDiffusingField) {
+	TestModel m(incrementalModel());
+	m.run();
+	expectIncrementalMatches("w");
+	TimeScheduler::finish();
+}
+
+namespace {
+
+/// Statistic of @p value over the nodes of @p cells, computed serially
+double reference(DataMapper::Mode mode, const vector<CPM::CELL_ID>& cells, std::function<double(const VINT&)> value) {
+	auto mapper = DataMapper::create(mode);
+	mapper->resize(1);
+	for (auto id : cells) {
+		for (const auto& node : CPM::getCell(id).getNodes())
+			mapper->addVal(value(node), 0);
+	}
+	return mapper->get(0);
+}
+
+void checkCellStatistics() {
+	auto ct = CPM::findCellType("ct").lock();
+	ASSERT_TRUE(ct);
+	auto scope = ct->getScope();
+	auto u = SIM::findGlobalSymbol<double>("u");
+	auto u_value = [&](const VINT& node) { return u->get(SymbolFocus(node)); };
+	auto u_class = [&](const VINT& node) { return floor(3 * u->get(SymbolFocus(node))); };
+	
+	auto cells = ct->getCellIDs();
+	int single_node_cells = 0;
+	for (auto id : cells) {
+		vector<CPM::CELL_ID> cell = { id };
+		if (CPM::getCell(id).nNodes() == 1) {
+			single_node_cells++;
+			EXPECT_EQ(cellValue(scope, "u_variance", id), 0) << "Cell " << id;
+		}
+		EXPECT_NEAR(cellValue(scope, "u_average", id), reference(DataMapper::AVERAGE, cell, u_value), 1e-12) << "Cell " << id;
+		EXPECT_NEAR(cellValue(scope, "u_sum", id), reference(DataMapper::SUM, cell, u_value), 1e-11) << "Cell " << id;
+		EXPECT_NEAR(cellValue(scope, "u_variance", id), reference(DataMapper::VARIANCE, cell, u_value), 1e-11) << "Cell " << id;
+		EXPECT_EQ(cellValue(scope, "u_minimum", id), reference(DataMapper::MINIMUM, cell, u_value)) << "Cell " << id;
+		EXPECT_EQ(cellValue(scope, "u_maximum", id), reference(DataMapper::MAXIMUM, cell, u_value)) << "Cell " << id;
+		EXPECT_EQ(cellValue(scope, "u_discrete", id), reference(DataMapper::DISCRETE, cell, u_class)) << "Cell " << id;
+	}
+	EXPECT_EQ(single_node_cells, 30);
+	EXPECT_EQ(cells.size(), 36);
+	
+	// Global outputs of a cell type Mapper only cover the nodes of the cell type
+	EXPECT_NEAR(SIM::findGlobalSymbol<double>("u_ct_sum")->get(SymbolFocus::global), reference(DataMapper::SUM, cells, u_value), 1e-10);
+	EXPECT_EQ(SIM::findGlobalSymbol<double>("u_ct_discrete")->get(SymbolFocus::global), reference(DataMapper::DISCRETE, cells, u_class));
+}
+
+}
+
+TEST (Mapper, CellStatistics) {
+	auto file = ImportFile("mapper_cells.xml");
+	TestModel m(file.getDataAsString());
+#ifdef HAVE_OPENMP
+	int max_threads = omp_get_max_threads();
+	// Many threads make the discrete mapping reduce the cells one by one
+	for (int threads : {1, 64}) {
+		omp_set_num_threads(threads);
+		m.run();
+		checkCellStatistics();
+		TimeScheduler::finish();
+	}
+	omp_set_num_threads(max_threads);
+#else
+	m.run();
+	checkCellStatistics();
+	TimeScheduler::finish();
+#endif
+}
@@ -80,7 +80,7 @@ void VectorMapper::report_output(const OutputSpec& output, const Scope* scope) {
 				auto mapper =  VectorDataMapper::create(output.mapping());
 #pragma omp parallel
 				{
-					auto thread = omp_get_thread_num();
+					auto thread = omp_get_thread_index();
 #pragma omp for schedule(static)
 					for (auto focus=range.begin(); focus<range.end(); ++focus) {
 						multimap<FocusRangeAxis,int> restrictions;
@@ -112,7 +112,7 @@ void VectorMapper::report_output(const OutputSpec& output, const Scope* scope) {
 			FocusRange out_range(output.symbol->accessor(), scope);
 #pragma omp parallel
 			{
-				auto thread = omp_get_thread_num();
+				auto thread = omp_get_thread_index();
 #pragma omp for schedule(static)
 				for (auto out_focus=out_range.begin(); out_focus<out_range.end(); ++out_focus) {
 					// Optimization for single node cells
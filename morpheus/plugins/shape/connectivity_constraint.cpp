@@ -10,21 +10,19 @@ void ConnectivityConstraint::init(const Scope* scope) {
 	Cell_Update_Checker::init(scope);
 	const Lattice& lattice = SIM::lattice();
 	neighbors = CPM::getSurfaceNeighborhood().neighbors();
-	max_first_order = 0;
+	n_neighbors = neighbors.size();
 	// TODO Check the neighborhood to be exactly what we need
 	//CPM::getBoundaryNeighborhood();
 	
 	//cout << "ConnectivityConstraint: init(): " << neighbors.size() << " neighbors" << endl;
 	
-	dimensions = lattice.getDimensions();
-	if ( dimensions == 2) {
-		for (int i=0; i<neighbors.size(); i++) {
-			double distance = lattice.to_orth(neighbors[i]).abs();
-			double angle =  lattice.to_orth(neighbors[i]).angle_xy();
-			is_first_order.push_back( distance < 1.01);
-			max_first_order += distance < 1.01;
-			cout << "ConnectivityConstraint: " << neighbors[i] << " a " << angle << " d" << distance << endl;
-		}
+	if (n_neighbors > 64) {
+		throw MorpheusException("ConnectivityConstraint is only available for surface neighborhoods of up to 64 neighbors.", stored_node);
+	}
+	
+	topology = ConnectivityTopology(lattice, neighbors);
+	
+	if ( lattice.getDimensions() == 2) {
 		if ( lattice.getStructure() == Lattice::hexagonal ) {
 			neighbors = lattice.getNeighborhoodByOrder(1).neighbors();
 			if (neighbors.size() > 12) {
@@ -39,95 +37,102 @@ void ConnectivityConstraint::init(const Scope* scope) {
 			}
 		}
 	}
+};
+
+ConnectivityTopology::ConnectivityTopology(const Lattice& lattice, const vector<VINT>& neighbors)
+{
+	n_neighbors = neighbors.size();
+	max_first_order = 0;
+	first_order_mask = 0;
+	dimensions = lattice.getDimensions();
+	if ( dimensions == 2) {
+		for (int i=0; i<neighbors.size(); i++) {
+			double distance = lattice.to_orth(neighbors[i]).abs();
+			double angle =  lattice.to_orth(neighbors[i]).angle_xy();
+			if (distance < 1.01) first_order_mask |= uint64_t(1) << i;
+			max_first_order += distance < 1.01;
+			cout << "ConnectivityConstraint: " << neighbors[i] << " a " << angle << " d" << distance << endl;
+		}
+	}
 	else if (dimensions == 3) {
 		for (int i=0; i<neighbors.size(); i++) {
-			vector<int> neis;
+			uint64_t neis = 0;
 			for (int j=0; j<neighbors.size(); j++) {
 				if (i==j) continue;
 				if ( (neighbors[i]-neighbors[j]).abs() < 1.01 )
-					neis.push_back(j);
+					neis |= uint64_t(1) << j;
 			}
-			neighbor_neighbors.push_back(neis);
-			is_first_order.push_back(neighbors[i].abs() < 1.01);
+			neighbor_masks.push_back(neis);
+			if (neighbors[i].abs() < 1.01) first_order_mask |= uint64_t(1) << i;
 			max_first_order += neighbors[i].abs() < 1.01;
 		}
 	}
 	cout << "ConnectivityConstraint: Found " << max_first_order << " first order neighbors" << endl;
-};
+	
+	if (n_neighbors <= max_lut_neighbors) {
+		lut.resize(size_t(1) << n_neighbors);
+		for (uint64_t occupied=0; occupied<lut.size(); occupied++) {
+			lut[occupied] = check(occupied);
+		}
+	}
+}
 
-bool ConnectivityConstraint:: update_check( CPM::CELL_ID cell_id , const CPM::Update& update)
+uint8_t ConnectivityTopology::check(uint64_t occupied) const
 {
-	const vector<CPM::CELL_ID>& neighbors = update.surfaceStencil()->getStates();
+	int n_identicals = __builtin_popcountll(occupied);
+	int n_1st_order = __builtin_popcountll(occupied & first_order_mask);
+	uint8_t allowed = 0;
 	
 	if (dimensions == 3) {
-		int n_identicals = 0;
-		int n_1st_order = 0;
-		for (int i=0; i<neighbors.size(); i++) {
-			n_identicals += ( neighbors[i] == cell_id );
-			n_1st_order += is_first_order[i] && (neighbors[i] == cell_id) ;
-		}
-		int n_1st_section = 0;
-		if (n_identicals>1) {
-			vector<CPM::CELL_ID> nei_copy = neighbors;
-			vector<int> neighbor_ids;
-			for (int i=0; i<neighbors.size(); i++) {
-				// find a first node for the first section
-				if (neighbors[i] == cell_id) {
-					// accumulate all nodes in this sections
-					neighbor_ids.push_back(i);
-					
-					while (! neighbor_ids.empty()) {
-						int i_nei = neighbor_ids.back();
-						neighbor_ids.pop_back();
-						n_1st_section++;
-						nei_copy[i_nei]=-1;
-						for (int k=0; k<neighbor_neighbors[i_nei].size(); k++) {
-							if (nei_copy[neighbor_neighbors[i_nei][k]] == cell_id)
-								neighbor_ids.push_back(neighbor_neighbors[i_nei][k]);
-						}
-					}
-					break;
-				}
-			}
-		}
-		else {
-			n_1st_section = n_identicals; 
+		// grow the section of the first occupied neighbor along adjacent occupied neighbors
+		uint64_t section = occupied & (~occupied + 1);
+		uint64_t front = section;
+		while (front) {
+			uint64_t added = neighbor_masks[__builtin_ctzll(front)] & occupied & ~section;
+			front &= front - 1;
+			section |= added;
+			front |= added;
 		}
+		int n_1st_section = __builtin_popcountll(section);
 		
-		if ( update.opRemove() && ( n_1st_section < n_identicals || n_1st_order == max_first_order ) ) {
-// 			cout << "prevented update::remove " << SIM::getTime() << (n_1st_section < n_identicals ? " multiple sections " : "") << ( (n_1st_order == max_first_order) ? " all 1st order occ." : "") << endl;
-			return false;
-		}
-		else if ( update.opAdd() && ( n_1st_section < n_identicals || n_1st_order == 0 )) {
-// 			cout << "prevented update::add " << SIM::getTime() << (n_1st_section < n_identicals ? " multiple sections " : "") << ( (n_1st_order == 0) ? " all 1st order empty.": "") << endl;
-			return false;
-		}
-		return true;
+		if ( ! ( n_1st_section < n_identicals || n_1st_order == max_first_order ) )
+			allowed |= RemoveAllowed;
+		if ( ! ( n_1st_section < n_identicals || n_1st_order == 0 ) )
+			allowed |= AddAllowed;
 	}
 	else if (dimensions == 2) {
-		// Prohibiting node removals that might break cell connectivity
-		int n_sections = 0; // number of sections remaining after the update
-		int n_1st_order = 0; // number of 1st order neighbors occupied by other spins,
-		CPM::CELL_ID last_neigbor = neighbors.back();
+		// number of sections, i.e. occupied neighbors followed by a foreign one in cyclic order
+		uint64_t all = n_neighbors == 64 ? ~uint64_t(0) : (uint64_t(1) << n_neighbors) - 1;
+		uint64_t predecessors = ((occupied << 1) | (occupied >> (n_neighbors-1))) & all;
+		int n_sections = __builtin_popcountll(predecessors & ~occupied & all);
 		
-		for (int i=0; i<neighbors.size(); i++) {
-			n_sections += ( neighbors[i] != cell_id && last_neigbor == cell_id );
-			n_1st_order += is_first_order[i] && (neighbors[i] == cell_id) ;
-			last_neigbor = neighbors[i];
-		}
+		// prevent disconnecting chains and prevent hole formation
+		if ( ! ( n_sections > 1 || n_1st_order == max_first_order ) )
+			allowed |= RemoveAllowed;
+		// prevent purely diagonal connections and connecting branches
+		if ( ! ( n_1st_order == 0 || n_sections > 1 ) )
+			allowed |= AddAllowed;
+	}
+	else
+		allowed = RemoveAllowed | AddAllowed;
+	return allowed;
+}
 
-		if ( update.opRemove() ) {
-			// prevent disconnecting chains and prevent hole formation
-			if (n_sections > 1 || n_1st_order == max_first_order) return false;
-		}
-		
-		// Prohibiting extension to a node, where a cell has no 1st order neighbor or connects individual branches
-		if ( update.opAdd() ) {
-			// prevent purely diagonal connections and connecting branches
-			if (n_1st_order == 0 || n_sections > 1) return false;
-		}
-		return true;
+bool ConnectivityConstraint:: update_check( CPM::CELL_ID cell_id , const CPM::Update& update)
+{
+	const vector<CPM::CELL_ID>& neighbors = update.surfaceStencil()->getStates();
+	
+	uint64_t occupied = 0;
+	for (int i=0; i<n_neighbors; i++) {
+		occupied |= uint64_t( neighbors[i] == cell_id ) << i;
+	}
+	uint8_t allowed = topology.allowed(occupied);
+	
+	if ( update.opRemove() && ! (allowed & ConnectivityTopology::RemoveAllowed) ) {
+		return false;
+	}
+	else if ( update.opAdd() && ! (allowed & ConnectivityTopology::AddAllowed) ) {
+		return false;
 	}
-	else 
-		return true;
+	return true;
 };
@@ -26,7 +26,8 @@
 Prevents updates that disrupt connectivity of cell domains. I.e. ensures that cells remain connected components.
 
 \section Note
-Currently the algorithm exclusively works in 2D lattices.
+The occupancy of the surface neighborhood is encoded as a bitmask. The topology checks are looked up in a precomputed table for
+surface neighborhoods of up to 16 nodes, and otherwise evaluated using bit operations.
 
 \section References
 -  Merks, Roeland MH, Sergey V. Brodsky, Michael S. Goligorksy, Stuart A. Newman, and James A. Glazier. "Cell elongation is key to in silico replication of in vitro vasculogenesis and subsequent remodeling." Developmental biology 289, no. 1 (2006): 44-54.
@@ -38,14 +39,40 @@ Currently the algorithm exclusively works in 2D lattices.
 \endverbatim
 */
 
-class ConnectivityConstraint : public Cell_Update_Checker
+/// Topology checks on the occupancy of a surface neighborhood, encoded as a bitmask
+class ConnectivityTopology
 {
+public:
+	enum TopologyCheck { RemoveAllowed = 1, AddAllowed = 2 };
+	static const int max_lut_neighbors = 16;
+	
+	ConnectivityTopology() : n_neighbors(0), first_order_mask(0), max_first_order(0), dimensions(0) {};
+	/// Set up the checks for the surface @p neighbors of @p lattice
+	ConnectivityTopology(const Lattice& lattice, const vector<VINT>& neighbors);
+	/// Which updates preserve connectivity if the surface neighbors in @p occupied belong to the cell
+	uint8_t allowed(uint64_t occupied) const { return lut.empty() ? check(occupied) : lut[occupied]; }
+	/// Evaluate allowed() using bit operations
+	uint8_t check(uint64_t occupied) const;
+	/// Whether the checks are looked up in a precomputed table
+	bool hasLUT() const { return ! lut.empty(); }
+	
 private:
-	vector<VINT> neighbors;
-	vector<bool> is_first_order;
-	vector< vector<int> > neighbor_neighbors;
+	int n_neighbors;
+	uint64_t first_order_mask;
+	/// Adjacent surface neighbors of each surface neighbor (3D)
+	vector<uint64_t> neighbor_masks;
 	int max_first_order;
 	int dimensions;
+	/// Check results for all occupancy masks, if the surface neighborhood is small enough
+	vector<uint8_t> lut;
+};
+
+class ConnectivityConstraint : public Cell_Update_Checker
+{
+private:
+	vector<VINT> neighbors;
+	int n_neighbors;
+	ConnectivityTopology topology;
 
 public:
 	ConnectivityConstraint();
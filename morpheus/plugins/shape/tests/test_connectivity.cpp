@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include "core/lattice.h"
+#include "plugins/shape/connectivity_constraint.h"
+#include <random>
+
+namespace {
+
+shared_ptr<Lattice> createLattice(Lattice::Structure structure) {
+	LatticeDesc desc;
+	desc.structure = structure;
+	if (structure == Lattice::cubic) {
+		desc.size = VINT(20, 20, 20);
+		desc.boundaries[Boundary::mz] = Boundary::periodic;
+	}
+	else
+		desc.size = VINT(20, 20, 1);
+	desc.boundaries[Boundary::mx] = Boundary::periodic;
+	desc.boundaries[Boundary::my] = Boundary::periodic;
+	return Lattice::createLattice(desc);
+}
+
+/** Reference checks, flood filling the occupied neighbors
+ * 
+ *  In 2D, neighbors are adjacent in their angular order, in 3D if their distance is 1.
+ */
+uint8_t floodFillCheck(const Lattice& lattice, const vector<VINT>& neighbors, uint64_t occupied) {
+	const int n = neighbors.size();
+	auto is_occupied = [&](int i) { return (occupied >> i) & 1; };
+	auto first_order = [&](int i) { return lattice.to_orth(neighbors[i]).abs() < 1.01; };
+	auto adjacent = [&](int i, int j) {
+		if (lattice.getDimensions() == 2)
+			return (i + 1) % n == j || (j + 1) % n == i;
+		return (neighbors[i] - neighbors[j]).abs() < 1.01;
+	};
+	
+	int n_occupied = 0, n_1st_order = 0, max_first_order = 0;
+	for (int i=0; i<n; i++) {
+		n_occupied += is_occupied(i);
+		n_1st_order += is_occupied(i) && first_order(i);
+		max_first_order += first_order(i);
+	}
+	
+	// Count the sections of occupied neighbors and the size of the first one
+	vector<bool> visited(n, false);
+	int n_sections = 0, n_1st_section = 0;
+	for (int start=0; start<n; start++) {
+		if (!is_occupied(start) || visited[start]) continue;
+		n_sections++;
+		int section_size = 0;
+		vector<int> stack = { start };
+		visited[start] = true;
+		while (!stack.empty()) {
+			int i = stack.back();
+			stack.pop_back();
+			section_size++;
+			for (int j=0; j<n; j++) {
+				if (is_occupied(j) && !visited[j] && adjacent(i, j)) {
+					visited[j] = true;
+					stack.push_back(j);
+				}
+			}
+		}
+		if (n_sections == 1) n_1st_section = section_size;
+	}
+	
+	uint8_t allowed = 0;
+	if (lattice.getDimensions() == 3) {
+		if ( ! ( n_1st_section < n_occupied || n_1st_order == max_first_order ) )
+			allowed |= ConnectivityTopology::RemoveAllowed;
+		if ( ! ( n_1st_section < n_occupied || n_1st_order == 0 ) )
+			allowed |= ConnectivityTopology::AddAllowed;
+	}
+	else {
+		if ( ! ( n_sections > 1 || n_1st_order == max_first_order ) )
+			allowed |= ConnectivityTopology::RemoveAllowed;
+		if ( ! ( n_1st_order == 0 || n_sections > 1 ) )
+			allowed |= ConnectivityTopology::AddAllowed;
+	}
+	return allowed;
+}
+
+void checkAllMasks(Lattice::Structure structure, int order) {
+	auto lattice = createLattice(structure);
+	auto neighbors = lattice->getNeighborhoodByOrder(order).neighbors();
+	ConnectivityTopology topology(*lattice, neighbors);
+	ASSERT_TRUE(topology.hasLUT());
+	for (uint64_t occupied=0; occupied < (uint64_t(1) << neighbors.size()); occupied++) {
+		uint8_t expected = floodFillCheck(*lattice, neighbors, occupied);
+		ASSERT_EQ(topology.allowed(occupied), expected) << "Order " << order << ", mask " << occupied;
+		ASSERT_EQ(topology.check(occupied), expected) << "Order " << order << ", mask " << occupied;
+	}
+}
+
+}
+
+TEST (ConnectivityTopology, SquareAllMasks) {
+	checkAllMasks(Lattice::square, 1);
+	checkAllMasks(Lattice::square, 2);
+}
+
+TEST (ConnectivityTopology, HexagonalAllMasks) {
+	checkAllMasks(Lattice::hexagonal, 1);
+	checkAllMasks(Lattice::hexagonal, 2);
+}
+
+TEST (ConnectivityTopology, CubicAllMasks) {
+	checkAllMasks(Lattice::cubic, 1);
+}
+
+TEST (ConnectivityTopology, CubicSampledMasks) {
+	auto lattice = createLattice(Lattice::cubic);
+	std::mt19937_64 engine(42);
+	for (int order : {2, 3}) {
+		auto neighbors = lattice->getNeighborhoodByOrder(order).neighbors();
+		ConnectivityTopology topology(*lattice, neighbors);
+		EXPECT_FALSE(topology.hasLUT());
+		// Sample sparse to dense occupancies
+		for (double density : {0.1, 0.3, 0.5, 0.7, 0.9}) {
+			std::bernoulli_distribution is_occupied(density);
+			for (int sample=0; sample<20000; sample++) {
+				uint64_t occupied = 0;
+				for (uint i=0; i<neighbors.size(); i++)
+					occupied |= uint64_t(is_occupied(engine)) << i;
+				ASSERT_EQ(topology.allowed(occupied), floodFillCheck(*lattice, neighbors, occupied)) << "Order " << order << ", mask " << occupied;
+			}
+		}
+	}
+}